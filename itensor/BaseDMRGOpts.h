@@ -11,6 +11,15 @@ public:
     virtual bool quiet() const = 0;
     virtual void quiet(bool val) = 0;
 
+    virtual bool precondition() const = 0;
+    virtual void precondition(bool val) = 0;
+
+    virtual int termThreads() const = 0;
+    virtual void termThreads(int val) = 0;
+
+    //Called after each bond with the number of Davidson iterations
+    virtual void addDavidsonIters(int sw, int niter) = 0;
+
     virtual void measure(int sw, int ha, int b, const SVDWorker& svd, Real energy) = 0;
     
     virtual bool checkDone(int sw, Real energy) = 0;
@@ -18,6 +18,19 @@ public:
     
     bool printEigs() const { return printeigs; }
     void printEigs(bool val) { printeigs = val; }
+
+    bool precondition() const { return precondition_; }
+    void precondition(bool val) { precondition_ = val; }
+
+    //Number of concurrent accumulators (threads, with OpenMP) for the 
+    //terms of an MPOSet Hamiltonian; 1 evaluates them serially
+    int termThreads() const { return term_threads; }
+    void termThreads(int val) { term_threads = val; }
+
+    //Total Davidson iterations (matrix-vector products) in sweep sw
+    int davidsonIters(int sw) const 
+        { return (sw < int(davidson_iters.size()) ? davidson_iters[sw] : 0); }
+    void addDavidsonIters(int sw, int niter);
     
     DMRGOpts();
 
@@ -34,6 +47,9 @@ private:
     Real orth_weight;    //How much to penalize non-orthogonality in multiple-state DMRG
     bool printeigs;      //Print slowest decaying eigenvalues after every sweep
     bool quiet_;         //Show/don't show info after every step
+    bool precondition_;  //Precondition Davidson with the diagonal of the local Hamiltonian
+    int term_threads;    //Accumulators for the terms of an MPOSet Hamiltonian
+    std::vector<int> davidson_iters; //Davidson iterations per sweep
 
 }; // class DMRGOpts
 
@@ -42,9 +58,19 @@ DMRGOpts()
     : energy_errgoal(-1), 
       orth_weight(1),
       printeigs(true), 
-      quiet_(true)
+      quiet_(true),
+      precondition_(false),
+      term_threads(1)
     { }
 
+inline
+void DMRGOpts::
+addDavidsonIters(int sw, int niter)
+    {
+    if(sw >= int(davidson_iters.size())) davidson_iters.resize(sw+1,0);
+    davidson_iters[sw] += niter;
+    }
+
 inline
 void DMRGOpts::
 measure(int sw, int ha, int b, const SVDWorker& svd, Real energy)
@@ -62,6 +88,7 @@ measure(int sw, int ha, int b, const SVDWorker& svd, Real energy)
                 std::cout << boost::format(center_eigs(j) > 1E-2 ? ("%.2f") : ("%.2E")) % center_eigs(j);
                 std::cout << ((j != min(center_eigs.Length(),10)) ? ", " : "\n");
                 }
+            std::cout << boost::format("    Davidson iterations during sweep %d: %d\n") % sw % davidsonIters(sw);
             std::cout << boost::format("    Energy after sweep %d is %f\n") % sw % energy;
             }
         }
@@ -104,9 +104,12 @@ runInternal(const MPOType& H, MPSType& psi)
                     % sw % ha % b % (b+1);
                 }
             
+            int niter = 0;
             energy_ = psi.bondDavidson(b,H.bondTensor(b),PH[b],PH[b+1],
                                        sweeps().niter(sw),debuglevel,
-                                       (ha==1?Fromleft:Fromright));
+                                       (ha==1?Fromleft:Fromright),1E-4,
+                                       opts(),niter);
+            opts().addDavidsonIters(sw,niter);
             
             if(!opts().quiet()) 
                 { 
@@ -1,6 +1,8 @@
 #ifndef __ITENSOR_ALLOCATOR_H
 #define __ITENSOR_ALLOCATOR_H
 
+#include <sched.h>
+
 template <class T>
 class DatAllocator
 {
@@ -10,7 +12,15 @@ private:
     void* pf_[stackSize];
     size_t nf_;
 
-    DatAllocator() : nf_(0) { }
+    //Spin lock so that objects may be created and
+    //destroyed by several threads at once; yields
+    //rather than spinning if the holder was preempted
+    volatile int lock_;
+
+    void lock() { while(__sync_lock_test_and_set(&lock_,1)) sched_yield(); }
+    void unlock() { __sync_lock_release(&lock_); }
+
+    DatAllocator() : nf_(0), lock_(0) { }
     ~DatAllocator()
     {
         for(size_t j = 0; j < nf_; ++j)
@@ -19,7 +29,9 @@ private:
 
     void* alloc()
     {
-        if(nf_ != 0) { return pf_[--nf_]; }
+        lock();
+        if(nf_ != 0) { void* p = pf_[--nf_]; unlock(); return p; }
+        unlock();
         void* p = malloc(allocSize);
         if(p == 0) throw std::bad_alloc();
         return p;
@@ -27,8 +39,10 @@ private:
 
     void dealloc(void* p) throw()
     {
-        if(nf_ == stackSize) free(p);
-        else pf_[nf_++] = p;
+        lock();
+        if(nf_ == stackSize) { unlock(); free(p); return; }
+        pf_[nf_++] = p;
+        unlock();
     }
 
     friend class IndexDat;
@@ -0,0 +1,303 @@
+#ifndef __ITENSOR_CONTRACT_H
+#define __ITENSOR_CONTRACT_H
+#include "iqtensor.h"
+
+//
+// Contraction of a network of tensors in the cheapest order.
+//
+// A product like A*B*C*D is evaluated left to right, and
+// a poor association can cost an extra factor of a bond or
+// site dimension. A TensorNetwork collects the operands
+// first, then finds the pairwise order with the least total
+// cost, the cost of each pairwise product being the product
+// of the dimensions of all indices of both factors.
+// The search is exhaustive (over subsets) for up to
+// max_exact operands and greedy beyond.
+//
+// As with operator*, indices shared by two operands are
+// contracted. Works for ITensor and IQTensor alike:
+//
+//   ITensor R = contract(L,phi.AA(i),H.AA(i),conj(primed(psi.AA(i))));
+//
+// The operands are copied, which shares their storage, so
+// a temporary like net.add(A*B) is safe to add.
+//
+
+template <class Tensor>
+class TensorNetwork
+    {
+public:
+
+    typedef typename Tensor::IndexT IndexT;
+
+    static const int max_exact = 8;
+
+    TensorNetwork() : planned_(false) { }
+
+    TensorNetwork&
+    add(const Tensor& T)
+        { t_.push_back(T); planned_ = false; return *this; }
+
+    int
+    size() const { return t_.size(); }
+
+    //Estimated cost of the contraction order found
+    Real
+    cost() const { plan(); return cost_; }
+
+    Tensor
+    result() const;
+
+    operator Tensor() const { return result(); }
+
+private:
+
+    //Operands are 0..n-1, the intermediate made by step s is n+s
+    struct Step { int a, b; };
+
+    std::vector<Tensor> t_;
+    mutable bool planned_;
+    mutable std::vector<Step> steps_;
+    mutable Real cost_;
+
+    void
+    plan() const;
+
+    void
+    planExact(const std::vector<std::vector<int> >& ind,
+              const std::vector<Real>& dim) const;
+
+    void
+    planGreedy(const std::vector<std::vector<int> >& ind,
+               const std::vector<Real>& dim) const;
+
+    };
+
+template <class Tensor>
+Tensor
+contract(const Tensor& A, const Tensor& B, const Tensor& C)
+    {
+    TensorNetwork<Tensor> net;
+    net.add(A).add(B).add(C);
+    return net.result();
+    }
+
+template <class Tensor>
+Tensor
+contract(const Tensor& A, const Tensor& B, const Tensor& C, const Tensor& D)
+    {
+    TensorNetwork<Tensor> net;
+    net.add(A).add(B).add(C).add(D);
+    return net.result();
+    }
+
+template <class Tensor>
+Tensor
+contract(const Tensor& A, const Tensor& B, const Tensor& C, const Tensor& D,
+         const Tensor& E)
+    {
+    TensorNetwork<Tensor> net;
+    net.add(A).add(B).add(C).add(D).add(E);
+    return net.result();
+    }
+
+template <class Tensor>
+Tensor
+contract(const std::vector<Tensor>& T)
+    {
+    TensorNetwork<Tensor> net;
+    for(size_t n = 0; n < T.size(); ++n) net.add(T[n]);
+    return net.result();
+    }
+
+namespace Internal {
+
+//Indices (as sorted ids) appearing exactly once in a and b together
+inline void
+openIndices(const std::vector<int>& a, const std::vector<int>& b,
+            std::vector<int>& res)
+    {
+    res.clear();
+    size_t i = 0, j = 0;
+    while(i < a.size() || j < b.size())
+        {
+        if(j == b.size() || (i < a.size() && a[i] < b[j])) res.push_back(a[i++]);
+        else if(i == a.size() || b[j] < a[i]) res.push_back(b[j++]);
+        else { ++i; ++j; }
+        }
+    }
+
+//Product of the dimensions of the indices in a or b
+inline Real
+pairCost(const std::vector<int>& a, const std::vector<int>& b,
+         const std::vector<Real>& dim)
+    {
+    Real c = 1;
+    size_t i = 0, j = 0;
+    while(i < a.size() || j < b.size())
+        {
+        if(j == b.size() || (i < a.size() && a[i] < b[j])) c *= dim[a[i++]];
+        else if(i == a.size() || b[j] < a[i]) c *= dim[b[j++]];
+        else { c *= dim[a[i]]; ++i; ++j; }
+        }
+    return c;
+    }
+
+} //namespace Internal
+
+template <class Tensor>
+void TensorNetwork<Tensor>::
+plan() const
+    {
+    if(planned_) return;
+    const int n = t_.size();
+
+    //Number the distinct indices and list those of each operand
+    std::vector<IndexT> all;
+    std::vector<Real> dim;
+    std::vector<std::vector<int> > ind(n);
+    for(int t = 0; t < n; ++t)
+        {
+        const Tensor& T = t_[t];
+        for(int j = 1; j <= T.r(); ++j)
+            {
+            const IndexT& I = T.index(j);
+            if(I.type() == ReIm) continue;
+            int id = 0;
+            while(id < int(all.size()) && !(all[id] == I)) ++id;
+            if(id == int(all.size())) { all.push_back(I); dim.push_back(I.m()); }
+            ind[t].push_back(id);
+            }
+        sort(ind[t].begin(),ind[t].end());
+        }
+
+    steps_.clear();
+    cost_ = 0;
+    if(n <= max_exact) planExact(ind,dim);
+    else               planGreedy(ind,dim);
+    planned_ = true;
+    }
+
+template <class Tensor>
+void TensorNetwork<Tensor>::
+planExact(const std::vector<std::vector<int> >& ind,
+          const std::vector<Real>& dim) const
+    {
+    const int n = ind.size();
+    if(n < 2) return;
+    const int nset = 1 << n;
+
+    //For every subset S of the operands: the open indices
+    //of their product, the least cost of making it and
+    //the part split off for the last step
+    std::vector<std::vector<int> > open(nset);
+    std::vector<Real> best(nset,0);
+    std::vector<int> split(nset,0);
+    std::vector<int> tmp;
+    for(int S = 1; S < nset; ++S)
+        {
+        const int low = S & (-S);
+        if(S == low)
+            {
+            int t = 0; while((1 << t) != S) ++t;
+            open[S] = ind[t];
+            continue;
+            }
+        Internal::openIndices(open[low],open[S ^ low],open[S]);
+
+        best[S] = -1;
+        //Subsets containing the lowest operand of S,
+        //so each split is seen once
+        for(int sub = (S-1) & S; sub > 0; sub = (sub-1) & S)
+            {
+            if(!(sub & low)) continue;
+            const int rest = S ^ sub;
+            Real c = best[sub] + best[rest]
+                   + Internal::pairCost(open[sub],open[rest],dim);
+            if(best[S] < 0 || c < best[S]) { best[S] = c; split[S] = sub; }
+            }
+        }
+    cost_ = best[nset-1];
+
+    //Steps in the order they can be done: both parts
+    //of a split before the split itself
+    std::vector<int> stack(1,nset-1), order;
+    while(!stack.empty())
+        {
+        int S = stack.back(); stack.pop_back();
+        if((S & (S-1)) == 0) continue;
+        order.push_back(S);
+        stack.push_back(split[S]);
+        stack.push_back(S ^ split[S]);
+        }
+    std::vector<int> made(nset,-1);
+    for(int t = 0; t < n; ++t) made[1 << t] = t;
+    for(int k = int(order.size())-1; k >= 0; --k)
+        {
+        const int S = order[k];
+        Step s; s.a = made[split[S]]; s.b = made[S ^ split[S]];
+        made[S] = n + steps_.size();
+        steps_.push_back(s);
+        }
+    }
+
+template <class Tensor>
+void TensorNetwork<Tensor>::
+planGreedy(const std::vector<std::vector<int> >& ind,
+           const std::vector<Real>& dim) const
+    {
+    const int n = ind.size();
+    std::vector<std::vector<int> > open(ind);
+    std::vector<int> alive(n);
+    for(int t = 0; t < n; ++t) alive[t] = t;
+
+    //Contract the cheapest pair sharing an index; outer
+    //products only once no pair shares one
+    std::vector<int> res;
+    while(alive.size() > 1)
+        {
+        int bi = -1, bj = -1;
+        bool bshare = false;
+        Real bc = 0;
+        for(size_t i = 0; i < alive.size(); ++i)
+        for(size_t j = i+1; j < alive.size(); ++j)
+            {
+            const std::vector<int> &a = open[alive[i]], &b = open[alive[j]];
+            Internal::openIndices(a,b,res);
+            const bool share = (res.size() < a.size() + b.size());
+            Real c = Internal::pairCost(a,b,dim);
+            if(bi < 0 || (share && !bshare) || (share == bshare && c < bc))
+                { bi = i; bj = j; bc = c; bshare = share; }
+            }
+        Step s; s.a = alive[bi]; s.b = alive[bj];
+        open.push_back(std::vector<int>());
+        Internal::openIndices(open[s.a],open[s.b],open.back());
+        cost_ += bc;
+        steps_.push_back(s);
+        alive.erase(alive.begin()+bj);
+        alive[bi] = open.size()-1;
+        }
+    }
+
+template <class Tensor>
+Tensor TensorNetwork<Tensor>::
+result() const
+    {
+    const int n = t_.size();
+    if(n == 0) Error("TensorNetwork: no operands");
+    if(n == 1) return t_[0];
+    plan();
+
+    std::vector<Tensor> made(steps_.size());
+    for(size_t s = 0; s < steps_.size(); ++s)
+        {
+        const int a = steps_[s].a, b = steps_[s].b;
+        made[s] = (a < n ? t_[a] : made[a-n]);
+        if(a >= n) made[a-n] = Tensor();
+        made[s] *= (b < n ? t_[b] : made[b-n]);
+        if(b >= n) made[b-n] = Tensor();
+        }
+    return made.back();
+    }
+
+#endif
@@ -4,5 +4,6 @@
 #include "measure.h"
 #include "DMRGWorker.h"
 #include "dmrg.h"
+#include "contract.h"
 
 #endif
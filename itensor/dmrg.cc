@@ -1,7 +1,166 @@
 #include "dmrg.h"
+#include <algorithm>
 using std::cout;
 using std::vector;
 
+//Appends T with each of its Index pairs (I,I') tied into I,
+//which keeps only the elements diagonal in those pairs.
+//If npair >= 0, blocks with fewer pairs (off-diagonal blocks 
+//of an IQTensor) are skipped.
+static void
+tiedBlock(const ITensor& T, int npair, vector<ITensor>& res)
+    {
+    vector<Index> tie;
+    for(int j = 1; j <= T.r(); ++j)
+        {
+        const Index& I = T.index(j);
+        if(I.primeLevel() == 0 && T.hasindex(primed(I))) tie.push_back(I);
+        }
+    if(npair >= 0 && (int)tie.size() != npair) return;
+    ITensor t(T);
+    for(size_t n = 0; n < tie.size(); ++n)
+        t.tieIndices(tie[n],primed(tie[n]),tie[n]);
+    res.push_back(t);
+    }
+
+//True if every Index of t is an Index of a or of b
+static bool
+covered(const ITensor& t, const ITensor& a, const ITensor& b)
+    {
+    for(int j = 1; j <= t.r(); ++j)
+        {
+        const Index& I = t.index(j);
+        if(!a.hasindex(I) && !b.hasindex(I)) return false;
+        }
+    return true;
+    }
+
+//Factors in fac acting on block B: every Index they share 
+//with phi (listed in ext by unique_Real) belongs to B
+static void
+actingOn(const ITensor& B, const vector<Real>& ext, 
+         const vector<ITensor>& fac, vector<const ITensor*>& res)
+    {
+    res.clear();
+    for(size_t n = 0; n < fac.size(); ++n)
+        {
+        const ITensor& t = fac[n];
+        bool ok = true;
+        for(int j = 1; j <= t.r() && ok; ++j)
+            {
+            const Index& I = t.index(j);
+            if(std::binary_search(ext.begin(),ext.end(),I.unique_Real()))
+                ok = B.hasindex(I);
+            }
+        if(ok) res.push_back(&t);
+        }
+    }
+
+//Adds the diagonal of L*H*R to diag, block by block of phi.
+//The tied factors have one Index per phi Index they act on 
+//plus MPO links, so only links need matching: each diagonal 
+//element costs a few small products instead of a matvec.
+static void
+addDiagBlocks(const vector<ITensor>& phib, const vector<ITensor>& Lt, 
+              const vector<ITensor>& Ht, const vector<ITensor>& Rt, Vector& diag)
+    {
+    vector<Real> ext;
+    for(size_t n = 0; n < phib.size(); ++n)
+    for(int j = 1; j <= phib[n].r(); ++j)
+        ext.push_back(phib[n].index(j).unique_Real());
+    std::sort(ext.begin(),ext.end());
+
+    vector<const ITensor*> Lb, Hb, Rb;
+    int off = 1;
+    for(size_t n = 0; n < phib.size(); ++n)
+        {
+        const ITensor& B = phib[n];
+        const int d = B.vec_size();
+        actingOn(B,ext,Lt,Lb);
+        actingOn(B,ext,Ht,Hb);
+        actingOn(B,ext,Rt,Rb);
+
+        ITensor D;
+        for(size_t h = 0; h < Hb.size(); ++h)
+        for(size_t l = 0; l < Lb.size(); ++l)
+            {
+            if(!covered(*Lb[l],B,*Hb[h])) continue;
+            for(size_t r = 0; r < Rb.size(); ++r)
+                {
+                if(!covered(*Rb[r],B,*Hb[h])) continue;
+                //Every MPO link of H must be closed by L or R
+                bool closed = true;
+                for(int j = 1; j <= Hb[h]->r() && closed; ++j)
+                    {
+                    const Index& I = Hb[h]->index(j);
+                    closed = B.hasindex(I) || Lb[l]->hasindex(I) || Rb[r]->hasindex(I);
+                    }
+                if(!closed) continue;
+                ITensor t = (*Lb[l]) * (*Hb[h]);
+                t *= *Rb[r];
+                if(D.is_null()) D = t; else D += t;
+                }
+            }
+
+        if(D.is_not_null())
+            {
+            ITensor b(B);
+            b.assignFrom(D);
+            Vector v(d);
+            b.assignToVec(v);
+            diag.SubVector(off,off+d-1) += v;
+            }
+        off += d;
+        }
+    }
+
+void
+addProjOpDiag(const ITensor& phi, const ITensor& L, const ITensor& R, const ITensor& H, Vector& diag)
+    {
+    if(phi.is_complex() || H.is_complex())
+        Error("addProjOpDiag: complex tensors not supported");
+    vector<ITensor> phib(1,phi), Lt, Ht, Rt;
+    //A missing edge term acts as the scalar 1
+    if(L.is_null()) Lt.push_back(ITensor(1)); else tiedBlock(L,-1,Lt);
+    if(R.is_null()) Rt.push_back(ITensor(1)); else tiedBlock(R,-1,Rt);
+    tiedBlock(H,-1,Ht);
+    addDiagBlocks(phib,Lt,Ht,Rt,diag);
+    }
+
+//Number of (I,I') IQIndex pairs of T
+static int
+numPairs(const IQTensor& T)
+    {
+    int np = 0;
+    for(int j = 1; j <= T.r(); ++j)
+        {
+        const IQIndex& I = T.index(j);
+        if(I.primeLevel() == 0 && T.hasindex(I.primed())) ++np;
+        }
+    return np;
+    }
+
+static void
+tiedBlocks(const IQTensor& T, vector<ITensor>& res)
+    {
+    if(T.is_null()) { res.push_back(ITensor(1)); return; }
+    const int np = numPairs(T);
+    for(IQTensor::const_iten_it it = T.const_iten_begin(); it != T.const_iten_end(); ++it)
+        tiedBlock(*it,np,res);
+    }
+
+void
+addProjOpDiag(const IQTensor& phi, const IQTensor& L, const IQTensor& R, const IQTensor& H, Vector& diag)
+    {
+    if(phi.is_complex() || H.is_complex())
+        Error("addProjOpDiag: complex tensors not supported");
+    vector<ITensor> phib(phi.const_iten_begin(),phi.const_iten_end()), Lt, Ht, Rt;
+    tiedBlocks(L,Lt);
+    tiedBlocks(R,Rt);
+    tiedBlocks(H,Ht);
+    addDiagBlocks(phib,Lt,Ht,Rt,diag);
+    }
+
 //Orthogonalizing DMRG. Puts in an energy penalty if psi has an overlap with any MPS in 'other'.
 Real dmrg(MPS& psi, const MPO& finalham, const Sweeps& sweeps, const vector<MPS>& other, DMRGOpts& opts)
 {
@@ -83,7 +242,10 @@ Real dmrg(MPS& psi, const MPO& finalham, const Sweeps& sweeps, const vector<MPS>
                 for(unsigned int o = 0; o < other.size(); o++)
                     lham.other[o] = lrother[o][l] * other[o].AA(l) * other[o].AA(l+1) * lrother[o][l+1];
             }
+            if(opts.precondition() && !phi.is_complex() && !mpoh.is_complex()) 
+                lham.computeDiag();
             David(lham,1,1e-4,evals,evecs,1,1,debuglevel);
+            opts.addDavidsonIters(sw,lham.numProducts());
 
             energy = evals(1);
             phi.assignFromVec(evecs.Row(1));
@@ -3,29 +3,86 @@
 #include "mpo.h"
 #include "sparse.h"
 #include "davidson.h"
+#include "eigensolver.h"
 #include "Sweeps.h"
 #include "DMRGOpts.h"
 
+//Number of tensors summed in one pass by projOpTerms
+static const int projop_chunk = 4;
+
+//Sums the terms first,...,last-1 of L*phi*H*R into Hphi,
+//projop_chunk at a time in one pass, the running sum being the
+//first of the next ones. Besides Hphi at most projop_chunk
+//tensors of its size are kept, whatever the number of terms.
 template<class Tensor,class TensorSet, class OpTensorSet>
-void applyProjOp(const Tensor& phi, const TensorSet& L, const TensorSet& R, const OpTensorSet& H, Tensor& Hphi)
+void projOpTerms(const Tensor& phi, const TensorSet& L, const TensorSet& R, const OpTensorSet& H, 
+                 bool useL, bool useR, int first, int last, Tensor& Hphi)
+{
+    std::vector<Tensor> terms;
+    terms.reserve(projop_chunk);
+    Hphi = Tensor();
+    for(int j = first; j < last; )
+    {
+        terms.clear();
+        if(Hphi.is_not_null()) 
+        { 
+            terms.push_back(Tensor()); 
+            terms.back().swap(Hphi); 
+        }
+        for(; j < last && (int)terms.size() < projop_chunk; ++j)
+        {
+            terms.push_back(useL ? L[j]*phi : phi);
+            Tensor& t = terms.back();
+            t *= H[j];
+            if(useR) t *= R[j];
+        }
+        sum(terms,Hphi);
+    }
+}
+
+//With nacc > 1 the terms are split into nacc contiguous ranges 
+//summed concurrently (one accumulator per thread when built with 
+//OpenMP), then the partial sums are added pairwise in a tree.
+//The result depends on nacc but not on the number of threads.
+template<class Tensor,class TensorSet, class OpTensorSet>
+void applyProjOp(const Tensor& phi, const TensorSet& L, const TensorSet& R, const OpTensorSet& H, Tensor& Hphi,
+                 int nacc = 1)
 {
     bool useL(L.size() == 0 ? false : L[0].is_not_null()),
          useR(R.size() == 0 ? false : R[0].is_not_null());
-    Hphi = (useL ? L[0]*phi : phi); 
-    Hphi *= H[0];
-    if(useR) Hphi *= R[0];
-    for(unsigned int j = 1; j < H.size(); ++j)
+    const int nterm = H.size();
+    nacc = min(nacc,nterm);
+    if(nacc <= 1)
+    {
+        projOpTerms(phi,L,R,H,useL,useR,0,nterm,Hphi);
+        Hphi.mapprime(1,0);
+        return;
+    }
+
+    std::vector<Tensor> acc(nacc);
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static,1) num_threads(nacc)
+#endif
+    for(int a = 0; a < nacc; ++a)
+        projOpTerms(phi,L,R,H,useL,useR,(a*nterm)/nacc,((a+1)*nterm)/nacc,acc[a]);
+
+    for(int stride = 1; stride < nacc; stride *= 2)
     {
-        Tensor phij = (useL ? L[j]*phi : phi);
-        phij *= H[j];
-        if(useR) phij *= R[j];
-        Hphi += phij;
+        const int npair = (nacc+stride-1)/(2*stride); //pairs (a,a+stride), a+stride < nacc
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static,1) if(npair > 1)
+#endif
+        for(int p = 0; p < npair; ++p)
+            acc[2*stride*p] += acc[2*stride*p+stride];
     }
+    Hphi = acc[0];
     Hphi.mapprime(1,0);
 }
 
+//A single term has nothing to split; nacc is ignored
 template<class Tensor, class OpTensor>
-void applyProjOp(const Tensor& phi, const Tensor& L, const Tensor& R, const OpTensor& H, Tensor& Hphi)
+void applyProjOp(const Tensor& phi, const Tensor& L, const Tensor& R, const OpTensor& H, Tensor& Hphi,
+                 int nacc = 1)
 {
     bool useL = L.is_not_null(),
          useR = R.is_not_null();
@@ -35,6 +92,29 @@ void applyProjOp(const Tensor& phi, const Tensor& L, const Tensor& R, const OpTe
     Hphi.mapprime(1,0);
 }
 
+//Adds the diagonal of the projected Hamiltonian L*H*R to diag,
+//ordered as phi.assignToVec. Uses the diagonals of L, H and R
+//(their primed/unprimed Index pairs tied), never the full matrix.
+void addProjOpDiag(const ITensor& phi, const ITensor& L, const ITensor& R, const ITensor& H, Vector& diag);
+void addProjOpDiag(const IQTensor& phi, const IQTensor& L, const IQTensor& R, const IQTensor& H, Vector& diag);
+
+template<class Tensor,class TensorSet, class OpTensorSet>
+void projOpDiag(const Tensor& phi, const TensorSet& L, const TensorSet& R, const OpTensorSet& H, Vector& diag)
+{
+    bool useL(L.size() == 0 ? false : L[0].is_not_null()),
+         useR(R.size() == 0 ? false : R[0].is_not_null());
+    diag.ReDimension(phi.vec_size()); diag = 0;
+    for(unsigned int j = 0; j < H.size(); ++j)
+        addProjOpDiag(phi,(useL ? L[j] : Tensor()),(useR ? R[j] : Tensor()),H[j],diag);
+}
+
+template<class Tensor, class OpTensor>
+void projOpDiag(const Tensor& phi, const Tensor& L, const Tensor& R, const OpTensor& H, Vector& diag)
+{
+    diag.ReDimension(phi.vec_size()); diag = 0;
+    addProjOpDiag(phi,L,R,H,diag);
+}
+
 template<class Tensor>
 class BaseLocalHam : public BigMatrix // to do DMRG using an MPO
 {
@@ -53,25 +133,41 @@ class LocalHam : public BaseLocalHam<Tensor>
     Tensor& psi;
     Vector diag;
     const TensorSet &LeftTerm, &RightTerm, &MPOTerm;
+    mutable int nproduct;
+    int nacc;
 public:
     LocalHam(const TensorSet& le, const TensorSet& ri, const TensorSet& mpo, Tensor& psi_) 
-	: psi(psi_), LeftTerm(le), RightTerm(ri), MPOTerm(mpo)
+	: psi(psi_), LeftTerm(le), RightTerm(ri), MPOTerm(mpo), nproduct(0), nacc(1)
     { diag.ReDimension(psi.vec_size()); diag = 1; }
 
+    //Number of concurrent accumulators for the terms of a TensorSet
+    void termThreads(int n) { nacc = n; }
+
     int Size() const { return psi.vec_size(); }
     VectorRef DiagRef() const { return diag; }
 
+    //Replace the unit diagonal by the true one, preconditioning David
+    void computeDiag() { projOpDiag(psi,LeftTerm,RightTerm,MPOTerm,diag); }
+
+    //Number of products (Davidson iterations) so far
+    int numProducts() const { return nproduct; }
+
     Vector operator*(const VectorRef &A) const
 	{ Vector res(Size()); product(A,res); return res; }
 
     void product(const VectorRef& A, VectorRef& B) const
 	{
+        ++nproduct;
         psi.assignFromVec(A);
         Tensor psip; 
-        applyProjOp(psi,LeftTerm,RightTerm,MPOTerm,psip);
+        applyProjOp(psi,LeftTerm,RightTerm,MPOTerm,psip,nacc);
         psi.assignFrom(psip);
         psi.assignToVec(B);
 	}
+
+    //Tensor-native product used by davidson (eigensolver.h)
+    void product(const Tensor& phi, Tensor& phip) const
+	{ ++nproduct; applyProjOp(phi,LeftTerm,RightTerm,MPOTerm,phip,nacc); }
 };
 
 template<class Tensor>
@@ -84,22 +180,30 @@ class LocalHamOrth : public BaseLocalHam<Tensor> // to do DMRG using an MPO, ort
     const Tensor &LeftTerm, &RightTerm, &MPOTerm;
     bool useleft, useright;
     Real weight;
+    mutable int nproduct;
 public:
     std::vector<Tensor> other;
 
     LocalHamOrth(const Tensor& le, const Tensor& ri, const Tensor& mpo, Tensor& psi_, Real weight_) 
 	: psi(psi_), LeftTerm(le), RightTerm(ri), MPOTerm(mpo), 
-      useleft(le.is_not_null()), useright(ri.is_not_null()), weight(weight_)
+      useleft(le.is_not_null()), useright(ri.is_not_null()), weight(weight_), nproduct(0)
     { diag.ReDimension(psi.vec_size()); diag = 1; }
 
     int Size() const { return psi.vec_size(); }
     VectorRef DiagRef() const { return diag; }
 
+    //Replace the unit diagonal by that of the projected Hamiltonian;
+    //the small-rank penalty from 'other' is left out
+    void computeDiag() { projOpDiag(psi,LeftTerm,RightTerm,MPOTerm,diag); }
+
+    int numProducts() const { return nproduct; }
+
     Vector operator*(const VectorRef &A) const
 	{ Vector res(Size()); product(A,res); return res; }
 
     void product(const VectorRef &A , VectorRef & B) const
 	{
+        ++nproduct;
         psi.assignFromVec(A);
         Tensor psip;
         applyProjOp(psi,LeftTerm,RightTerm,MPOTerm,psip);
@@ -159,32 +263,43 @@ void putInQNs(std::vector<Tensor>& phi, const TensorSet& mpoh, const TensorSet&
 template<class TensorSet>
 void putInQNs(ITensor& phi, const TensorSet& mpoh, const TensorSet& LH, const TensorSet& RH) { }
 
+//Uses opts.precondition() and opts.termThreads(). Returns the energy; 
+//the number of products (Davidson iterations) is put in nproduct.
 template<class Tensor, class TensorSet>
-Real doDavidson(Tensor& phi, const TensorSet& mpoh, const TensorSet& LH, const TensorSet& RH, int niter, int debuglevel, Real errgoal)
+Real doDavidson(Tensor& phi, const TensorSet& mpoh, const TensorSet& LH, const TensorSet& RH, int niter, int debuglevel, Real errgoal,
+                const BaseDMRGOpts& opts, int& nproduct)
 {
     putInQNs(phi,mpoh,LH,RH);
     LocalHam<Tensor,TensorSet> lham(LH,RH,mpoh,phi);
+    lham.termThreads(opts.termThreads());
+    Real En;
     if(niter < 1)
     {
         //Just return the current energy (no optimization via Davidson)
-        Vector Phi(phi.vec_size()),HPhi(phi.vec_size()); 
-        phi.assignToVec(Phi);
-        Phi /= Norm(Phi);
-        lham.product(Phi,HPhi);
-        Tensor Hphi(phi); Hphi.assignFromVec(HPhi);
-        phi.assignFromVec(Phi);
-        return Dot(phi,Hphi);
+        phi *= 1.0/fabs(phi.norm());
+        Tensor Hphi;
+        lham.product(phi,Hphi);
+        En = Dot(phi,Hphi);
+    }
+    else if(opts.precondition() && !phi.is_complex())
+    {
+        lham.computeDiag();
+        En = davidson(lham,lham.DiagRef(),phi,niter,errgoal,debuglevel);
     }
     else
     {
-        Matrix evecs(niter,phi.vec_size()); Vector evals;
-        phi.assignToVec(evecs.Row(1));
-        evecs.Row(1) /= Norm(evecs.Row(1));
-        David(lham,1,errgoal,evals,evecs,1,1,debuglevel);
-        phi.assignFromVec(evecs.Row(1));
-        return evals(1); //energy
+        En = davidson(lham,phi,niter,errgoal,debuglevel);
     }
-    return 1000;
+    nproduct = lham.numProducts();
+    return En;
+}
+
+template<class Tensor, class TensorSet>
+Real doDavidson(Tensor& phi, const TensorSet& mpoh, const TensorSet& LH, const TensorSet& RH, int niter, int debuglevel, Real errgoal)
+{
+    DMRGOpts opts;
+    int nproduct = 0;
+    return doDavidson(phi,mpoh,LH,RH,niter,debuglevel,errgoal,opts,nproduct);
 }
 
 template<class Tensor, class TensorSet>
@@ -212,7 +327,7 @@ Vector doDavidson(std::vector<Tensor>& phi, const TensorSet& mpoh, const TensorS
     return energies;
 }
 
-void onesite_sweepnext(int &l, int &ha, int N)
+inline void onesite_sweepnext(int &l, int &ha, int N)
 {
     if(ha == 1)
     {
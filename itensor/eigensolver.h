@@ -0,0 +1,167 @@
+#ifndef __ITENSOR_EIGENSOLVER_H
+#define __ITENSOR_EIGENSOLVER_H
+#include "types.h"
+
+//
+// Davidson algorithm for the lowest eigenvector of a
+// big Hermitian operator A acting on tensors.
+//
+// Works directly on tensor storage (Dot, +=, *= and norm),
+// so the wavefunction is never flattened into a Vector.
+// LocalT must provide
+//
+//   void product(const Tensor& phi, Tensor& Aphi) const;
+//
+// On entry phi is the starting vector; on return it is the
+// normalized lowest eigenvector and the eigenvalue is returned.
+//
+// maxsize is the largest Krylov basis kept before restarting
+// from the current best vector. As with David, passes are
+// repeated until the residual norm falls below errgoal or,
+// after the first pass, below 5E-2.
+//
+// The second version is preconditioned by diag, the diagonal 
+// of A ordered as phi.assignToVec: each correction q becomes 
+// (lambda - diag)^-1 q, as in David. 
+//
+
+template <class LocalT, class Tensor>
+Real
+davidson(const LocalT& A, Tensor& phi, int maxsize, Real errgoal,
+         int debuglevel = 0, int maxpass = 100);
+
+template <class LocalT, class Tensor>
+Real
+davidson(const LocalT& A, const VectorRef& diag, Tensor& phi, 
+         int maxsize, Real errgoal, int debuglevel = 0, int maxpass = 100);
+
+
+template <class LocalT, class Tensor>
+Real
+davidson(const LocalT& A, Tensor& phi, int maxsize, Real errgoal,
+         int debuglevel, int maxpass)
+    {
+    //An empty diagonal turns preconditioning off
+    return davidson(A,Vector(),phi,maxsize,errgoal,debuglevel,maxpass);
+    }
+
+template <class LocalT, class Tensor>
+Real
+davidson(const LocalT& A, const VectorRef& diag, Tensor& phi, 
+         int maxsize, Real errgoal, int debuglevel, int maxpass)
+    {
+    const int n = phi.vec_size();
+    if(diag.Length() != 0 && diag.Length() != n)
+        Error("davidson: diag and phi sizes differ");
+    maxsize = min(maxsize,n);
+    if(maxsize < 2) maxsize = min(2,n); //a single vector never improves
+    if(maxsize < 1) Error("davidson: phi has zero size");
+
+    Real nrm = fabs(phi.norm()); //ITensor::norm carries the sign of the scale
+    if(nrm == 0) Error("davidson: zero norm starting vector");
+    phi *= 1.0/nrm;
+
+    std::vector<Tensor> V(maxsize), AV(maxsize);
+    Matrix M(maxsize,maxsize);
+    Vector evals;
+    Matrix evecs;
+    Tensor q, t;
+    Vector qv(diag.Length());
+    Real lambda = 0, qnorm = 1;
+    int nmatvec = 0;
+
+    for(int pass = 1; pass <= maxpass; ++pass)
+        {
+        V[0] = phi;
+        A.product(V[0],AV[0]); ++nmatvec;
+        M(1,1) = Dot(V[0],AV[0]);
+        Real last_lambda = 1E30;
+        bool done = false;
+        int k = 1;
+
+        for(; ; ++k)
+            {
+            //Lowest eigenpair of the projected problem
+            EigenValues(M.SubMatrix(1,k,1,k),evals,evecs);
+            lambda = evals(1);
+
+            //Residual q = (A - lambda) phi of the Ritz vector
+            //phi = sum_i c_i V_i, which is only formed once the pass ends.
+            //Starting from V[0] keeps q (and the next basis vector) in the 
+            //index order of phi, which products were planned for.
+            q = V[0]; q *= -lambda*evecs(1,1);
+            t = AV[0]; t *= evecs(1,1); q += t;
+            for(int i = 1; i < k; ++i)
+                {
+                t = AV[i]; t *= evecs(i+1,1); q += t;
+                t = V[i]; t *= -lambda*evecs(i+1,1); q += t;
+                }
+            qnorm = fabs(q.norm());
+
+            if(debuglevel > 1 || (debuglevel > 0 && pass == 1 && k == 1))
+                {
+                std::cout << boost::format("%d %d %.12f Eigs: %.12f\n")
+                             % pass % k % qnorm % lambda;
+                }
+
+            if((qnorm < errgoal && fabs(lambda-last_lambda) < errgoal)
+               || qnorm < 1E-12)
+                { done = true; break; }
+            if(k == maxsize) break;
+            last_lambda = lambda;
+
+            //Blocks missing from phi (size mismatch) leave q unpreconditioned
+            if(qv.Length() != 0 && q.vec_size() == qv.Length())
+                {
+                q.assignToVec(qv);
+                for(int j = 1; j <= qv.Length(); ++j)
+                    qv(j) /= ((lambda-diag(j))+1E-33);
+                q.assignFromVec(qv);
+                }
+
+            //Orthogonalize the correction against the basis, a 
+            //second time only if the first pass cancelled most of it
+            Real inorm = fabs(q.norm());
+            for(int pp = 1; pp <= 2; ++pp)
+                {
+                for(int i = 0; i < k; ++i)
+                    {
+                    t = V[i]; t *= -Dot(V[i],q); q += t;
+                    }
+                Real onorm = fabs(q.norm());
+                if(onorm < 1E-14*inorm) { done = true; break; } //basis exhausted
+                q *= 1.0/onorm;
+                if(onorm > 0.5*inorm) break;
+                inorm = 1;
+                }
+            if(done) break;
+            q.scaleOutNorm(); //put the normalization into the data
+
+            V[k] = q;
+            A.product(V[k],AV[k]); ++nmatvec;
+            for(int i = 0; i <= k; ++i)
+                M(i+1,k+1) = M(k+1,i+1) = Dot(V[i],AV[k]);
+            }
+
+        phi = V[0]; phi *= evecs(1,1);
+        for(int i = 1; i < k; ++i)
+            {
+            t = V[i]; t *= evecs(i+1,1); phi += t;
+            }
+
+        if(done || qnorm < 5E-2) break;
+        }
+
+    phi *= 1.0/fabs(phi.norm());
+    phi.scaleOutNorm();
+
+    if(debuglevel > 0)
+        {
+        std::cout << boost::format("    Davidson: %d matvecs, residual %.2E, energy %.12f\n")
+                     % nmatvec % qnorm % lambda;
+        }
+
+    return lambda;
+    }
+
+#endif // __ITENSOR_EIGENSOLVER_H
@@ -221,8 +221,10 @@ private:
 
 namespace boost
 {
-    inline void intrusive_ptr_add_ref(IndexDat* p) { ++(p->numref); }
-    inline void intrusive_ptr_release(IndexDat* p) { if(!p->is_static_ && --(p->numref) == 0){ delete p; } }
+    //Static IndexDat's (Null, ReIm) are never deleted, so their
+    //count is not kept: every default-constructed Index shares one
+    inline void intrusive_ptr_add_ref(IndexDat* p) { if(!p->is_static_) __sync_add_and_fetch(&(p->numref),1); }
+    inline void intrusive_ptr_release(IndexDat* p) { if(!p->is_static_ && __sync_sub_and_fetch(&(p->numref),1) == 0){ delete p; } }
 }
 
 //extern IndexDat IndexDatNull, IndReDat, IndReDatP, IndReDatPP;
@@ -289,6 +291,13 @@ public:
         doprime(pt,primeinc);
 	}
 
+    //Exchange with other without touching reference counts
+    void swap(Index& other)
+    {
+        p.swap(other.p);
+        std::swap(primelevel_,other.primelevel_);
+    }
+
     static const Index& Null()
     {
         static const Index Null_(makeNull);
@@ -323,6 +332,9 @@ public:
     bool noprime_equals(const Index& other) const
 	{ return (p->ur == other.p->ur); }
 
+    //Identifies this Index regardless of prime level
+    Real noprime_Real() const { return p->ur; }
+
     bool operator<(const Index& other) const 
 	{ return (unique_Real() < other.unique_Real()); }
 
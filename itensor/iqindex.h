@@ -1,6 +1,7 @@
 #ifndef __IQINDEX_H
 #define __IQINDEX_H
 #include "index.h"
+#include <boost/unordered_map.hpp>
 
 /*
 * Conventions regarding arrows:
@@ -162,6 +163,7 @@ public:
     : numref(0), is_static_(false)
     {
         iq_.push_back(inqn(i1,q1));
+        makeSecMap();
     }
 
     IQIndexDat(const Index& i1, const QN& q1,
@@ -170,6 +172,7 @@ public:
     {
         iq_.push_back(inqn(i1,q1));
         iq_.push_back(inqn(i2,q2));
+        makeSecMap();
     }
 
     IQIndexDat(const Index& i1, const QN& q1,
@@ -180,6 +183,7 @@ public:
         iq_.push_back(inqn(i1,q1));
         iq_.push_back(inqn(i2,q2));
         iq_.push_back(inqn(i3,q3));
+        makeSecMap();
     }
 
     IQIndexDat(const Index& i1, const QN& q1,
@@ -192,6 +196,7 @@ public:
         iq_.push_back(inqn(i2,q2));
         iq_.push_back(inqn(i3,q3));
         iq_.push_back(inqn(i4,q4));
+        makeSecMap();
     }
 
     IQIndexDat(const Index& i1, const QN& q1,
@@ -206,6 +211,7 @@ public:
         iq_.push_back(inqn(i3,q3));
         iq_.push_back(inqn(i4,q4));
         iq_.push_back(inqn(i5,q5));
+        makeSecMap();
     }
 
     IQIndexDat(const Index& i1, const QN& q1,
@@ -222,6 +228,7 @@ public:
         iq_.push_back(inqn(i4,q4));
         iq_.push_back(inqn(i5,q5));
         iq_.push_back(inqn(i6,q6));
+        makeSecMap();
     }
 
     IQIndexDat(const Index& i1, const QN& q1,
@@ -240,6 +247,7 @@ public:
         iq_.push_back(inqn(i5,q5));
         iq_.push_back(inqn(i6,q6));
         iq_.push_back(inqn(i7,q7));
+        makeSecMap();
     }
 
     IQIndexDat(const Index& i1, const QN& q1,
@@ -260,13 +268,15 @@ public:
         iq_.push_back(inqn(i6,q6));
         iq_.push_back(inqn(i7,q7));
         iq_.push_back(inqn(i8,q8));
+        makeSecMap();
     }
 
     IQIndexDat(std::vector<inqn>& ind_qn)
     : numref(0), is_static_(false)
-    { iq_.swap(ind_qn); }
+    { iq_.swap(ind_qn); makeSecMap(); }
 
-    explicit IQIndexDat(const IQIndexDat& other) : numref(0), is_static_(false), iq_(other.iq_)
+    explicit IQIndexDat(const IQIndexDat& other) 
+    : numref(0), is_static_(false), iq_(other.iq_), secmap_(other.secmap_)
     { }
 
     explicit IQIndexDat(std::istream& s) : numref(0), is_static_(false) { read(s); }
@@ -285,6 +295,7 @@ public:
         iq_.resize(size);
         for(iq_it x = iq_.begin(); x != iq_.end(); ++x)
             { x->read(s); }
+        makeSecMap();
     }
 
     explicit IQIndexDat(Imaker im)
@@ -298,6 +309,7 @@ public:
             iq_.push_back(inqn(Index::IndReImP(),QN())); 
         else if(im == makeReImPP)
             iq_.push_back(inqn(Index::IndReImPP(),QN())); 
+        makeSecMap();
     }
 
     static IQIndexDat* Null()
@@ -327,14 +339,25 @@ public:
     friend inline void boost::intrusive_ptr_add_ref(IQIndexDat* p);
     friend inline void boost::intrusive_ptr_release(IQIndexDat* p);
     int count() const { return numref; }
+
+    //Position of each Index in iq_, keyed by its noprime_Real
+    boost::unordered_map<Real,int> secmap_;
+
 private:
     void operator=(const IQIndexDat&);
+
+    void makeSecMap()
+    {
+        secmap_.clear();
+        for(size_t n = 0; n < iq_.size(); ++n)
+            secmap_[iq_[n].index.noprime_Real()] = n;
+    }
 };
 
 namespace boost
 {
-    inline void intrusive_ptr_add_ref(IQIndexDat* p) { ++(p->numref); }
-    inline void intrusive_ptr_release(IQIndexDat* p) { if(!p->is_static_ && --(p->numref) == 0){ delete p; } }
+    inline void intrusive_ptr_add_ref(IQIndexDat* p) { __sync_add_and_fetch(&(p->numref),1); }
+    inline void intrusive_ptr_release(IQIndexDat* p) { if(!p->is_static_ && __sync_sub_and_fetch(&(p->numref),1) == 0){ delete p; } }
 }
 
 struct IQIndexVal;
@@ -658,6 +681,26 @@ class IQIndex : public Index
         return false;
         }
 
+    //Position (starting from 0) of the Index i among 
+    //the Index's of this IQIndex, or -1 if not found
+    int sector(const Index& i) const
+        {
+        IQINDEX_CHECK_NULL
+        //A short scan beats hashing for the few sectors of a site
+        const size_t nsec = pd->iq_.size();
+        if(nsec <= 8)
+            {
+            for(size_t n = 0; n < nsec; ++n)
+                if(pd->iq_[n].index == i) return n;
+            return -1;
+            }
+        boost::unordered_map<Real,int>::const_iterator 
+            f = pd->secmap_.find(i.noprime_Real());
+        if(f == pd->secmap_.end() || !(pd->iq_[f->second].index == i)) 
+            return -1;
+        return f->second;
+        }
+
     int offset(const Index& I) const
         {
         int os = 0;
@@ -1,13 +1,10 @@
 #include "iqtensor.h"
-#include <set>
+#include <algorithm>
 using std::cout;
 using std::cerr;
 using std::endl;
 using std::vector;
-using std::list;
-using std::set;
 using std::map;
-using std::multimap;
 using std::ostream;
 using std::istream;
 using std::pair;
@@ -16,16 +13,16 @@ using std::make_pair;
 DatAllocator<IQTDat> IQTDat::allocator;
 
 IQTDat::
-IQTDat() : numref(0), rmap_init(false) { }
+IQTDat() : numref(0), rmap_init(false), rmap_lock(0) { }
 
 IQTDat::
 IQTDat(const IQIndex& i1) 
-    : iqindex_(1), numref(0), rmap_init(false)
+    : iqindex_(1), numref(0), rmap_init(false), rmap_lock(0)
 	{ iqindex_[0] = i1; }
 
 IQTDat::
 IQTDat(const IQIndex& i1, const IQIndex& i2)
-    : iqindex_(2), numref(0), rmap_init(false)
+    : iqindex_(2), numref(0), rmap_init(false), rmap_lock(0)
 	{ 
 	iqindex_[0] = i1; 
 	iqindex_[1] = i2; 
@@ -33,7 +30,7 @@ IQTDat(const IQIndex& i1, const IQIndex& i2)
 
 IQTDat::
 IQTDat(const IQIndex& i1, const IQIndex& i2, const IQIndex& i3)
-    : iqindex_(3), numref(0), rmap_init(false)
+    : iqindex_(3), numref(0), rmap_init(false), rmap_lock(0)
 	{ 
 	iqindex_[0] = i1; 
 	iqindex_[1] = i2; 
@@ -45,7 +42,7 @@ IQTDat(const IQIndex& i1, const IQIndex& i2,
        const IQIndex& i3, const IQIndex& i4,
        const IQIndex& i5, const IQIndex& i6, 
 	   const IQIndex& i7, const IQIndex& i8)
-    : iqindex_(4), numref(0), rmap_init(false)
+    : iqindex_(4), numref(0), rmap_init(false), rmap_lock(0)
 	{ 
 	iqindex_[0] = i1; 
 	iqindex_[1] = i2; 
@@ -63,17 +60,25 @@ IQTDat(const IQIndex& i1, const IQIndex& i2,
 
 IQTDat::
 IQTDat(vector<IQIndex>& iqinds_) 
-    : numref(0), rmap_init(false) 
+    : numref(0), rmap_init(false), rmap_lock(0) 
     { iqindex_.swap(iqinds_); }
 
 IQTDat::
 IQTDat(const IQTDat& other) 
-    : itensor(other.itensor), iqindex_(other.iqindex_), numref(0), rmap_init(false)
-	{ }
+    : itensor(other.itensor), iqindex_(other.iqindex_), numref(0), 
+      rmap_init(false), rmap_lock(0)
+	{ 
+    if(other.rmap_init) 
+        {
+        __sync_synchronize();
+        rmap = other.rmap;
+        rmap_init = true;
+        }
+    }
 
 IQTDat::
 IQTDat(istream& s) 
-    : numref(0) 
+    : numref(0), rmap_init(false), rmap_lock(0) 
     { read(s); }
 
 void IQTDat::
@@ -106,15 +111,52 @@ write(ostream& s) const
         { jj->write(s); }
 	}
 
+long IQTDat::
+sector_key(const ITensor& t) const
+    {
+    const int r = iqindex_.size();
+    if(t.r() != r)
+        {
+        Print(t);
+        Error("IQTDat::sector_key: block has wrong number of indices");
+        }
+    long key = 0, stride = 1;
+    for(int j = 0; j < r; ++j)
+        {
+        const IQIndex& I = iqindex_[j];
+        //Blocks usually list their Index's in IQIndex order,
+        //so start looking at position j
+        int pos = -1;
+        for(int a = 0; a < r && pos == -1; ++a)
+            pos = I.sector(t.index((j+a)%r+1));
+        if(pos == -1)
+            {
+            Print(t); Print(I);
+            Error("IQTDat::sector_key: block Index not found in IQIndex");
+            }
+        key += pos*stride;
+        stride *= I.nindex();
+        }
+    return key;
+    }
+
+//Threads contracting a shared IQTensor may look up its blocks
+//at once: the first to need rmap fills it, under rmap_lock,
+//and rmap_init is set only once rmap is complete
 void IQTDat::
 init_rmap() const
 	{
-	if(rmap_init) return;
-	for(iten_it it = itensor.begin(); 
-        it != itensor.end(); 
-        ++it)
-	    rmap[ApproxReal(it->unique_Real())] = it;
-	rmap_init = true;
+	if(rmap_init) { __sync_synchronize(); return; }
+	while(__sync_lock_test_and_set(&rmap_lock,1)) sched_yield();
+	if(!rmap_init)
+	    {
+	    rmap.clear();
+	    for(size_t n = 0; n < itensor.size(); ++n)
+	        rmap[sector_key(itensor[n])] = n;
+	    __sync_synchronize();
+	    rmap_init = true;
+	    }
+	__sync_lock_release(&rmap_lock);
 	}
 
 void IQTDat::
@@ -126,29 +168,48 @@ uninit_rmap() const
 	}
 
 bool IQTDat::
-has_itensor(const ApproxReal& r) const
+has_itensor(long key) const
+	{ 
+	init_rmap();
+	return rmap.count(key) == 1; 
+	}
+
+ITensor& IQTDat::
+get_itensor(long key) const
 	{ 
 	init_rmap();
-	return rmap.count(r) == 1; 
+	return itensor[rmap.find(key)->second];
 	}
 
 void IQTDat::
-insert_itensor(const ApproxReal& r, const ITensor& t)
+insert_itensor(long key, const ITensor& t)
+    {
+    init_rmap();
+    rmap[key] = itensor.size();
+    itensor.push_back(t);
+    }
+
+void IQTDat::
+take_itensor(long key, ITensor& t)
     {
-    itensor.push_front(t);
-    rmap[r] = itensor.begin();
+    init_rmap();
+    rmap[key] = itensor.size();
+    itensor.push_back(ITensor());
+    itensor.back().swap(t);
     }
 
 void IQTDat::
 clean(Real min_norm)
 {
-list<ITensor> nitensor;
+vector<ITensor> nitensor;
+nitensor.reserve(itensor.size());
 for(const_iten_it it = itensor.begin(); it != itensor.end(); ++it)
     {
         if(it->norm() >= min_norm)
             nitensor.push_back(*it);
     }
 itensor.swap(nitensor);
+uninit_rmap();
 }
 
 void DoPrimer::operator()(IQIndex &iqi) const { iqi.doprime(pt,inc); }
@@ -338,31 +399,44 @@ operator*=(Real fac)
     return *this; 
     }
 
+IQTensor& IQTensor::
+operator*=(const LogNumber& fac) 
+    { 
+    solo();
+    if(fac.sign() == 0) 
+        { p->itensor.clear(); p->uninit_rmap(); return *this; }
+    for(iten_it it = p->itensor.begin(); it != p->itensor.end(); ++it)
+        {
+        (*it) *= fac;
+        }
+    return *this; 
+    }
+
 void IQTensor::
 insert(const ITensor& t) 
 	{ 
 	solo();
-	ApproxReal r(t.unique_Real());
-	if(p->has_itensor(r))
+	long key = p->sector_key(t);
+	if(p->has_itensor(key))
 	    {
-	    Print(*(p->rmap[r])); Print(t);
+	    Print(p->get_itensor(key)); Print(t);
 	    Error("Can't insert ITensor with identical structure twice, use operator+=.");
 	    }
-	p->insert_itensor(r,t);
+	p->insert_itensor(key,t);
 	}
 
 IQTensor& IQTensor::
 operator+=(const ITensor& t) 
     { 
     solo();
-    ApproxReal r(t.unique_Real());
 
     if(t.scale().isRealZero()) { return *this; }
 
-    if(!p->has_itensor(r)) 
-        p->insert_itensor(r,t);
+    long key = p->sector_key(t);
+    if(!p->has_itensor(key)) 
+        p->insert_itensor(key,t);
     else 
-        *(p->rmap[r]) += t;
+        p->get_itensor(key) += t;
     return *this;
     }
 
@@ -376,15 +450,25 @@ operator()(const IQIndexVal& iv1, const IQIndexVal& iv2,
     boost::array<IQIndexVal,NMAX+1> iv 
         = {{ IQIndexVal::Null(), iv1, iv2, iv3, iv4, iv5, iv6, iv7, iv8 }};
 
-    Real ur = 0; 
     int nn = 0; 
-    while(GET(iv,nn+1).iqind != IQIndexVal::Null().iqind) 
-        ur += GET(iv,++nn).index().unique_Real(); 
+    while(GET(iv,nn+1).iqind != IQIndexVal::Null().iqind) ++nn;
     if(nn != r()) 
         Error("Wrong number of IQIndexVals provided");
-    ApproxReal r(ur);
 
-    if(!p->has_itensor(r))
+    long key = 0, stride = 1;
+    for(int j = 0; j < nn; ++j)
+        {
+        const IQIndex& I = p->iqindex_[j];
+        int pos = -1;
+        for(int a = 1; a <= nn && pos == -1; ++a)
+            if(iv[a].iqind == I) pos = I.sector(iv[a].index());
+        if(pos == -1) 
+            Error("IQTensor::operator(): IQIndex not found.");
+        key += pos*stride;
+        stride *= I.nindex();
+        }
+
+    if(!p->has_itensor(key))
         {
         std::vector<Index> indices; 
         indices.reserve(nn);
@@ -395,9 +479,9 @@ operator()(const IQIndexVal& iv1, const IQIndexVal& iv2,
             indices.push_back(iv[j].index());
             }
         ITensor t(indices);
-        p->insert_itensor(r,t);
+        p->take_itensor(key,t);
         }
-    return (p->rmap[r])->operator()(iv1.toIndexVal(),
+    return p->get_itensor(key).operator()(iv1.toIndexVal(),
                                     iv2.toIndexVal(),
                                     iv3.toIndexVal(),
                                     iv4.toIndexVal(),
@@ -476,7 +560,6 @@ void IQTensor::
 ind_inc_prime(const IQIndex& i,int inc)
 	{
 	solo();
-	p->uninit_rmap();
 	bool gotit = false;
     for(iqind_it jj = p->iqindex_.begin(); jj != p->iqindex_.end(); ++jj)
 	    if(jj->noprime_equals(i))
@@ -506,10 +589,8 @@ void IQTensor::
 noprime(PrimeType pt)
 	{
 	solo();
-	p->uninit_rmap();
     for(iqind_it jj = p->iqindex_.begin(); jj != p->iqindex_.end(); ++jj)
         { jj->noprime(pt); }
-	for(iten_it jj = p->itensor.begin(); jj != p->itensor.end(); ++jj)
     for(iten_it it = p->itensor.begin(); it != p->itensor.end(); ++it)
         { it->noprime(pt); }
 	} 
@@ -518,13 +599,11 @@ void IQTensor::
 noprimelink()
 	{
 	solo();
-	p->uninit_rmap();
     for(iqind_it jj = p->iqindex_.begin(); jj != p->iqindex_.end(); ++jj)
         {
 	    if(jj->type() == Link) 
 		jj->noprime();
         }
-	for(iten_it jj = p->itensor.begin(); jj != p->itensor.end(); ++jj)
     for(iten_it it = p->itensor.begin(); it != p->itensor.end(); ++it)
         { it->noprime(primeLink); }
 	}
@@ -533,7 +612,6 @@ void IQTensor::
 doprime(PrimeType pt, int inc)
 	{
 	solo();
-	p->uninit_rmap();
 
 	DoPrimer prim(pt,inc);
 	for_each(p->iqindex_.begin(), p->iqindex_.end(),prim);
@@ -546,7 +624,6 @@ void IQTensor::
 mapprime(int plevold, int plevnew, PrimeType pt)
     {
     solo();
-    p->uninit_rmap();
 
 	MapPrimer prim(plevold,plevnew,pt);
 	for_each(p->iqindex_.begin(), p->iqindex_.end(),prim);
@@ -559,7 +636,6 @@ void IQTensor::
 primeind(const IQIndex& I)
 	{
 	solo();
-	p->uninit_rmap();
     for(iqind_it jj = p->iqindex_.begin(); jj != p->iqindex_.end(); ++jj)
         {
 	    if(*jj == I) 
@@ -582,7 +658,6 @@ void IQTensor::
 noprimeind(const IQIndex& I)
 	{
 	solo();
-	p->uninit_rmap();
     for(iqind_it jj = p->iqindex_.begin(); jj != p->iqindex_.end(); ++jj)
         {
 	    if(*jj == I) 
@@ -805,20 +880,17 @@ printIQInds(const std::string& name) const
 void IQTensor::
 assignFrom(const IQTensor& other) const
 	{
-	std::map<ApproxReal,iten_it> semap;
-	for(iten_it i = p->itensor.begin(); i != p->itensor.end(); ++i)
-	    semap[ApproxReal(i->unique_Real())] = i;
 	for(const_iten_it i = other.p->itensor.begin(); i != other.p->itensor.end(); ++i)
 	    {
-	    ApproxReal se = ApproxReal(i->unique_Real());
-	    if(semap.count(se) == 0)
+	    long key = p->sector_key(*i);
+	    if(!p->has_itensor(key))
 		{
-		std::cout << "warning assignFrom semap.count is 0" << std::endl;
+		std::cout << "warning assignFrom: block not found" << std::endl;
 		std::cerr << "offending ITensor is " << *i << "\n";
 		Error("bad assignFrom count se");
 		}
 	    else 
-		semap[se]->assignFrom(*i);
+		p->get_itensor(key).assignFrom(*i);
 	    }
 	}
 
@@ -833,14 +905,12 @@ conj()
         }
     else
         {
-        IQTensor r,i;
-        SplitReIm(r,i);
-        for(iqind_it jj = r.p->iqindex_.begin(); jj != r.p->iqindex_.end(); ++jj)
-            { jj->conj(); }
-        for(iqind_it jj = i.p->iqindex_.begin(); jj != i.p->iqindex_.end(); ++jj)
-            { jj->conj(); }
-        i *= -1.0;
-        *this = r * IQTensor::Complex_1() + IQTensor::Complex_i() * i;
+        //Reverse the arrows and negate the imaginary 
+        //part of each block in place
+        for(iqind_it jj = p->iqindex_.begin(); jj != p->iqindex_.end(); ++jj)
+            { if(*jj != IQIndex::IndReIm()) jj->conj(); }
+        for(iten_it it = p->itensor.begin(); it != p->itensor.end(); ++it)
+            { it->conj(); }
         }
     }
 
@@ -858,7 +928,7 @@ operator<<(std::ostream & s, const IQTensor &t)
         jj = t.p->iqindex_.begin(); jj != t.p->iqindex_.end(); ++jj)
         { s << "  " << *jj << std::endl; }
     s << "ITensors:\n";
-    for(std::list<ITensor>::const_iterator
+    for(IQTensor::const_iten_it
         it = t.p->itensor.begin(); it != t.p->itensor.end(); ++it)
         { s << "  " << *it << std::endl; }
     s << "-------------------" << "\n\n";
@@ -890,6 +960,195 @@ SplitReIm(IQTensor& re, IQTensor& im) const
 	}
 }
 
+//
+// One product of a block of each IQTensor, with the
+// estimated number of multiply-adds it requires
+//
+struct BlockTask
+    {
+    const ITensor* L;
+    const ITensor* R;
+    Real cost;
+    };
+
+//Splits n items with costs cost(n) into consecutive ranges
+//[start[c],start[c+1]) each holding at least mincost work, so
+//that tiny items are handled together instead of one at a time
+static void
+makeChunks(const vector<Real>& cost, Real mincost, vector<int>& start)
+    {
+    const int n = cost.size();
+    start.clear();
+    start.push_back(0);
+    Real acc = 0;
+    for(int j = 0; j < n; ++j)
+        {
+        acc += cost[j];
+        if(acc >= mincost && j+1 < n) { start.push_back(j+1); acc = 0; }
+        }
+    start.push_back(n);
+    }
+
+//
+// Computes the block products in tasks and sums them into d.
+//
+// Products are computed in parallel (when built with OpenMP),
+// then the products belonging to each output block are summed
+// in task order and the blocks inserted in the order the serial
+// loop would have created them, so the result does not depend
+// on the number of threads.
+//
+static void
+contractBlocks(const vector<BlockTask>& tasks, IQTDat& d)
+    {
+    const int ntask = tasks.size();
+    const Real mincost = Globals::minBlockTaskSize();
+
+    vector<Real> cost(ntask);
+    for(int n = 0; n < ntask; ++n) cost[n] = tasks[n].cost;
+    vector<int> start;
+    makeChunks(cost,mincost,start);
+    const int nchunk = start.size()-1;
+
+    vector<ITensor> prod(ntask);
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic) if(nchunk > 1)
+#endif
+    for(int c = 0; c < nchunk; ++c)
+    for(int n = start[c]; n < start[c+1]; ++n)
+        {
+        prod[n] = *(tasks[n].L);
+        prod[n] *= *(tasks[n].R);
+        }
+
+    //Group the nonzero products by output block,
+    //in order of each block's first appearance
+    vector<vector<int> > group;
+    vector<long> gkey;
+    boost::unordered_map<long,int> gnum;
+    for(int n = 0; n < ntask; ++n)
+        {
+        if(prod[n].scale().isRealZero()) continue;
+        const long key = d.sector_key(prod[n]);
+        boost::unordered_map<long,int>::iterator g = gnum.find(key);
+        if(g == gnum.end())
+            {
+            gnum[key] = group.size();
+            group.push_back(vector<int>(1,n));
+            gkey.push_back(key);
+            }
+        else group[g->second].push_back(n);
+        }
+
+    const int ngroup = group.size();
+    vector<Real> gcost(ngroup);
+    for(int g = 0; g < ngroup; ++g)
+        gcost[g] = Real(prod[group[g].front()].vec_size())*group[g].size();
+    makeChunks(gcost,mincost,start);
+    const int ngchunk = start.size()-1;
+
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic) if(ngchunk > 1)
+#endif
+    for(int c = 0; c < ngchunk; ++c)
+    for(int g = start[c]; g < start[c+1]; ++g)
+        {
+        if(group[g].size() == 1) continue;
+        ITensorSum S(prod[group[g].front()]);
+        for(size_t j = 1; j < group[g].size(); ++j)
+            S += prod[group[g][j]];
+        S.eval(prod[group[g].front()]);
+        }
+
+    d.itensor.reserve(d.itensor.size()+ngroup);
+    for(int g = 0; g < ngroup; ++g)
+        {
+        d.take_itensor(gkey[g],prod[group[g].front()]);
+        }
+    }
+
+//
+// A block of an IQTensor keyed by its sectors of the
+// IQIndex's shared with another IQTensor
+//
+struct SectorKey
+    {
+    long key;
+    int block;
+    Real cdim; //product of the dimensions of the shared sectors
+
+    bool
+    operator<(const SectorKey& o) const
+        { return key < o.key || (key == o.key && block < o.block); }
+    };
+
+//Computes the SectorKey of each block along the IQIndex's
+//I[inds[k]], returning them sorted by key
+static void
+commonSectorKeys(const vector<ITensor>& blocks, const vector<IQIndex>& I,
+                 const vector<int>& inds, vector<SectorKey>& keys)
+    {
+    keys.resize(blocks.size());
+    for(size_t n = 0; n < blocks.size(); ++n)
+        {
+        const ITensor& t = blocks[n];
+        SectorKey& k = keys[n];
+        k.key = 0;
+        k.block = n;
+        k.cdim = 1;
+        long stride = 1;
+        for(size_t c = 0; c < inds.size(); ++c)
+            {
+            const IQIndex& J = I[inds[c]];
+            int pos = -1;
+            for(int a = 1; a <= t.r() && pos == -1; ++a)
+                pos = J.sector(t.index(a));
+            if(pos == -1)
+                {
+                Print(t); Print(J);
+                Error("commonSectorKeys: block Index not found in IQIndex");
+                }
+            k.key += pos*stride;
+            k.cdim *= J.iq()[pos].index.m();
+            stride *= J.nindex();
+            }
+        }
+    sort(keys.begin(),keys.end());
+    }
+
+//Pairs (l,r) of positions in lkeys and rkeys having equal keys,
+//ordered by key, then by l, then by r
+static void
+matchBlocks(const vector<SectorKey>& lkeys, const vector<SectorKey>& rkeys,
+            vector<pair<int,int> >& match)
+    {
+    match.clear();
+    const int nl = lkeys.size(), nr = rkeys.size();
+    int l = 0, r = 0;
+    while(l < nl && r < nr)
+        {
+        const long key = lkeys[l].key;
+        if(key < rkeys[r].key) { ++l; continue; }
+        if(rkeys[r].key < key) { ++r; continue; }
+        int le = l, re = r;
+        while(le < nl && lkeys[le].key == key) ++le;
+        while(re < nr && rkeys[re].key == key) ++re;
+        for(int i = l; i < le; ++i)
+        for(int j = r; j < re; ++j)
+            match.push_back(make_pair(i,j));
+        l = le;
+        r = re;
+        }
+    }
+
+//Returns T with block t added in
+static IQTensor
+withBlock(IQTensor T, const ITensor& t)
+    {
+    T += t;
+    return handover(T);
+    }
+
 IQTensor& IQTensor::
 operator*=(const IQTensor& other)
 {
@@ -908,36 +1167,24 @@ operator*=(const IQTensor& other)
     if(hasindex(IQIndex::IndReIm()) && other.hasindex(IQIndex::IndReIm()) && !other.hasindex(IQIndex::IndReImP())
 	    && !other.hasindex(IQIndex::IndReImPP()) && !hasindex(IQIndex::IndReImP()) && !hasindex(IQIndex::IndReImPP()))
         {
-        static ITensor primer(Index::IndReIm(),Index::IndReImP(),1.0);
-        static ITensor primerP(Index::IndReIm(),Index::IndReImPP(),1.0);
-        static ITensor prod(Index::IndReIm(),Index::IndReImP(),Index::IndReImPP());
-        static IQTensor iqprimer(IQIndex::IndReIm(),IQIndex::IndReImP());
-        static IQTensor iqprimerP(IQIndex::IndReIm(),IQIndex::IndReImPP());
-        static IQTensor iqprod(IQIndex::IndReIm(),IQIndex::IndReImP(),IQIndex::IndReImPP());
-        static int first = 1;
-        if(first)
-            {
-            IndexVal iv0(Index::IndReIm(),1), iv1(Index::IndReImP(),1), iv2(Index::IndReImPP(),1);
-            iv0.i = 1; iv1.i = 1; iv2.i = 1; prod(iv0,iv1,iv2) = 1.0;
-            iv0.i = 1; iv1.i = 2; iv2.i = 2; prod(iv0,iv1,iv2) = -1.0;
-            iv0.i = 2; iv1.i = 2; iv2.i = 1; prod(iv0,iv1,iv2) = 1.0;
-            iv0.i = 2; iv1.i = 1; iv2.i = 2; prod(iv0,iv1,iv2) = 1.0;
-            first = 0;
-            iqprimer += primer;
-            iqprimerP += primerP;
-            iqprod += prod;
-            }
+        static const IQTensor iqprimer(withBlock(IQTensor(IQIndex::IndReIm(),IQIndex::IndReImP()),
+                                                 ITensor::ReImPrimer()));
+        static const IQTensor iqprimerP(withBlock(IQTensor(IQIndex::IndReIm(),IQIndex::IndReImPP()),
+                                                  ITensor::ReImPrimerP()));
+        static const IQTensor iqprod(withBlock(IQTensor(IQIndex::IndReIm(),IQIndex::IndReImP(),IQIndex::IndReImPP()),
+                                               ITensor::ComplexProd()));
         return *this = (*this * iqprimer) * iqprod * (other * iqprimerP);
         }
 
     solo();
     p->uninit_rmap();
 
-    set<ApproxReal> common_inds;
-    
-    //Load iqindex_ with those IQIndex's *not* common to *this and other
-    static vector<IQIndex> riqind_holder(1000);
-    riqind_holder.resize(0);
+    //Load iqindex_ with those IQIndex's *not* common to *this and other,
+    //recording the positions of the common ones
+    vector<int> cthis, cother;
+    vector<bool> ocommon(other.p->iqindex_.size(),false);
+    vector<IQIndex> riqind_holder;
+    riqind_holder.reserve(p->iqindex_.size()+other.p->iqindex_.size());
 
     for(size_t i = 0; i < p->iqindex_.size(); ++i)
         {
@@ -955,74 +1202,41 @@ operator*=(const IQTensor& other)
                     cerr << "IQIndex from other = " << *f << endl;
                     Error("Incompatible arrow directions in IQTensor::operator*=.");
                     }
-            for(size_t n = 0; n < I.iq().size(); ++n) 
-                { common_inds.insert(ApproxReal(I.iq()[n].index.unique_Real())); }
-
-            common_inds.insert(ApproxReal(I.unique_Real()));
+            cthis.push_back(i);
+            cother.push_back(f - other.p->iqindex_.begin());
+            ocommon[cother.back()] = true;
             }
         else { riqind_holder.push_back(I); }
         }
 
     for(size_t i = 0; i < other.p->iqindex_.size(); ++i)
-    if(!common_inds.count(ApproxReal(other.p->iqindex_[i].unique_Real())))
+    if(!ocommon[i])
         { riqind_holder.push_back(other.p->iqindex_[i]); }
 
-    if(riqind_holder.size() > 1000) cerr << "\nWARNING: in IQTensor::operator*=, riqind_holder had to reallocate.\n\n";
-    p->iqindex_.swap(riqind_holder);
-
-    set<ApproxReal> keys;
+    //Key each block by its sectors of the common IQIndex's
+    vector<SectorKey> lkeys, rkeys;
+    commonSectorKeys(p->itensor,p->iqindex_,cthis,lkeys);
+    commonSectorKeys(other.p->itensor,other.p->iqindex_,cother,rkeys);
 
-    list<ITensor> old_itensor; p->itensor.swap(old_itensor);
+    p->iqindex_.swap(riqind_holder);
+    vector<ITensor> old_itensor; p->itensor.swap(old_itensor);
 
-    //com_this maps the unique_Real of a set of Index's to be contracted over together
-    //to those ITensors in *this.itensor having all Index's in that set
-    multimap<ApproxReal,const_iten_it> com_this;
-    for(const_iten_it tt = old_itensor.begin(); tt != old_itensor.end(); ++tt)
-        {
-        Real r = 0.0;
-        for(int a = 1; a <= tt->r(); ++a)
-            {
-            if(common_inds.count(ApproxReal(tt->index(a).unique_Real())))
-                { r += tt->index(a).unique_Real(); }
-            }
-        com_this.insert(make_pair(ApproxReal(r),tt));
-        keys.insert(ApproxReal(r));
-        }
+    //Every pair of blocks of *this and other with
+    //matching common sectors gives one block product
+    vector<pair<int,int> > match;
+    matchBlocks(lkeys,rkeys,match);
 
-    //com_other is the same as com_this but for other
-    multimap<ApproxReal,const_iten_it> com_other;
-    for(const_iten_it ot = other.const_iten_begin(); ot != other.const_iten_end(); ++ot)
+    vector<BlockTask> tasks(match.size());
+    for(size_t n = 0; n < match.size(); ++n)
         {
-        Real r = 0.0;
-        for(int b = 1; b <= ot->r(); ++b)
-            {
-            if(common_inds.count(ApproxReal(ot->index(b).unique_Real())))
-                { r += ot->index(b).unique_Real(); }
-            }
-        com_other.insert(make_pair(ApproxReal(r),ot));
-        keys.insert(ApproxReal(r));
+        const SectorKey& lk = lkeys[match[n].first];
+        BlockTask& t = tasks[n];
+        t.L = &(old_itensor[lk.block]);
+        t.R = &(other.p->itensor[rkeys[match[n].second].block]);
+        t.cost = Real(t.L->vec_size())*t.R->vec_size()/lk.cdim;
         }
 
-    typedef multimap<ApproxReal,const_iten_it>::iterator mit;
-    pair<mit,mit> lrange,rrange;
-    ITensor tt;
-    for(set<ApproxReal>::iterator k = keys.begin(); k != keys.end(); ++k)
-        {
-        //Equal range returns the begin and end iterators for the sequence
-        //corresponding to multimap[key] as a pair
-        lrange = com_this.equal_range(*k);
-        rrange = com_other.equal_range(*k);
-
-        //Iterate over all ITensors in *this and other sharing
-        //the set of contracted Index's corresponding to k
-        for(mit ll = lrange.first; ll != lrange.second; ++ll)
-        for(mit rr = rrange.first; rr != rrange.second; ++rr)
-            {
-            //Multiply the ITensors and add into res
-            tt = *(ll->second); tt *= *(rr->second);
-            operator+=(tt);
-            }
-        }
+    contractBlocks(tasks,*p);
 
     return *this;
 
@@ -1052,10 +1266,10 @@ operator/=(const IQTensor& other)
     solo();
     p->uninit_rmap();
 
-    set<ApproxReal> common_inds;
-    
-    static vector<IQIndex> riqind_holder(1000);
-    riqind_holder.resize(0);
+    vector<int> cthis, cother;
+    vector<bool> ocommon(other.p->iqindex_.size(),false);
+    vector<IQIndex> riqind_holder;
+    riqind_holder.reserve(p->iqindex_.size()+other.p->iqindex_.size());
 
     for(size_t i = 0; i < p->iqindex_.size(); ++i)
         {
@@ -1073,75 +1287,36 @@ operator/=(const IQTensor& other)
                     cerr << "IQIndex from other = " << *f << endl;
                     Error("Incompatible arrow directions in IQTensor::operator/=.");
                     }
-            for(size_t n = 0; n < I.iq().size(); ++n) 
-                { common_inds.insert(ApproxReal(I.iq()[n].index.unique_Real())); }
-
-            common_inds.insert(ApproxReal(I.unique_Real()));
+            cthis.push_back(i);
+            cother.push_back(f - other.p->iqindex_.begin());
+            ocommon[cother.back()] = true;
             }
         riqind_holder.push_back(I);
         }
 
     for(size_t i = 0; i < other.p->iqindex_.size(); ++i)
-    if(!common_inds.count(ApproxReal(other.p->iqindex_[i].unique_Real())))
+    if(!ocommon[i])
         { riqind_holder.push_back(other.p->iqindex_[i]); }
 
-    if(riqind_holder.size() > 1000) cerr << "\nWARNING: in IQTensor::operator/=, riqind_holder had to reallocate.\n\n";
-    p->iqindex_.swap(riqind_holder);
-
-    set<ApproxReal> keys;
+    //Key each block by its sectors of the common IQIndex's
+    vector<SectorKey> lkeys, rkeys;
+    commonSectorKeys(p->itensor,p->iqindex_,cthis,lkeys);
+    commonSectorKeys(other.p->itensor,other.p->iqindex_,cother,rkeys);
 
-    list<ITensor> old_itensor; p->itensor.swap(old_itensor);
-
-    //com_this maps the unique_Real of a set of Index's to be summed over together
-    //to those ITensors in *this.itensor having all Index's in that set
-    multimap<ApproxReal,const_iten_it> com_this;
-    for(const_iten_it tt = old_itensor.begin(); tt != old_itensor.end(); ++tt)
-        {
-        Real r = 0.0;
-        for(int a = 1; a <= tt->r(); ++a)
-            {
-            Real ur = tt->index(a).unique_Real();
-            if(common_inds.count(ApproxReal(ur)))
-                r += ur;
-            }
-        com_this.insert(make_pair(ApproxReal(r),tt));
-        keys.insert(ApproxReal(r));
-        }
+    p->iqindex_.swap(riqind_holder);
+    vector<ITensor> old_itensor; p->itensor.swap(old_itensor);
 
-    //com_other is the same as com_this but for other
-    multimap<ApproxReal,const_iten_it> com_other;
-    for(const_iten_it ot = other.const_iten_begin(); ot != other.const_iten_end(); ++ot)
-        {
-        Real r = 0.0;
-        for(int b = 1; b <= ot->r(); ++b)
-            {
-            Real ur = ot->index(b).unique_Real();
-            if(common_inds.count(ApproxReal(ur)))
-                r += ur;
-            }
-        com_other.insert(make_pair(ApproxReal(r),ot));
-        keys.insert(ApproxReal(r));
-        }
+    //Multiply every pair of blocks sharing
+    //the same common sectors and add into res
+    vector<pair<int,int> > match;
+    matchBlocks(lkeys,rkeys,match);
 
-    typedef multimap<ApproxReal,const_iten_it>::iterator mit;
-    pair<mit,mit> lrange,rrange;
     ITensor tt;
-    for(set<ApproxReal>::iterator k = keys.begin(); k != keys.end(); ++k)
+    for(size_t n = 0; n < match.size(); ++n)
         {
-        //Equal range returns the begin and end iterators for the sequence
-        //corresponding to multimap[key] as a pair
-        lrange = com_this.equal_range(*k);
-        rrange = com_other.equal_range(*k);
-
-        //Iterate over all ITensors in *this and other sharing
-        //the set of contracted Index's corresponding to k
-        for(mit ll = lrange.first; ll != lrange.second; ++ll)
-        for(mit rr = rrange.first; rr != rrange.second; ++rr)
-            {
-            //Multiply the ITensors and add into res
-            tt = *(ll->second); tt /= *(rr->second);
-            operator+=(tt);
-            }
+        tt = old_itensor[lkeys[match[n].first].block];
+        tt /= other.p->itensor[rkeys[match[n].second].block];
+        operator+=(tt);
         }
 
     return *this;
@@ -1204,7 +1379,7 @@ GetSingComplex(Real& re, Real& im) const
 IQTensor& IQTensor::
 operator+=(const IQTensor& other)
 {
-    solo(); p->uninit_rmap();
+    solo();
     if(this == &other) {
         for(iten_it it = p->itensor.begin(); it != p->itensor.end(); ++it)
             { *it *= 2; return *this; }
@@ -1225,11 +1400,94 @@ operator+=(const IQTensor& other)
         cout << "other is " << other;
         Error("bad match unique real in IQTensor::operator+=");
 	}
-    for(const_iten_it it = other.p->itensor.begin(); it != other.p->itensor.end(); ++it)
-        { operator+=(*it); }
+    //Tensors made by the same sequence of operations usually
+    //list matching blocks at the same positions: add those 
+    //directly and look up the rest by sector
+    const size_t nthis = p->itensor.size();
+    size_t n = 0;
+    for(const_iten_it it = other.p->itensor.begin(); it != other.p->itensor.end(); ++it, ++n)
+        { 
+        if(n < nthis && p->sector_key(p->itensor[n]) == p->sector_key(*it))
+            p->itensor[n] += *it;
+        else
+            operator+=(*it); 
+        }
     return *this;
 }
 
+void
+sum(const std::vector<IQTensor>& terms, IQTensor& res)
+    {
+    vector<const IQTensor*> t;
+    for(size_t k = 0; k < terms.size(); ++k)
+        if(terms[k].p != 0 && terms[k].p->iqindex_.size() != 0) 
+            t.push_back(&terms[k]);
+    if(t.empty()) { res = IQTensor(); return; }
+
+    //Mixed real and complex terms, or terms with other 
+    //IQIndex's, are left to operator+= 
+    const IQTensor& F = *(t.front());
+    const bool complex = F.hasindex(IQIndex::IndReIm());
+    bool direct = true;
+    for(size_t k = 1; k < t.size() && direct; ++k)
+        {
+        direct = (t[k]->hasindex(IQIndex::IndReIm()) == complex
+                  && t[k]->p->iqindex_.size() == F.p->iqindex_.size());
+        for(size_t j = 0; j < F.p->iqindex_.size() && direct; ++j)
+            direct = t[k]->hasindex(F.p->iqindex_[j]);
+        }
+    if(!direct)
+        {
+        IQTensor R(F);
+        for(size_t k = 1; k < t.size(); ++k) R += *(t[k]);
+        res.swap(R);
+        return;
+        }
+
+    IQTensor R;
+    R.p = new IQTDat();
+    R.p->iqindex_ = F.p->iqindex_;
+
+    //Group the nonzero blocks of all terms by sector,
+    //in order of each sector's first appearance
+    vector<vector<const ITensor*> > group;
+    vector<long> gkey;
+    boost::unordered_map<long,int> gnum;
+    for(size_t k = 0; k < t.size(); ++k)
+    for(IQTensor::const_iten_it it = t[k]->p->itensor.begin(); 
+        it != t[k]->p->itensor.end(); ++it)
+        {
+        if(it->scale().isRealZero()) continue;
+        const long key = R.p->sector_key(*it);
+        boost::unordered_map<long,int>::iterator g = gnum.find(key);
+        if(g == gnum.end())
+            {
+            gnum[key] = group.size();
+            group.push_back(vector<const ITensor*>(1,&(*it)));
+            gkey.push_back(key);
+            }
+        else group[g->second].push_back(&(*it));
+        }
+
+    R.p->itensor.reserve(group.size());
+    for(size_t g = 0; g < group.size(); ++g)
+        {
+        ITensor b;
+        if(group[g].size() == 1) 
+            {
+            b = *(group[g].front());
+            }
+        else
+            {
+            ITensorSum S(*(group[g].front()));
+            for(size_t j = 1; j < group[g].size(); ++j) S += *(group[g][j]);
+            S.eval(b);
+            }
+        R.p->take_itensor(gkey[g],b);
+        }
+    res.swap(R);
+    }
+
 IQTensor::
 operator ITensor() const
     {
@@ -1296,6 +1554,40 @@ ReSingVal(const IQTensor& x)
 Real 
 Dot(const IQTensor& x, const IQTensor& y, bool doconj)
     {
+    //Real tensors with the same IQIndex's: sum the
+    //Dot's of matching blocks
+    if(!x.is_null() && !y.is_null() && x.r() == y.r() && x.r() > 0
+       && !x.is_complex() && !y.is_complex())
+        {
+        bool same = true;
+        for(int j = 1; j <= x.r() && same; ++j)
+            same = y.hasindex(x.index(j));
+        if(same)
+            {
+            const std::vector<ITensor>& xb = x.p->itensor;
+            const std::vector<ITensor>& yb = y.p->itensor;
+            Real res = 0;
+            for(size_t n = 0; n < xb.size(); ++n)
+                {
+                //Matching blocks are often at the same position
+                const long key = y.p->sector_key(xb[n]);
+                if(n < yb.size() && y.p->sector_key(yb[n]) == key)
+                    {
+                    res += Dot(xb[n],yb[n],doconj);
+                    continue;
+                    }
+                if(y.p->has_itensor(key)) 
+                    res += Dot(xb[n],y.p->get_itensor(key),doconj);
+                }
+            return res;
+            }
+        }
+    if(!x.is_null() && !y.is_null() && x.is_complex() && y.is_complex())
+        {
+        Real re, im;
+        Dot(x,y,re,im,doconj);
+        return re;
+        }
     IQTensor res(IQTensor::Sing()*(doconj ? conj(x) : x)*y);
     return ReSingVal(res);
     }
@@ -1303,6 +1595,38 @@ Dot(const IQTensor& x, const IQTensor& y, bool doconj)
 void 
 Dot(const IQTensor& x, const IQTensor& y, Real& re, Real& im, bool doconj)
     {
+    //Tensors with the same IQIndex's, both real or both complex:
+    //sum the Dot's of matching blocks
+    if(!x.is_null() && !y.is_null() && x.r() == y.r() && x.r() > 0
+       && x.is_complex() == y.is_complex())
+        {
+        bool same = true;
+        for(int j = 1; j <= x.r() && same; ++j)
+            same = y.hasindex(x.index(j));
+        if(same)
+            {
+            const std::vector<ITensor>& xb = x.p->itensor;
+            const std::vector<ITensor>& yb = y.p->itensor;
+            re = im = 0;
+            Real bre, bim;
+            for(size_t n = 0; n < xb.size(); ++n)
+                {
+                const long key = y.p->sector_key(xb[n]);
+                if(n < yb.size() && y.p->sector_key(yb[n]) == key)
+                    {
+                    Dot(xb[n],yb[n],bre,bim,doconj);
+                    re += bre; im += bim;
+                    continue;
+                    }
+                if(y.p->has_itensor(key)) 
+                    {
+                    Dot(xb[n],y.p->get_itensor(key),bre,bim,doconj);
+                    re += bre; im += bim;
+                    }
+                }
+            return;
+            }
+        }
     IQTensor res(IQTensor::Sing()*(doconj ? conj(x) : x)*y);
     res.GetSingComplex(re,im);
     }
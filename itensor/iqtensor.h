@@ -2,7 +2,6 @@
 #define __IQ_H
 #include "itensor.h"
 #include "iqindex.h"
-#include <list>
 #include <map>
 
 class IQTDat;
@@ -13,10 +12,10 @@ class IQTensor
 {
 public:
 
-    typedef std::list<ITensor>::iterator 
+    typedef std::vector<ITensor>::iterator 
     iten_it;
 
-    typedef std::list<ITensor>::const_iterator 
+    typedef std::vector<ITensor>::const_iterator 
     const_iten_it;
 
     typedef std::vector<IQIndex>::iterator 
@@ -149,7 +148,7 @@ public:
     //
     IQTensor 
     operator*(IQTensor other) const 
-        { other *= *this; return other; }
+        { other *= *this; return handover(other); }
 
     IQTensor& 
     operator*=(const IQTensor& other);
@@ -159,7 +158,7 @@ public:
     //
     IQTensor 
     operator/(IQTensor other) const 
-        { other /= *this; return other; }
+        { other /= *this; return handover(other); }
 
     IQTensor& 
     operator/=(const IQTensor& other);
@@ -184,13 +183,17 @@ public:
     IQTensor& 
     operator*=(Real fac);
 
+    //Multiplies the scale of each block by fac, kept a LogNumber
+    IQTensor& 
+    operator*=(const LogNumber& fac);
+
     IQTensor 
     operator*(Real fac) const
         { IQTensor res(*this); res *= fac; return res; }
 
     friend inline IQTensor 
     operator*(Real fac, IQTensor T) 
-        { T *= fac; return T; }
+        { T *= fac; return handover(T); }
 
     //
     // Multiplication by an ITensor
@@ -266,7 +269,7 @@ public:
     void noprime(PrimeType pt = primeBoth);
 
     friend inline IQTensor 
-    deprimed(IQTensor A) { A.noprime(); return A; }
+    deprimed(IQTensor A) { A.noprime(); return handover(A); }
 
     void 
     noprimelink();
@@ -283,30 +286,29 @@ public:
 
     friend inline IQTensor 
     primeind(IQTensor A, const IQIndex& I)
-        { A.primeind(I); return A; }
+        { A.primeind(I); return handover(A); }
 
     friend inline IQTensor 
     primeind(IQTensor A, const IQIndex& I, const IQIndex& J)
-        { A.primeind(I); A.primeind(J); return A; }
+        { A.primeind(I); A.primeind(J); return handover(A); }
 
     void 
     noprimeind(const IQIndex& I);
 
     friend inline IQTensor 
-    primed(IQTensor A) { A.doprime(primeBoth); return A; }
+    primed(IQTensor A) { A.doprime(primeBoth); return handover(A); }
 
     void 
     primesite() { doprime(primeSite); }
 
     friend inline IQTensor 
-    primesite(IQTensor A) { A.doprime(primeSite); return A; }
+    primesite(IQTensor A) { A.doprime(primeSite); return handover(A); }
 
     void 
     primelink() { doprime(primeLink); }
 
     friend inline IQTensor 
-    primelink(const IQTensor& A)
-        { IQTensor res(A); res.doprime(primeLink); return res; }
+    primelink(IQTensor A) { A.doprime(primeLink); return handover(A); }
 
 
     //----------------------------------------------------
@@ -362,7 +364,7 @@ public:
     void 
     scaleTo(LogNumber newscale) const;
 
-    inline void 
+    void 
     clean(Real min_norm = MIN_CUT);
 
     int 
@@ -398,6 +400,11 @@ public:
     void 
     conj();
 
+    //Exchange contents with other without touching any 
+    //reference counts (see handover in types.h)
+    void
+    swap(IQTensor& other) { p.swap(other.p); }
+
     friend std::ostream& 
     operator<<(std::ostream & s, const IQTensor &t);
 
@@ -417,6 +424,13 @@ private:
 
     void solo();
 
+    friend Real Dot(const IQTensor& x, const IQTensor& y, bool doconj);
+
+    friend void Dot(const IQTensor& x, const IQTensor& y, Real& re, Real& im, 
+                    bool doconj);
+
+    friend void sum(const std::vector<IQTensor>& terms, IQTensor& res);
+
 }; //class IQTensor
 
 class IQTDat
@@ -460,11 +474,23 @@ public:
     void 
     uninit_rmap() const;
 
+    //Integer key of block t: the position of each of t's Index's
+    //within the corresponding IQIndex, as a mixed-radix number
+    long
+    sector_key(const ITensor& t) const;
+
     bool 
-    has_itensor(const ApproxReal& r) const;
+    has_itensor(long key) const;
 
+    ITensor&
+    get_itensor(long key) const;
+
+    void 
+    insert_itensor(long key, const ITensor& t);
+
+    //As insert_itensor, but swaps t in, leaving t empty
     void 
-    insert_itensor(const ApproxReal& r, const ITensor& t);
+    take_itensor(long key, ITensor& t);
 
     void 
     clean(Real min_norm);
@@ -479,10 +505,10 @@ public:
         throw()
         { return allocator.dealloc(p); }
 
-    typedef std::list<ITensor>::iterator 
+    typedef std::vector<ITensor>::iterator 
     iten_it;
 
-    typedef std::list<ITensor>::const_iterator 
+    typedef std::vector<ITensor>::const_iterator 
     const_iten_it;
 
     typedef std::vector<IQIndex>::iterator 
@@ -493,13 +519,16 @@ public:
 
 public:
 
-    mutable std::list<ITensor> 
+    mutable std::vector<ITensor> 
     itensor; // This is mutable to allow reordering
 
     std::vector<IQIndex> 
     iqindex_;
 
-    mutable std::map<ApproxReal,iten_it>
+    //Maps the sector_key of each block to its position in itensor.
+    //Keys are positions within the IQIndex's, which relabeling
+    //(priming, conj) does not change, so it survives those
+    mutable boost::unordered_map<long,int>
     rmap; //mutable so that const IQTensor methods can use rmap
 
     ENABLE_INTRUSIVE_PTR(IQTDat)
@@ -516,15 +545,29 @@ private:
     mutable unsigned int 
     numref;
 
-    mutable bool 
+    mutable volatile bool 
     rmap_init;
 
+    mutable volatile int
+    rmap_lock; //held while rmap is filled
+
 }; //class IQTDat
 
 
 Real 
 ReSingVal(const IQTensor& x);
 
+inline void 
+swap(IQTensor& A, IQTensor& B) { A.swap(B); }
+
+inline IQTensor 
+conj(IQTensor T) { T.conj(); return handover(T); }
+
+//Sums terms into res (which may be one of them), summing
+//the matching blocks of all terms at once (see ITensorSum)
+void 
+sum(const std::vector<IQTensor>& terms, IQTensor& res);
+
 Real 
 Dot(const IQTensor& x, const IQTensor& y, bool doconj = true);
 
@@ -1,4 +1,5 @@
 #include "itensor.h"
+#include <map>
 using std::vector;
 using std::ostream;
 using std::cout;
@@ -333,6 +334,39 @@ ITensor(ITmaker itm)
     set_unique_Real();
 	}
 
+const ITensor& ITensor::
+ReImPrimer()
+    {
+    static const ITensor primer_(Index::IndReIm(),Index::IndReImP(),1.0);
+    return primer_;
+    }
+
+const ITensor& ITensor::
+ReImPrimerP()
+    {
+    static const ITensor primerP_(Index::IndReIm(),Index::IndReImPP(),1.0);
+    return primerP_;
+    }
+
+static ITensor
+makeComplexProd()
+    {
+    ITensor prod(Index::IndReIm(),Index::IndReImP(),Index::IndReImPP());
+    IndexVal iv0(Index::IndReIm(),1), iv1(Index::IndReImP(),1), iv2(Index::IndReImPP(),1);
+    iv0.i = 1; iv1.i = 1; iv2.i = 1; prod(iv0,iv1,iv2) = 1.0;
+    iv0.i = 1; iv1.i = 2; iv2.i = 2; prod(iv0,iv1,iv2) = -1.0;
+    iv0.i = 2; iv1.i = 2; iv2.i = 1; prod(iv0,iv1,iv2) = 1.0;
+    iv0.i = 2; iv1.i = 1; iv2.i = 2; prod(iv0,iv1,iv2) = 1.0;
+    return prod;
+    }
+
+const ITensor& ITensor::
+ComplexProd()
+    {
+    static const ITensor prod_(makeComplexProd());
+    return prod_;
+    }
+
 void ITensor::
 read(std::istream& s)
     { 
@@ -545,7 +579,18 @@ primeind(ITensor A, const Index& I1, const Index& I2)
     { 
     A.mapindex(I1,primed(I1));
     A.mapindex(I2,primed(I2));
-    return A; 
+    return handover(A); 
+    }
+
+void ITensor::
+swap(ITensor& other)
+    {
+    p.swap(other.p);
+    for(int j = 0; j <= NMAX; ++j) index_[j].swap(other.index_[j]);
+    std::swap(r_,other.r_);
+    std::swap(rn_,other.rn_);
+    std::swap(scale_,other.scale_);
+    std::swap(ur,other.ur);
     }
 
 Real ITensor::
@@ -1025,19 +1070,85 @@ Randomize()
     p->v.Randomize(); 
     }
 
+int ITensor::
+reImStride() const
+    {
+    int str = 1;
+    for(int j = 1; j <= rn_ && index_[j] != Index::IndReIm(); ++j)
+        str *= index_[j].m();
+    return str;
+    }
+
 void ITensor::
 SplitReIm(ITensor& re, ITensor& im) const
 	{
-	re = *this; im = *this;
-	if(!is_complex()) { im *= 0; return; }
-	//re *= Index::IndReIm()(1); im *= Index::IndReIm()(2);
-
-	re.mapindex(Index::IndReIm(),Index::IndReImP());
-	im.mapindex(Index::IndReIm(),Index::IndReImP());
-	re *= Index::IndReImP()(1);
-	im *= Index::IndReImP()(2);
+	if(!is_complex()) { re = *this; im = *this; im *= 0; return; }
+
+    //Copy out alternating runs of real and imaginary parts
+    //instead of contracting with ReIm IndexVals
+    std::vector<Index> I; I.reserve(r_);
+    for(int j = 1; j <= r_; ++j)
+        if(index_[j] != Index::IndReIm()) I.push_back(index_[j]);
+    const int str = reImStride();
+    const int n = p->v.Length()/2;
+    Vector vr(n), vi(n);
+    const Real* v = p->v.Store();
+    Real* pr = vr.Store();
+    Real* pi = vi.Store();
+    for(int o = 0; o < n; o += str, v += 2*str)
+        for(int j = 0; j < str; ++j)
+            { pr[o+j] = v[j]; pi[o+j] = v[str+j]; }
+    re = ITensor(I,vr); re.scale_ = scale_;
+    im = ITensor(I,vi); im.scale_ = scale_;
 	}
 
+ITensor ITensor::
+joinReIm(const ITensor& re, const ITensor& im)
+    {
+    //Bring im to the Index order of re if needed
+    ITensor aim;
+    const ITensor* pim = &im;
+    bool same = (re.r_ == im.r_);
+    for(int j = 1; j <= re.r_ && same; ++j)
+        same = (re.index_[j] == im.index_[j]);
+    if(!same) { aim = re; aim.assignFrom(im); pim = &aim; }
+
+    //ReIm goes after the m != 1 indices of re: the real
+    //parts fill the first half of the storage
+    LogNumber sc = (re.scale_.isRealZero() ? pim->scale_ : re.scale_);
+    if(sc.isRealZero()) sc = 1;
+    const Real fr = (re.scale_/sc).real(), fi = (pim->scale_/sc).real();
+    const int n = re.p->v.Length();
+    Vector v(2*n);
+    v.SubVector(1,n) = re.p->v; 
+    v.SubVector(1,n) *= fr;
+    v.SubVector(n+1,2*n) = pim->p->v; 
+    v.SubVector(n+1,2*n) *= fi;
+
+    std::vector<Index> I(re.index_.begin()+1,re.index_.begin()+re.r_+1);
+    I.push_back(Index::IndReIm());
+    ITensor res(I,v);
+    res.scale_ = sc;
+    return res;
+    }
+
+void ITensor::
+conj()
+    {
+    if(!is_complex()) return;
+    //Negate the imaginary runs of the storage in place
+    solo();
+#ifdef DO_ALT
+    p->alt.clear();
+#endif
+    const int str = reImStride();
+    const int len = p->v.Length();
+    Real* v = p->v.Store();
+    for(int o = str; o < len; o += 2*str)
+        for(int j = 0; j < str; ++j)
+            v[o+j] = -v[o+j];
+    }
+
 Real ITensor::
 sumels() const 
     { return p->v.sumels() * scale_.real(); }
@@ -1307,113 +1418,33 @@ reshapeDat(const Permutation& P, Vector& rdat) const
 	}
 
     rdat.ReDimension(thisdat.Length());
-    rdat = 0;
 
+#ifdef COLLECT_PRODSTATS
     const Permutation::int9& ind = P.ind();
-
-    //Make a counter for thisdat
-    Counter c; initCounter(c);
-    boost::array<int,NMAX+1> n;
-    for(int j = 1; j <= rn_; ++j) n[ind[j]] = c.n[j];
-
-    //Special case loops
-#define Loop6(q,z,w,k,y,s) {for(int i1 = 1; i1 <= n[1]; ++i1) for(int i2 = 1; i2 <= n[2]; ++i2)\
-	for(int i3 = 1; i3 <= n[3]; ++i3) for(int i4 = 1; i4 <= n[4]; ++i4) for(int i5 = 1; i5 <= n[5]; ++i5)\
-    for(int i6 = 1; i6 <= n[6]; ++i6)\
-    rdat( (((((i6-1)*n[5]+i5-1)*n[4]+i4-1)*n[3]+i3-1)*n[2]+i2-1)*n[1]+i1 ) =\
-    thisdat( (((((s-1)*c.n[5]+y-1)*c.n[4]+k-1)*c.n[3]+w-1)*c.n[2]+z-1)*c.n[1]+q ); return; }
-
-#define Loop5(q,z,w,k,y) {for(int i1 = 1; i1 <= n[1]; ++i1) for(int i2 = 1; i2 <= n[2]; ++i2)\
-	for(int i3 = 1; i3 <= n[3]; ++i3) for(int i4 = 1; i4 <= n[4]; ++i4) for(int i5 = 1; i5 <= n[5]; ++i5)\
-    rdat( ((((i5-1)*n[4]+i4-1)*n[3]+i3-1)*n[2]+i2-1)*n[1]+i1 ) = thisdat( ((((y-1)*c.n[4]+k-1)*c.n[3]+w-1)*c.n[2]+z-1)*c.n[1]+q ); return; }
-
-#define Loop4(q,z,w,k) {for(int i1 = 1; i1 <= n[1]; ++i1)  for(int i2 = 1; i2 <= n[2]; ++i2)\
-	for(int i3 = 1; i3 <= n[3]; ++i3) for(int i4 = 1; i4 <= n[4]; ++i4)\
-	rdat( (((i4-1)*n[3]+i3-1)*n[2]+i2-1)*n[1]+i1 ) = thisdat( (((k-1)*c.n[3]+w-1)*c.n[2]+z-1)*c.n[1]+q ); return; }
-
-#define Loop3(q,z,w) {for(int i1 = 1; i1 <= n[1]; ++i1)  for(int i2 = 1; i2 <= n[2]; ++i2)\
-	for(int i3 = 1; i3 <= n[3]; ++i3) rdat( ((i3-1)*n[2]+i2-1)*n[1]+i1 ) = thisdat( ((w-1)*c.n[2]+z-1)*c.n[1]+q ); return; }
-
-#define Bif3(a,b,c) if(ind[1] == a && ind[2] == b && ind[3] == c)
-
-#define Bif4(a,b,c,d) if(ind[1] == a && ind[2] == b && ind[3] == c && ind[4] == d)
-
-#define Bif5(a,b,c,d,e) if(ind[1] == a && ind[2] == b && ind[3] == c && ind[4]==d && ind[5] == e)
-
-#define Bif6(a,b,c,d,e,g) if(ind[1] == a && ind[2] == b && ind[3] == c && ind[4]==d && ind[5] == e && ind[6] == g)
-
-    if(rn_ == 2 && ind[1] == 2 && ind[2] == 1)
-	{
-        MatrixRef xref; thisdat.TreatAsMatrix(xref,c.n[2],c.n[1]);
-        rdat = Matrix(xref.t()).TreatAsVector();
-        return; 
-	}
-    else if(rn_ == 3)
-	{
-        DO_IF_PS(int idx = ((ind[1]-1)*3+ind[2]-1)*3+ind[3]; prodstats.perms_of_3[idx] += 1; )
-        //Arranged loosely in order of frequency of occurrence
-        Bif3(2,1,3) Loop3(i2,i1,i3)
-        Bif3(2,3,1) Loop3(i2,i3,i1) //cyclic
-        Bif3(3,1,2) Loop3(i3,i1,i2)
-        //Bif3(1,3,2) Loop3(i1,i3,i2)
-        //Bif3(3,2,1) Loop3(i3,i2,i1)
-	}
+    if(rn_ == 3)
+        {
+        int idx = ((ind[1]-1)*3+ind[2]-1)*3+ind[3]; prodstats.perms_of_3[idx] += 1;
+        }
     else if(rn_ == 4)
-	{
-        DO_IF_PS(int idx = (((ind[1]-1)*4+ind[2]-1)*4+ind[3]-1)*4+ind[4]; prodstats.perms_of_4[idx] += 1; )
-        //Arranged loosely in order of frequency of occurrence
-        Bif4(1,2,4,3) Loop4(i1,i2,i4,i3)
-        Bif4(1,3,2,4) Loop4(i1,i3,i2,i4)
-        Bif4(2,3,1,4) Loop4(i2,i3,i1,i4)
-        Bif4(2,3,4,1) Loop4(i2,i3,i4,i1) //cyclic
-        Bif4(1,4,2,3) Loop4(i1,i4,i2,i3)
-        Bif4(2,1,3,4) Loop4(i2,i1,i3,i4)
-        Bif4(2,1,4,3) Loop4(i2,i1,i4,i3)
-        Bif4(3,4,1,2) Loop4(i3,i4,i1,i2)
-	}
+        {
+        int idx = (((ind[1]-1)*4+ind[2]-1)*4+ind[3]-1)*4+ind[4]; prodstats.perms_of_4[idx] += 1;
+        }
     else if(rn_ == 5)
-	{
-        DO_IF_PS(int idx = ((((ind[1]-1)*5+ind[2]-1)*5+ind[3]-1)*5+ind[4]-1)*5+ind[5]; prodstats.perms_of_5[idx] += 1; )
-        //Arranged loosely in order of frequency of occurrence
-        Bif5(3,1,4,5,2) Loop5(i3,i1,i4,i5,i2)
-        Bif5(1,4,2,5,3) Loop5(i1,i4,i2,i5,i3)
-        Bif5(1,4,2,3,5) Loop5(i1,i4,i2,i3,i5)
-        Bif5(3,1,4,2,5) Loop5(i3,i1,i4,i2,i5)
-        Bif5(2,4,1,3,5) Loop5(i2,i4,i1,i3,i5)
-        Bif5(2,4,3,5,1) Loop5(i2,i4,i3,i5,i1)
-        Bif5(3,1,4,5,2) Loop5(i3,i1,i4,i5,i2)
-        Bif5(3,4,1,2,5) Loop5(i3,i4,i1,i2,i5)
-        Bif5(2,1,3,4,5) Loop5(i2,i1,i3,i4,i5)
-        Bif5(2,3,4,5,1) Loop5(i2,i3,i4,i5,i1)
-        Bif5(2,3,4,1,5) Loop5(i2,i3,i4,i1,i5)
-        Bif5(2,3,1,4,5) Loop5(i2,i3,i1,i4,i5)
-        Bif5(2,3,4,1,5) Loop5(i2,i3,i4,i1,i5)
-        Bif5(3,4,1,5,2) Loop5(i3,i4,i1,i5,i2)
-        Bif5(5,1,4,2,3) Loop5(i5,i1,i4,i2,i3)
-	}
+        {
+        int idx = ((((ind[1]-1)*5+ind[2]-1)*5+ind[3]-1)*5+ind[4]-1)*5+ind[5]; prodstats.perms_of_5[idx] += 1;
+        }
     else if(rn_ == 6)
-	{
-        DO_IF_PS(int idx = (((((ind[1]-1)*6+ind[2]-1)*6+ind[3]-1)*6+ind[4]-1)*6+ind[5]-1)*6+ind[6]; prodstats.perms_of_6[idx] += 1; )
-        //Arranged loosely in order of frequency of occurrence
-        Bif6(2,4,1,3,5,6) Loop6(i2,i4,i1,i3,i5,i6)
-        Bif6(1,4,2,3,5,6) Loop6(i1,i4,i2,i3,i5,i6)
-        Bif6(2,4,1,5,3,6) Loop6(i2,i4,i1,i5,i3,i6)
-        Bif6(1,2,4,5,3,6) Loop6(i1,i2,i4,i5,i3,i6)
-        Bif6(3,4,1,5,6,2) Loop6(i3,i4,i1,i5,i6,i2)
-    }
-    DO_IF_PS(prodstats.c4 += 1;)
-
-    //The j's are pointers to the i's of xdat's Counter,
-    //but reordered in a way appropriate for rdat
-    boost::array<int*,NMAX+1> j;
-    for(int k = 1; k <= NMAX; ++k) { j[ind[k]] = &(c.i[k]); }
-
-    //Catch-all loop that works for any tensor
-    for(; c.notDone(); ++c)
         {
-        rdat((((((((*j[8]-1)*n[7]+*j[7]-1)*n[6]+*j[6]-1)*n[5]+*j[5]-1)*n[4]+*j[4]-1)*n[3]+*j[3]-1)*n[2]+*j[2]-1)*n[1]+*j[1])
-            = thisdat(c.ind);
+        int idx = (((((ind[1]-1)*6+ind[2]-1)*6+ind[3]-1)*6+ind[4]-1)*6+ind[5]-1)*6+ind[6]; prodstats.perms_of_6[idx] += 1;
         }
+    prodstats.c4 += 1;
+#endif
+
+    boost::array<int,NMAX+1> dims;
+    dims.assign(1);
+    for(int j = 1; j <= rn_; ++j) dims[j] = index_[j].m();
+
+    permuteData(P,dims,rn_,thisdat.Store(),rdat.Store());
     }
 
 //
@@ -1426,6 +1457,13 @@ struct ProductProps
 {
     ProductProps(const ITensor& L, const ITensor& R);
 
+    //Returns the ProductProps of L and R, reusing a stored
+    //copy if the same index structures were multiplied before.
+    //Returned by value: the cache may be cleared by a nested
+    //product while the caller still uses its ProductProps
+    static ProductProps
+    cached(const ITensor& L, const ITensor& R);
+
     //arrays specifying which indices match
     boost::array<bool,NMAX+1> contractedL, contractedR; 
 
@@ -1437,11 +1475,75 @@ struct ProductProps
         rcstart; //where R's contracted inds start
 
     //Permutations that move all matching m!=1
-    //indices pairwise to the front 
+    //indices pairwise to the front, followed by
+    //the uncontracted indices
     Permutation pl, pr;
 
+    //true if L/R dat can be used as a matrix without reshaping
+    bool L_is_matrix, R_is_matrix;
+
+    //true if the contracted inds of L/R are in front once
+    //L/R is a matrix (so its MatrixRef must be transposed)
+    bool lfront, rfront;
+
+    //true if product is done with explicit loops
+    //rather than a matrix multiplication
+    bool small_prod;
+
+    //For products done as a batch of matrix multiplications
+    //(avoiding reshapeDat): L is viewed as lb consecutive
+    //(la x cdim) matrices and R as rb (ra x cdim) matrices
+    bool batched;
+    int la, lb, ra, rb;
+
+    //A batched product is preferred over reshaping and a single
+    //multiplication only if la and ra are at least min_batch_dim and 
+    //the tensor to be reshaped has at least min_batch_size elements
+    //(for smaller tensors the copy is cheap compared to the loss
+    //of efficiency of many small multiplications)
+    static const int min_batch_dim = 16;
+    static const int min_batch_size = 524288;
+
+    //Clears the cache of the calling thread only
+    static void
+    clearCache() { cache().clear(); }
+
+    static int cache_hits, cache_misses;
+
+private:
+
+    struct Key
+        {
+        int rnL, rnR;
+        boost::array<Real,2*NMAX> ur;
+
+        Key(const ITensor& L, const ITensor& R);
+
+        bool 
+        operator<(const Key& other) const;
+        };
+
+    typedef std::map<Key,ProductProps> Cache;
+
+    //Each thread has its own cache, so no locking is needed
+    //(the caches of finished threads are not reclaimed)
+    static Cache&
+    cache()
+        {
+        static __thread Cache* cache_ = 0;
+        if(cache_ == 0) cache_ = new Cache();
+        return *cache_;
+        }
+
+    //Size at which the cache is emptied; keeps memory bounded
+    //since each new link index (e.g. after an SVD) adds entries
+    static const int max_cache_size = 2000;
+
 };
 
+int ProductProps::cache_hits = 0;
+int ProductProps::cache_misses = 0;
+
 ProductProps::
 ProductProps(const ITensor& L, const ITensor& R)
     : nsamen(0), 
@@ -1449,7 +1551,14 @@ ProductProps(const ITensor& L, const ITensor& R)
       odimL(-1), 
       odimR(-1),
       lcstart(-1), 
-      rcstart(-1)
+      rcstart(-1),
+      L_is_matrix(true),
+      R_is_matrix(true),
+      lfront(true),
+      rfront(true),
+      small_prod(false),
+      batched(false),
+      la(1), lb(1), ra(1), rb(1)
     {
 
     for(int j = 1; j <= NMAX; ++j) 
@@ -1475,6 +1584,99 @@ ProductProps(const ITensor& L, const ITensor& R)
     odimL = L.p->v.Length()/cdim;
     odimR = R.p->v.Length()/cdim;
 
+    //Finish making the permutations (stick non contracted inds on the back)
+    int q = nsamen;
+    for(int j = 1; j <= L.rn_; ++j)
+        if(!contractedL[j]) pl.from_to(j,++q);
+    q = nsamen;
+    for(int j = 1; j <= R.rn_; ++j)
+        if(!contractedR[j]) pr.from_to(j,++q);
+
+    bool L_is_block = true, R_is_block = true;
+    if(nsamen != 0)
+	{
+	//Check that contracted inds are contiguous
+	//and in the same order in L and R
+	for(int i = 0; i < nsamen; ++i) 
+	    {
+	    if(!contractedL[lcstart+i]) L_is_block = false;
+	    if(!contractedR[rcstart+i] || pr.dest(rcstart+i) != i+1) R_is_block = false;
+	    }
+	//Check that contracted inds are all at beginning or end of _indexn
+	L_is_matrix = L_is_block && (contractedL[1] || contractedL[L.rn_]);
+	R_is_matrix = R_is_block && (contractedR[1] || contractedR[R.rn_]);
+	}
+
+    lfront = (!L_is_matrix || contractedL[1]);
+    rfront = (!R_is_matrix || contractedR[1]);
+
+    small_prod = ((odimL*cdim*odimR) < 10000 && (L.rn_+R.rn_-2*nsamen) <= 4 
+                  && L.rn_ <= 4 && R.rn_ <= 4);
+
+    //A block of contracted inds in the middle of L or R can be
+    //handled as a batch of matrix multiplications, one for each
+    //value of the inds following the block
+    if(nsamen != 0 && !small_prod && L_is_block && R_is_block
+       && !(L_is_matrix && R_is_matrix))
+        {
+        la = ra = 1;
+        for(int j = 1; j < lcstart; ++j) la *= L.index_[j].m();
+        for(int j = 1; j < rcstart; ++j) ra *= R.index_[j].m();
+        if(L_is_matrix) { la = odimL; lb = 1; } else { lb = odimL/la; }
+        if(R_is_matrix) { ra = odimR; rb = 1; } else { rb = odimR/ra; }
+        const int size = std::max(lb == 1 ? 0 : la*cdim*lb, rb == 1 ? 0 : ra*cdim*rb);
+        batched = (la >= min_batch_dim && ra >= min_batch_dim && size >= min_batch_size);
+        }
+
+    }
+
+ProductProps::Key::
+Key(const ITensor& L, const ITensor& R)
+    : rnL(L.rn_), rnR(R.rn_)
+    {
+    for(int j = 1; j <= rnL; ++j) ur[j-1] = L.index_[j].unique_Real();
+    for(int j = 1; j <= rnR; ++j) ur[rnL+j-1] = R.index_[j].unique_Real();
+    }
+
+bool ProductProps::Key::
+operator<(const Key& other) const
+    {
+    if(rnL != other.rnL) return rnL < other.rnL;
+    if(rnR != other.rnR) return rnR < other.rnR;
+    for(int j = 0; j < rnL+rnR; ++j)
+        {
+        if(ur[j] != other.ur[j]) return ur[j] < other.ur[j];
+        }
+    return false;
+    }
+
+ProductProps ProductProps::
+cached(const ITensor& L, const ITensor& R)
+    {
+    Key k(L,R);
+    Cache& c = cache();
+    Cache::iterator it = c.find(k);
+    if(it != c.end())
+        {
+        __sync_add_and_fetch(&cache_hits,1);
+        return it->second;
+        }
+    __sync_add_and_fetch(&cache_misses,1);
+    if(int(c.size()) >= max_cache_size) c.clear();
+    return c.insert(std::make_pair(k,ProductProps(L,R))).first->second;
+    }
+
+int ITensor::
+planCacheHits() { return ProductProps::cache_hits; }
+
+int ITensor::
+planCacheMisses() { return ProductProps::cache_misses; }
+
+void ITensor::
+clearPlanCache() 
+    { 
+    ProductProps::cache_hits = ProductProps::cache_misses = 0;
+    ProductProps::clearCache();
     }
 
 //Converts ITensor dats into MatrixRef's that can be multiplied as rref*lref
@@ -1487,26 +1689,11 @@ toMatrixProd(const ITensor& L, const ITensor& R, const ProductProps& pp,
     assert(R.p != 0);
     const Vector &Ldat = L.p->v, &Rdat = R.p->v;
 
-    Permutation pl = pp.pl;
-    Permutation pr = pp.pr;
-
-    bool L_is_matrix = true, R_is_matrix = true;
-    if(pp.nsamen != 0)
-	{
-	//Check that contracted inds are contiguous
-	for(int i = 0; i < pp.nsamen; ++i) 
-	    {
-	    if(!pp.contractedL[pp.lcstart+i]) L_is_matrix = false;
-	    if(!pp.contractedR[pp.rcstart+i]) R_is_matrix = false;
-	    }
-	//Check that contracted inds are all at beginning or end of _indexn
-	if(!(pp.contractedL[1] || pp.contractedL[L.rn_])) L_is_matrix = false; 
-	if(!(pp.contractedR[1] || pp.contractedR[R.rn_])) R_is_matrix = false;
-	}
+    bool L_is_matrix = pp.L_is_matrix, R_is_matrix = pp.R_is_matrix;
 
     if(L_is_matrix)  
 	{
-	if(pp.contractedL[1]) 
+	if(pp.lfront) 
 	    { Ldat.TreatAsMatrix(lref,pp.odimL,pp.cdim); lref.ApplyTrans(); }
 	else { Ldat.TreatAsMatrix(lref,pp.cdim,pp.odimL); }
 	}
@@ -1547,19 +1734,15 @@ toMatrixProd(const ITensor& L, const ITensor& R, const ProductProps& pp,
 		}
 	    } //for int n
 #endif
-	//Finish making the permutation (stick non contracted inds on the back)
 	if(!done_with_L)
 	    {
-	    int q = pp.nsamen;
-	    for(int j = 1; j <= L.rn_; ++j)
-		if(!pp.contractedL[j]) pl.from_to(j,++q);
 	    if(L_is_matrix) Error("Calling reshapeDat although L is matrix.");
 #ifdef DO_ALT
-	    L.newAltDat(pl);
-	    L.reshapeDat(pl,L.lastAlt().v);
+	    L.newAltDat(pp.pl);
+	    L.reshapeDat(pp.pl,L.lastAlt().v);
 	    L.lastAlt().v.TreatAsMatrix(lref,pp.odimL,pp.cdim); lref.ApplyTrans();
 #else
-	    Vector lv; L.reshapeDat(pl,lv);
+	    Vector lv; L.reshapeDat(pp.pl,lv);
 	    lv.TreatAsMatrix(lref,pp.odimL,pp.cdim); lref.ApplyTrans();
 #endif
 	    done_with_L = true;
@@ -1569,7 +1752,7 @@ toMatrixProd(const ITensor& L, const ITensor& R, const ProductProps& pp,
 
     if(R_is_matrix) 
 	{
-	if(pp.contractedR[1]) { Rdat.TreatAsMatrix(rref,pp.odimR,pp.cdim); }
+	if(pp.rfront) { Rdat.TreatAsMatrix(rref,pp.odimR,pp.cdim); }
 	else                    
 	    { Rdat.TreatAsMatrix(rref,pp.cdim,pp.odimR); rref.ApplyTrans(); }
 	}
@@ -1610,19 +1793,15 @@ toMatrixProd(const ITensor& L, const ITensor& R, const ProductProps& pp,
 		}
 	    } //for int n
 #endif
-	//Finish making the permutation (stick non contracted inds on the back)
 	if(!done_with_R)
 	    {
-	    int q = pp.nsamen;
-	    for(int j = 1; j <= R.rn_; ++j)
-		if(!pp.contractedR[j]) pr.from_to(j,++q);
 	    if(R_is_matrix) Error("Calling reshape even though R is matrix.");
 #ifdef DO_ALT
-	    R.newAltDat(pr);
-	    R.reshapeDat(pr,R.lastAlt().v);
+	    R.newAltDat(pp.pr);
+	    R.reshapeDat(pp.pr,R.lastAlt().v);
 	    R.lastAlt().v.TreatAsMatrix(rref,pp.odimR,pp.cdim);
 #else
-	    Vector rv; R.reshapeDat(pr,rv);
+	    Vector rv; R.reshapeDat(pp.pr,rv);
 	    rv.TreatAsMatrix(rref,pp.odimR,pp.cdim);
 #endif
 	    done_with_R = true;
@@ -1640,6 +1819,55 @@ toMatrixProd(const ITensor& L, const ITensor& R, const ProductProps& pp,
     }
 
 
+//Computes the product of L and R, for a ProductProps with
+//pp.batched == true, as a batch of lb*rb matrix multiplications
+//(one per value of the uncontracted inds following the contracted
+//ones) without permuting the data of L or R. The result has the
+//uncontracted inds of L followed by those of R.
+void
+batchMatrixProd(const ITensor& L, const ITensor& R, const ProductProps& pp,
+                Vector& res)
+    {
+    assert(L.p != 0);
+    assert(R.p != 0);
+    const Vector &Ldat = L.p->v, &Rdat = R.p->v;
+    const int la = pp.la, lb = pp.lb, ra = pp.ra, rb = pp.rb, cdim = pp.cdim;
+
+    res.ReDimension(la*lb*ra*rb);
+
+    //Row j+ra*l, column i+la*k of nfull is element (i,k,j,l) of res
+    MatrixRef nfull; res.TreatAsMatrix(nfull,ra*rb,la*lb);
+
+    //Row c+cdim*k, column i of lfull is element (i,c,k) of L
+    MatrixRef lfull, lref;
+    if(lb == 1)
+        {
+        if(pp.lfront) { Ldat.TreatAsMatrix(lref,la,cdim); lref << lref.t(); }
+        else          { Ldat.TreatAsMatrix(lref,cdim,la); }
+        }
+    else Ldat.TreatAsMatrix(lfull,cdim*lb,la);
+
+    //Row c+cdim*l, column j of rfull is element (j,c,l) of R
+    MatrixRef rfull, rref;
+    if(rb == 1)
+        {
+        if(pp.rfront) { Rdat.TreatAsMatrix(rref,ra,cdim); }
+        else          { Rdat.TreatAsMatrix(rref,cdim,ra); rref << rref.t(); }
+        }
+    else Rdat.TreatAsMatrix(rfull,cdim*rb,ra);
+
+    for(int l = 0; l < rb; ++l)
+        {
+        if(rb != 1) rref << rfull.SubMatrix0(l*cdim,(l+1)*cdim-1,0,ra-1).t();
+        for(int k = 0; k < lb; ++k)
+            {
+            if(lb != 1) lref << lfull.SubMatrix0(k*cdim,(k+1)*cdim-1,0,la-1);
+            MatrixRef nref = nfull.SubMatrix0(l*ra,(l+1)*ra-1,k*la,(k+1)*la-1);
+            nref = rref*lref;
+            }
+        }
+    }
+
 //Non-contracting product: Cikj = Aij Bkj (no sum over j)
 ITensor& ITensor::
 operator/=(const ITensor& other)
@@ -1653,7 +1881,7 @@ operator/=(const ITensor& other)
     //These hold the indices from other 
     //that will be added to this->index_
     int nr1_ = 0;
-    static boost::array<const Index*,NMAX+1> extra_index1_;
+    boost::array<const Index*,NMAX+1> extra_index1_;
 
     //------------------------------------------------------------------
     //Handle m==1 Indices: set union
@@ -1667,7 +1895,7 @@ operator/=(const ITensor& other)
         if(!this_has_index) extra_index1_[++nr1_] = &J;
     }
 
-    static boost::array<Index,NMAX+1> new_index_;
+    boost::array<Index,NMAX+1> new_index_;
 
     if(other.rn_ == 0)
     {
@@ -1699,7 +1927,7 @@ operator/=(const ITensor& other)
         return *this;
     }
 
-    ProductProps pp(*this,other);
+    const ProductProps pp = ProductProps::cached(*this,other);
     MatrixRefNoLink lref, rref;
     toMatrixProd(*this,other,pp,lref,rref);
 
@@ -1749,10 +1977,87 @@ operator/=(const ITensor& other)
     }
 
 
-inline int 
-ind4(int i4, int m3, int i3, int m2, int i2, int m1, int i1)
+//
+// Kernels of the small-tensor product path. Each computes D
+// entries of the product at once,
+//   c[r] = sum_j sum_k a[r*ia+k*sa+j*ta] * b[r*ib+k*sb+j*tb],
+// r < D, k < K, j < J, where r runs over the fastest index
+// of the result and k, j over at most two runs of (fused)
+// contracted indices, and returns the sum of their squares 
+// (saving scaleOutNorm a pass over the result). With D and
+// K fixed at compile time the inner loops unroll completely
+// and the D sums stay in registers.
+//
+typedef Real (*SmallProdKernel)(const Real* a, int ia, int sa, 
+                                const Real* b, int ib, int sb, 
+                                int J, int ta, int tb, Real* c);
+
+template <int D, int K>
+Real
+smallProdKernel(const Real* a, int ia, int sa, const Real* b, int ib, int sb, 
+                int J, int ta, int tb, Real* c)
+    {
+    Real d[D];
+#pragma GCC unroll 4
+    for(int r = 0; r < D; ++r) d[r] = 0;
+    for(int j = 0; j < J; ++j, a += ta, b += tb)
+#pragma GCC unroll 32
+    for(int k = 0; k < K; ++k)
+#pragma GCC unroll 4
+        for(int r = 0; r < D; ++r)
+            d[r] += a[r*ia+k*sa] * b[r*ib+k*sb];
+    Real nrm2 = 0;
+#pragma GCC unroll 4
+    for(int r = 0; r < D; ++r) { c[r] = d[r]; nrm2 += d[r]*d[r]; }
+    return nrm2;
+    }
+
+//Shape table: kernel for D = 1..4 (typically a site
+//dimension) and K = 1..32 (a site or MPO bond dimension)
+static const int small_prod_maxD = 4, small_prod_maxK = 32;
+
+#define SPK8(D,o) &smallProdKernel<D,o+1>, &smallProdKernel<D,o+2>, \
+                  &smallProdKernel<D,o+3>, &smallProdKernel<D,o+4>, \
+                  &smallProdKernel<D,o+5>, &smallProdKernel<D,o+6>, \
+                  &smallProdKernel<D,o+7>, &smallProdKernel<D,o+8>
+#define SPK32(D) { SPK8(D,0), SPK8(D,8), SPK8(D,16), SPK8(D,24) }
+
+static const SmallProdKernel 
+small_prod_kernel[small_prod_maxD][small_prod_maxK] = 
+    { SPK32(1), SPK32(2), SPK32(3), SPK32(4) };
+
+#undef SPK32
+#undef SPK8
+
+//Same as the kernels, for any D and up to 4 contracted
+//indices of dimensions mc[n] and strides sa[n], sb[n]
+static Real
+smallProdGeneric(int D, const Real* a, int ia, const Real* b, int ib,
+                 int nc, const int* mc, const int* sa, const int* sb, Real* c)
     {
-    return (((i4-1)*m3+i3-1)*m2+i2-1)*m1+i1;
+    int m[4] = { 1, 1, 1, 1 }, ta[4] = { 0, 0, 0, 0 }, tb[4] = { 0, 0, 0, 0 };
+    for(int n = 0; n < nc; ++n) { m[n] = mc[n]; ta[n] = sa[n]; tb[n] = sb[n]; }
+    Real nrm2 = 0;
+    for(int r = 0; r < D; ++r)
+        {
+        Real d = 0;
+        const Real *ar = a + r*ia, *br = b + r*ib;
+        for(int c3 = 0; c3 < m[3]; ++c3)
+        for(int c2 = 0; c2 < m[2]; ++c2)
+            {
+            const Real* a1 = ar + c2*ta[2] + c3*ta[3];
+            const Real* b1 = br + c2*tb[2] + c3*tb[3];
+            for(int c1 = 0; c1 < m[1]; ++c1, a1 += ta[1], b1 += tb[1])
+                {
+                const Real *a0 = a1, *b0 = b1;
+                for(int c0 = 0; c0 < m[0]; ++c0, a0 += ta[0], b0 += tb[0])
+                    d += (*a0) * (*b0);
+                }
+            }
+        c[r] = d;
+        nrm2 += d*d;
+        }
+    return nrm2;
     }
 
 ITensor& ITensor::
@@ -1764,33 +2069,39 @@ operator*=(const ITensor& other)
         return operator*=(cp_oth);
         }
 
-    //Complex types are treated as just another index, of type ReIm
-    //Multiplication is handled automatically with these simple tensor helpers
+    //Complex types are treated as just another index, of type ReIm.
+    //The product of two complex tensors is built from three real
+    //products of their parts, re = ar*br - ai*bi and
+    //im = (ar+ai)*(br+bi) - ar*br - ai*bi. Small tensors, for which
+    //the extra sums cost more than they save, are instead contracted 
+    //with ReImPrimer, ReImPrimerP and the ComplexProd table
     if(findindexn(Index::IndReIm()) && other.findindexn(Index::IndReIm()) && 
 	    !other.findindexn(Index::IndReImP()) && !other.hasindex(Index::IndReImPP()) 
 	    && !hasindex(Index::IndReImP()) && !hasindex(Index::IndReImPP()))
         {
-        static ITensor primer(Index::IndReIm(),Index::IndReImP(),1.0);
-        static ITensor primerP(Index::IndReIm(),Index::IndReImPP(),1.0);
-        static ITensor prod(Index::IndReIm(),Index::IndReImP(),Index::IndReImPP());
-        static bool first = true;
-        if(first)
-	    {
-            IndexVal iv0(Index::IndReIm(),1), iv1(Index::IndReImP(),1), iv2(Index::IndReImPP(),1);
-            iv0.i = 1; iv1.i = 1; iv2.i = 1; prod(iv0,iv1,iv2) = 1.0;
-            iv0.i = 1; iv1.i = 2; iv2.i = 2; prod(iv0,iv1,iv2) = -1.0;
-            iv0.i = 2; iv1.i = 2; iv2.i = 1; prod(iv0,iv1,iv2) = 1.0;
-            iv0.i = 2; iv1.i = 1; iv2.i = 2; prod(iv0,iv1,iv2) = 1.0;
-            first = false;
-	    }
-        operator*=(primer);
-        operator*=(prod * (other * primerP));
+        if(Real(vec_size())*other.vec_size() < 4E5)
+            {
+            operator*=(ReImPrimer());
+            operator*=(ComplexProd() * (other * ReImPrimerP()));
+            return *this;
+            }
+        ITensor ar, ai, br, bi;
+        SplitReIm(ar,ai);
+        other.SplitReIm(br,bi);
+        ITensor rr = ar; rr *= br;
+        ITensor ii = ai; ii *= bi;
+        ar += ai; br += bi;
+        ar *= br;
+        rr *= -1; ar += rr;
+        ii *= -1; ar += ii;
+        rr *= -1; rr += ii;
+        *this = joinReIm(rr,ar);
         return *this;
         }
 
     //These hold  regular new indices and the m==1 indices that appear in the result
-    static boost::array<Index,NMAX+1> new_index_;
-    static boost::array<const Index*,NMAX+1> new_index1_;
+    boost::array<Index,NMAX+1> new_index_;
+    boost::array<const Index*,NMAX+1> new_index1_;
     int nr1_ = 0;
 
     //
@@ -1858,49 +2169,54 @@ operator*=(const ITensor& other)
         return *this;
         }
 
-    ProductProps pp(*this,other);
+    const ProductProps pp = ProductProps::cached(*this,other);
 
     int new_rn_ = 0;
+    bool normed = false;
 
-    if((pp.odimL*pp.cdim*pp.odimR) < 10000 && (rn_+other.rn_-2*pp.nsamen) <= 4 && rn_ <= 4 && other.rn_ <= 4)
+    if(pp.small_prod)
         {
-        int am[NMAX+1], bm[NMAX+1], mcon[NMAX+1], mnew[NMAX+1];
-        int *pa[NMAX+1], *pb[NMAX+1];
-        int one = 1;
-        for(int j = 1; j <= NMAX; ++j)
-            {
-            //Set *pa[j],*pb[j],mcon[j] and mnew[j]
-            // to 1 unless set otherwise below
-            pa[j] = pb[j] = &one, mcon[j] = mnew[j] = 1;
-            am[j] = index_[j].m();
-            bm[j] = other.index_[j].m();
-            }
-        int icon[NMAX+1], inew[NMAX+1];
+        //Dimensions of the (at most 4) new and contracted
+        //indices, with their strides in this (ia, sa) and
+        //other (ib, sb); a new index has stride 0 in the
+        //tensor it does not come from
+        int mnew[5] = { 1, 1, 1, 1, 1 }, ia[5] = { 0, 0, 0, 0, 0 }, ib[5] = { 0, 0, 0, 0, 0 };
+        int mcon[5] = { 1, 1, 1, 1, 1 }, sa[5] = { 0, 0, 0, 0, 0 }, sb[5] = { 0, 0, 0, 0, 0 };
+        int str = 1;
         for(int j = 1; j <= this->rn_; ++j)
+            {
+            const int m = index_[j].m();
             if(!pp.contractedL[j]) 
                 {
-                new_index_[++new_rn_] = index_[j];
-                mnew[new_rn_] = am[j];
-                pa[j] = inew + new_rn_;
+                if(++new_rn_ > 4) break;
+                new_index_[new_rn_] = index_[j];
+                mnew[new_rn_] = m;
+                ia[new_rn_] = str;
                 }
-            else
+            else if(pp.pl.dest(j) <= 4)
                 {
-                mcon[pp.pl.dest(j)] = am[j];
-                pa[j] = icon + pp.pl.dest(j);
+                mcon[pp.pl.dest(j)] = m;
+                sa[pp.pl.dest(j)] = str;
                 }
-
-        for(int j = 1; j <= other.rn_; ++j)
+            str *= m;
+            }
+        str = 1;
+        for(int j = 1; j <= other.rn_ && new_rn_ <= 4; ++j)
+            {
+            const int m = other.index_[j].m();
             if(!pp.contractedR[j]) 
                 {
-                new_index_[++new_rn_] = other.index_[j];
-                mnew[new_rn_] = bm[j];
-                pb[j] = inew + new_rn_;
+                if(++new_rn_ > 4) break;
+                new_index_[new_rn_] = other.index_[j];
+                mnew[new_rn_] = m;
+                ib[new_rn_] = str;
                 }
-            else
+            else if(pp.pr.dest(j) <= 4)
                 {
-                mcon[pp.pr.dest(j)] = bm[j];
-                pb[j] = icon + pp.pr.dest(j);
+                sb[pp.pr.dest(j)] = str;
                 }
+            str *= m;
+            }
 
         if(new_rn_ > 4) 
             {
@@ -1912,72 +2228,75 @@ operator*=(const ITensor& other)
             }
         if(pp.nsamen > 4) Error("nsamen too big for this part!");
 
-        static Vector newdat;
-        newdat.ReduceDimension(pp.odimL*pp.odimR);
-
-        icon[1] = icon[2] = icon[3] = icon[4] = 1;
-        inew[1] = inew[2] = inew[3] = inew[4] = 1;
-        int basea = ind4(*pa[4],am[3],*pa[3],am[2],*pa[2],am[1],*pa[1]); 
-        int baseb = ind4(*pb[4],bm[3],*pb[3],bm[2],*pb[2],bm[1],*pb[1]); 
-        icon[1] = 2;
-        int inca1 = ind4(*pa[4],am[3],*pa[3],am[2],*pa[2],am[1],*pa[1]) - basea; 
-        int incb1 = ind4(*pb[4],bm[3],*pb[3],bm[2],*pb[2],bm[1],*pb[1]) - baseb; 
-        icon[1] = 1;
-        int inca2,incb2;
-        if(pp.nsamen == 2)
-            {
-            icon[2] = 2;
-            inca2 = ind4(*pa[4],am[3],*pa[3],am[2],*pa[2],am[1],*pa[1]) - basea; 
-            incb2 = ind4(*pb[4],bm[3],*pb[3],bm[2],*pb[2],bm[1],*pb[1]) - baseb; 
-            icon[2] = 1;
-            }
-
-        Real *pv = p->v.Store()-1, *opv = other.p->v.Store()-1;
-        for(inew[4] = 1; inew[4] <= mnew[4]; ++inew[4])
-        for(inew[3] = 1; inew[3] <= mnew[3]; ++inew[3])
-        for(inew[2] = 1; inew[2] <= mnew[2]; ++inew[2])
-        for(inew[1] = 1; inew[1] <= mnew[1]; ++inew[1])
-            {
-            Real d = 0.0;
-            if(pp.nsamen == 1)
+        //Fuse contracted indices that follow one another
+        //in both tensors
+        int nc = 0, mc[4], csa[4], csb[4];
+        for(int n = 1; n <= pp.nsamen; ++n)
             {
-                icon[1] = 1;
-                int inda = ind4(*pa[4],am[3],*pa[3],am[2],*pa[2],am[1],*pa[1]);
-                int indb = ind4(*pb[4],bm[3],*pb[3],bm[2],*pb[2],bm[1],*pb[1]);
-                for(icon[1] = 1; icon[1] <= mcon[1]; icon[1]++, inda += inca1, indb += incb1)
-                    d += pv[inda] * opv[indb];
+            if(nc > 0 && csa[nc-1]*mc[nc-1] == sa[n] && csb[nc-1]*mc[nc-1] == sb[n])
+                { mc[nc-1] *= mcon[n]; continue; }
+            mc[nc] = mcon[n]; csa[nc] = sa[n]; csb[nc] = sb[n]; ++nc;
             }
-            else if(pp.nsamen == 2)
+        if(nc == 0) { mc[0] = 1; csa[0] = csb[0] = 0; nc = 1; }
+        if(nc == 1) { mc[1] = 1; csa[1] = csb[1] = 0; }
+        //Of two runs, unroll the longer one that fits a kernel
+        if(nc == 2 && (mc[0] > small_prod_maxK || (mc[1] > mc[0] && mc[1] <= small_prod_maxK)))
             {
-                icon[2] = icon[1] = 1;
-                int inda = ind4(*pa[4],am[3],*pa[3],am[2],*pa[2],am[1],*pa[1]);
-                int indb = ind4(*pb[4],bm[3],*pb[3],bm[2],*pb[2],bm[1],*pb[1]);
-                int indaa = inda, indbb = indb;
-                for(icon[2] = 1; icon[2] <= mcon[2]; icon[2]++, indaa += inca2, indbb += incb2)
-                    {
-                    inda = indaa; indb = indbb;
-                    for(icon[1] = 1; icon[1] <= mcon[1]; ++icon[1], inda += inca1, indb += incb1)
-                    d += pv[inda] * opv[indb];
-                    }
+            std::swap(mc[0],mc[1]);
+            std::swap(csa[0],csa[1]);
+            std::swap(csb[0],csb[1]);
             }
-            else
+        const bool fixedK = (nc <= 2 && mc[0] <= small_prod_maxK);
+
+        boost::intrusive_ptr<ITDat> np = new ITDat(pp.odimL*pp.odimR);
+        Real* c = np->v.Store();
+        const Real *pa = p->v.Store(), *pb = other.p->v.Store();
+        Real nrm2 = 0;
+
+        //The fastest index of the result is done small_prod_maxD 
+        //entries at a time, all of them if it is a site index
+        for(int i4 = 0; i4 < mnew[4]; ++i4)
+        for(int i3 = 0; i3 < mnew[3]; ++i3)
+        for(int i2 = 0; i2 < mnew[2]; ++i2)
             {
-                for(icon[4] = 1; icon[4] <= mcon[4]; ++icon[4])
-                for(icon[3] = 1; icon[3] <= mcon[3]; ++icon[3])
-                for(icon[2] = 1; icon[2] <= mcon[2]; ++icon[2])
-                for(icon[1] = 1; icon[1] <= mcon[1]; ++icon[1])
-                    d +=      p->v(ind4(*pa[4],am[3],*pa[3],am[2],*pa[2],am[1],*pa[1])) 
-                      * other.p->v(ind4(*pb[4],bm[3],*pb[3],bm[2],*pb[2],bm[1],*pb[1]));
+            const Real* a2 = pa + i2*ia[2] + i3*ia[3] + i4*ia[4];
+            const Real* b2 = pb + i2*ib[2] + i3*ib[3] + i4*ib[4];
+            for(int i1 = 0; i1 < mnew[1]; i1 += small_prod_maxD)
+                {
+                const int D = std::min(small_prod_maxD,mnew[1]-i1);
+                const Real *a1 = a2 + i1*ia[1], *b1 = b2 + i1*ib[1];
+                if(fixedK)
+                    nrm2 += small_prod_kernel[D-1][mc[0]-1](a1,ia[1],csa[0],b1,ib[1],csb[0],
+                                                            mc[1],csa[1],csb[1],c);
+                else
+                    nrm2 += smallProdGeneric(D,a1,ia[1],b1,ib[1],nc,mc,csa,csb,c);
+                c += D;
+                }
             }
 
-            newdat(ind4(inew[4],mnew[3],inew[3],mnew[2],inew[2],mnew[1],inew[1])) = d;
-            }
-
-        if(p->count() != 1) { p = new ITDat(); } 
-        p->v = newdat;
+        //Scale out the norm as scaleOutNorm would
+        const Real f = sqrt(nrm2);
+        if(f != 0 && fabs(f-1) >= 1E-12) { np->v *= 1.0/f; scale_ *= f; }
+        normed = true;
+        p = np;
 
         DO_IF_PS(++prodstats.c1;)
         }
+    else if(pp.batched)
+        {
+        DO_IF_PS(++prodstats.c3;)
+        boost::intrusive_ptr<ITDat> np = new ITDat();
+        batchMatrixProd(*this,other,pp,np->v);
+        p = np;
+
+        if((rn_ + other.rn_ - 2*pp.nsamen + nr1_) > NMAX) 
+            Error("ITensor::operator*=: too many uncontracted indices in product (max is 8)");
+
+        for(int j = 1; j <= this->rn_; ++j)
+            { if(!pp.contractedL[j]) new_index_[++new_rn_] = index_[j]; }
+        for(int j = 1; j <= other.rn_; ++j)
+            { if(!pp.contractedR[j]) new_index_[++new_rn_] = other.index_[j]; }
+        }
     else
         {
         
@@ -2022,7 +2341,7 @@ operator*=(const ITensor& other)
 
     index_.swap(new_index_);
     scale_ *= other.scale_;
-    scaleOutNorm();
+    if(!normed) scaleOutNorm();
     set_unique_Real();
 
     return *this;
@@ -2077,85 +2396,69 @@ operator+=(const ITensor& other)
     Vector& thisdat = p->v;
     const Vector& othrdat = other.p->v;
 
-    Real scalefac = 1;
+    //Sum relative to the larger of the two scales:
+    //this becomes thisfac*this + othrfac*other, in one
+    //pass instead of rescaling this first
+    Real thisfac = 1, othrfac = 1;
     if(scale_.magnitudeLessThan(other.scale_)) 
-    {
-        this->scaleTo(other.scale_); 
-    }
+        {
+        thisfac = (scale_/other.scale_).real();
+        scale_ = other.scale_;
+        }
     else
-    {
-        /*
-        LogNumber LNscalefac = other.scale_/scale_;
-        if(LNscalefac.isRealZero())
         {
-            //Other has no effect on this
-            return *this;
+        othrfac = (other.scale_/scale_).real();
         }
-        */
-        //scalefac = LNscalefac.real();
-        scalefac = (other.scale_/scale_).real();
-    }
-
 
 #ifdef DO_ALT
     p->alt.clear();
 #endif
 
+#ifdef STRONG_DEBUG
+    Real tot_this = thisdat.sumels();
+    Real tot_othr = othrdat.sumels();
+    //Rounding errors scale with the terms, not the (possibly cancelling) sum
+    Real ref = fabs(thisfac)*Norm(thisdat) + fabs(othrfac)*Norm(othrdat);
+#endif
+
     bool same_ind_order = true;
     for(int j = 1; j <= rn_; ++j)
     if(index_[j] != other.index_[j])
         { same_ind_order = false; break; }
 
     if(same_ind_order) 
-    { 
-        if(scalefac == 1)
-            thisdat += othrdat; 
+        { 
+        if(thisfac == 1)
+            {
+            if(othrfac == 1) thisdat += othrdat; 
+            else             thisdat += othrfac*othrdat;
+            }
         else
-            thisdat += scalefac*othrdat;
-        return *this; 
-    }
-
-    Permutation P; getperm(other.index_,P);
-    Counter c; other.initCounter(c);
-    int *j[NMAX+1];
-    for(int k = 1; k <= NMAX; ++k) j[P.dest(k)] = &(c.i[k]);
-    static int n[NMAX+1];
-    for(int k = 1; k <= NMAX; ++k) 
-    {
-        n[P.dest(k)] = c.n[k];
-        //n[k] = index_[k].m();
-    }
-
-#ifdef STRONG_DEBUG
-    Real tot_this = thisdat.sumels();
-    Real tot_othr = othrdat.sumels();
-#endif
-
-    if(scalefac == 1)
-    {
-        for(; c.notDone(); ++c)
-        {
-            thisdat((((((((*j[8]-1)*n[7]+*j[7]-1)*n[6]
-            +*j[6]-1)*n[5]+*j[5]-1)*n[4]+*j[4]-1)*n[3]
-            +*j[3]-1)*n[2]+*j[2]-1)*n[1]+*j[1])
-            += othrdat(c.ind);
+            {
+            //In blocks small enough to stay in cache
+            const int n = thisdat.Length();
+            const int blk = 1024;
+            for(int i0 = 1; i0 <= n; i0 += blk)
+                {
+                const int i1 = min(n,i0+blk-1);
+                VectorRef tb = thisdat.SubVector(i0,i1);
+                tb *= thisfac;
+                tb += othrfac*othrdat.SubVector(i0,i1);
+                }
+            }
         }
-    }
     else
-    {
-        for(; c.notDone(); ++c)
         {
-            thisdat((((((((*j[8]-1)*n[7]+*j[7]-1)*n[6]
-            +*j[6]-1)*n[5]+*j[5]-1)*n[4]+*j[4]-1)*n[3]
-            +*j[3]-1)*n[2]+*j[2]-1)*n[1]+*j[1])
-            += scalefac * othrdat(c.ind);
+        Permutation P; getperm(other.index_,P);
+        boost::array<int,NMAX+1> dims;
+        dims.assign(1);
+        for(int j = 1; j <= rn_; ++j) dims[j] = other.index_[j].m();
+        permuteAddData(P,dims,rn_,thisfac,othrfac,othrdat.Store(),thisdat.Store());
         }
-    }
 
 #ifdef STRONG_DEBUG
     Real new_tot = thisdat.sumels();
-    Real compare = tot_this + scalefac*tot_othr;
-    Real ref = Norm(thisdat);
+    Real compare = thisfac*tot_this + othrfac*tot_othr;
     if(fabs(new_tot-compare) > 1E-12 * ref)
 	{
 	Real di = new_tot - compare;
@@ -2167,6 +2470,121 @@ operator+=(const ITensor& other)
     return *this;
     } 
 
+ITensor& ITensor::
+operator+=(const ITensorSum& S)
+    {
+    ITensorSum T(*this);
+    T += S;
+    T.eval(*this);
+    return *this;
+    }
+
+ITensorSum& ITensorSum::
+operator-=(const ITensorSum& S)
+    {
+    for(size_t k = 0; k < S.term_.size(); ++k)
+        {
+        term_.push_back(S.term_[k]);
+        term_.back() *= -1;
+        }
+    return *this;
+    }
+
+ITensorSum& ITensorSum::
+operator*=(Real fac)
+    {
+    for(size_t k = 0; k < term_.size(); ++k) term_[k] *= fac;
+    return *this;
+    }
+
+void
+sum(const std::vector<ITensor>& terms, ITensor& res)
+    {
+    if(terms.empty()) { res = ITensor(); return; }
+    ITensorSum(terms).eval(res);
+    }
+
+void ITensorSum::
+eval(ITensor& res) const
+    {
+    const ITensor& F = term_.front();
+
+    //Terms with the same Index order as the first (real) one
+    //are summed directly, the rest added with operator+=
+    if(F.p == 0 || F.is_complex())
+        {
+        res = F;
+        for(size_t k = 1; k < term_.size(); ++k) res += term_[k];
+        return;
+        }
+    std::vector<int> fused(1,0), rest;
+    for(size_t k = 1; k < term_.size(); ++k)
+        {
+        const ITensor& T = term_[k];
+        //All Index's, the m == 1 ones included, must match
+        bool same = (T.p != 0 && !T.is_complex() && T.r_ == F.r_ && T.rn_ == F.rn_);
+        for(int j = 1; same && j <= F.r_; ++j)
+            same = (T.index_[j] == F.index_[j]);
+        (same ? fused : rest).push_back(k);
+        }
+
+    //Sum relative to the largest scale
+    LogNumber scale(0);
+    for(size_t k = 0; k < fused.size(); ++k)
+        {
+        const LogNumber& sk = term_[fused[k]].scale_;
+        if(!sk.isRealZero() && (scale.isRealZero() || scale.magnitudeLessThan(sk)))
+            scale = sk;
+        }
+
+    std::vector<int> used;
+    std::vector<const Vector*> dat;
+    std::vector<Real> fac;
+    if(!scale.isRealZero())
+    for(size_t k = 0; k < fused.size(); ++k)
+        {
+        const ITensor& T = term_[fused[k]];
+        if(T.scale_.isRealZero()) continue;
+        Real f = (T.scale_/scale).real();
+        if(f == 0) continue;
+        used.push_back(fused[k]);
+        dat.push_back(&(T.p->v));
+        fac.push_back(f);
+        }
+
+    if(dat.empty())
+        {
+        res = F;
+        }
+    else if(dat.size() == 1)
+        {
+        res = term_[used[0]];
+        }
+    else
+        {
+        ITensor R(F);
+        const int n = F.p->v.Length();
+        R.p = new ITDat();
+        R.p->v.ReDimension(n);
+        R.scale_ = scale;
+
+        //In blocks small enough to stay in cache, so that the
+        //output is written to memory once
+        const int blk = 1024;
+        for(int i0 = 1; i0 <= n; i0 += blk)
+            {
+            const int i1 = min(n,i0+blk-1);
+            VectorRef rb = R.p->v.SubVector(i0,i1);
+            rb = fac[0] * dat[0]->SubVector(i0,i1);
+            for(size_t k = 1; k < dat.size(); ++k)
+                rb += fac[k] * dat[k]->SubVector(i0,i1);
+            }
+        res.swap(R);
+        }
+
+    for(size_t k = 0; k < rest.size(); ++k) res += term_[rest[k]];
+    }
+
 void ITensor::
 fromMatrix11(const Index& i1, const Index& i2, const Matrix& M)
     {
@@ -2295,6 +2713,26 @@ void ITensor::fromMatrix12(const Index& i1, const Index& i2, const Index& i3, co
 
 Real Dot(const ITensor& x, const ITensor& y, bool doconj)
 {
+    //Real tensors with their indices in the same order:
+    //no need to contract, just dot the data
+    if(x.r() == y.r() && x.is_not_null() && y.is_not_null()
+       && x.is_not_complex() && y.is_not_complex())
+	{
+        bool same = true;
+        for(int j = 1; j <= x.r() && same; ++j)
+            same = (x.index_[j] == y.index_[j]);
+        if(same)
+            {
+            if(x.scale_.isRealZero() || y.scale_.isRealZero()) return 0;
+            return (x.scale_*y.scale_).real() * (x.p->v * y.p->v);
+            }
+	}
+    if(x.is_complex() && y.is_complex())
+	{
+        Real re, im;
+        Dot(x,y,re,im,doconj);
+        return re;
+	}
     if(x.is_complex())
 	{
         ITensor res = (doconj ? conj(x) : x); res *= y;
@@ -2317,6 +2755,44 @@ Real Dot(const ITensor& x, const ITensor& y, bool doconj)
 void Dot(const ITensor& x, const ITensor& y, Real& re, Real& im, 
                 bool doconj)
 {
+    //Two complex tensors with the same indices: sum the products
+    //of the real and imaginary runs of the storage directly
+    bool ordered = false, same = false;
+    if(x.is_complex() && y.is_complex() && x.r() == y.r())
+        {
+        ordered = true;
+        for(int j = 1; j <= x.r() && ordered; ++j)
+            ordered = (x.index_[j] == y.index_[j]);
+        same = ordered;
+        if(!same)
+            {
+            same = true;
+            for(int j = 1; j <= x.r() && same; ++j)
+                same = y.hasindex(x.index_[j]);
+            }
+        }
+    if(same)
+	{
+        ITensor ay;
+        const ITensor* py = &y;
+        if(!ordered) { ay = x; ay.assignFrom(y); py = &ay; }
+
+        const int str = x.reImStride();
+        const int len = x.p->v.Length();
+        const Real* xv = x.p->v.Store();
+        const Real* yv = py->p->v.Store();
+        Real rr = 0, ii = 0, ri = 0, ir = 0;
+        for(int o = 0; o < len; o += 2*str)
+            for(int j = o; j < o+str; ++j)
+                {
+                rr += xv[j]*yv[j];         ii += xv[j+str]*yv[j+str];
+                ri += xv[j]*yv[j+str];     ir += xv[j+str]*yv[j];
+                }
+        const Real f = (x.scale_*py->scale_).real();
+        re = f*(doconj ? rr+ii : rr-ii);
+        im = f*(doconj ? ri-ir : ri+ir);
+        return;
+	}
     if(x.is_complex())
 	{
         ITensor res = (doconj ? conj(x) : x); res *= y;
@@ -2339,14 +2815,7 @@ void Dot(const ITensor& x, const ITensor& y, Real& re, Real& im,
         cerr << "y = " << y << "\n";
         Error("bad Dot 122414");
 	}
-    ITensor res = x; res *= y;
-    if(res.r() != 0) 
-	{
-        cerr << "x = " << x << "\n";
-        cerr << "y = " << y << "\n";
-        Error("bad Dot 20234");
-	}
-    re = res.val0();
+    re = Dot(x,y,doconj);
     im = 0;
 }
 
@@ -12,6 +12,7 @@ struct ProductProps;
 class Counter;
 class Combiner;
 class ITDat;
+class ITensorSum;
 
 //
 // ITensor
@@ -127,6 +128,18 @@ public:
         return ConjTensor_;
         }
 
+    //Helper tensors for complex products:
+    //ReImPrimer maps ReIm to ReImP, ReImPrimerP maps ReIm to ReImPP,
+    //and ComplexProd(ReIm,ReImP,ReImPP) is the complex multiplication table
+    static const ITensor& 
+    ReImPrimer();
+
+    static const ITensor& 
+    ReImPrimerP();
+
+    static const ITensor& 
+    ComplexProd();
+
     void 
     read(std::istream& s);
 
@@ -140,7 +153,7 @@ public:
     operator*=(const ITensor& other);
 
     ITensor 
-    operator*(ITensor other) const { other *= *this; return other; }
+    operator*(ITensor other) const { other *= *this; return handover(other); }
 
     ITensor& 
     operator*=(const IndexVal& iv) 
@@ -152,18 +165,22 @@ public:
 
     friend inline ITensor 
     operator*(const IndexVal& iv, ITensor t) 
-        { return (t *= iv); }
+        { t *= iv; return handover(t); }
 
     ITensor& 
     operator*=(Real fac) { scale_ *= fac; return *this; }
 
+    //Multiplies the scale, without converting fac to a Real
+    ITensor& 
+    operator*=(const LogNumber& fac) { scale_ *= fac; return *this; }
+
     ITensor 
     operator*(Real fac) const 
         { ITensor res(*this); res *= fac; return res; }
 
     friend inline ITensor 
     operator*(Real fac, ITensor t) 
-        { return (t *= fac); }
+        { t *= fac; return handover(t); }
 
     ITensor& 
     operator/=(Real fac) { scale_ /= fac; return *this; }
@@ -174,7 +191,7 @@ public:
 
     friend inline ITensor 
     operator/(Real fac, ITensor t) 
-        { return (t /= fac); }
+        { t /= fac; return handover(t); }
 
     //operator/=(ITensor) is actually non-contracting product
     ITensor& 
@@ -187,9 +204,9 @@ public:
     ITensor& 
     operator+=(const ITensor& o);
 
-    ITensor 
-    operator+(const ITensor& o) const 
-        { ITensor res(*this); res += o; return res; }
+    //Sums are lazy, see ITensorSum below
+    ITensorSum 
+    operator+(const ITensor& o) const;
 
     ITensor& 
     operator-=(const ITensor& o)
@@ -198,9 +215,14 @@ public:
         scale_ *= -1; operator+=(o); scale_ *= -1; return *this; 
         }
 
-    ITensor 
-    operator-(const ITensor& o) const 
-        { ITensor res(*this); res -= o; return res; }
+    ITensorSum 
+    operator-(const ITensor& o) const;
+
+    ITensor& 
+    operator+=(const ITensorSum& S);
+
+    ITensor& 
+    operator-=(const ITensorSum& S);
 
 
     //Index Methods ---------------------------------------------------
@@ -286,25 +308,25 @@ public:
 
     friend inline ITensor 
     primed(ITensor A, int inc = 1)
-        { A.doprime(primeBoth,inc); return A; }
+        { A.doprime(primeBoth,inc); return handover(A); }
 
     friend inline ITensor 
     primesite(ITensor A, int inc = 1)
-        { A.doprime(primeSite,inc); return A; }
+        { A.doprime(primeSite,inc); return handover(A); }
 
     friend inline ITensor 
     primelink(ITensor A, int inc = 1)
-        { A.doprime(primeLink,inc); return A; }
+        { A.doprime(primeLink,inc); return handover(A); }
 
     friend inline ITensor 
     primeind(ITensor A, const Index& I)
-        { A.mapindex(I,primed(I)); return A; }
+        { A.mapindex(I,primed(I)); return handover(A); }
 
     friend ITensor 
     primeind(ITensor A, const Index& I1, const Index& I2);
 
     friend inline ITensor 
-    deprimed(ITensor A) { A.noprime(); return A; }
+    deprimed(ITensor A) { A.noprime(); return handover(A); }
 
 
     //Element Access Methods ----------------------------------------
@@ -348,6 +370,11 @@ public:
 
     //Methods for Mapping to Other Objects ----------------------------------
 
+    //Exchange contents with other without touching any 
+    //reference counts (see handover in types.h)
+    void
+    swap(ITensor& other);
+
     // Assume *this and other have same indices but different order.
     // Copy other into *this, without changing the order of indices in either
     // operator= would put the order of other into *this
@@ -369,7 +396,7 @@ public:
     friend inline ITensor
     tieIndices(const Index& i1, const Index& i2, 
                const Index& tied, ITensor T)
-        { T.tieIndices(i1,i2,tied); return T; }
+        { T.tieIndices(i1,i2,tied); return handover(T); }
 
     void
     tieIndices(const Index& i1, const Index& i2,
@@ -379,7 +406,7 @@ public:
     friend inline ITensor
     tieIndices(const Index& i1, const Index& i2, 
                const Index& i3, const Index& tied, ITensor T)
-        { T.tieIndices(i1,i2,i3,tied); return T; }
+        { T.tieIndices(i1,i2,i3,tied); return handover(T); }
 
     void
     tieIndices(const Index& i1, const Index& i2,
@@ -390,7 +417,7 @@ public:
     tieIndices(const Index& i1, const Index& i2, 
                const Index& i3, const Index& i4, 
                const Index& tied, ITensor T)
-        { T.tieIndices(i1,i2,i3,i4,tied); return T; }
+        { T.tieIndices(i1,i2,i3,i4,tied); return handover(T); }
 
     void 
     expandIndex(const Index& small, const Index& big, 
@@ -452,12 +479,8 @@ public:
     void 
     SplitReIm(ITensor& re, ITensor& im) const;
 
-    inline void 
-    conj() 
-        { 
-        if(!is_complex()) return; 
-        operator/=(ITensor::ConjTensor()); 
-        }
+    void 
+    conj();
 
     inline bool 
     is_zero() const { return (norm() < 1E-20); } 
@@ -480,6 +503,21 @@ public:
     friend std::ostream& 
     operator<<(std::ostream & s, const ITensor & t);
 
+    //Contraction plans (ProductProps) are cached by the
+    //index structure of both operands of operator*= and /=
+
+    //Number of products which reused a cached plan
+    static int 
+    planCacheHits();
+
+    //Number of products which had to make a new plan
+    static int 
+    planCacheMisses();
+
+    //Empty the cache of the calling thread and reset the counters
+    static void 
+    clearPlanCache();
+
     friend class commaInit;
 
     typedef Index IndexT;
@@ -545,12 +583,31 @@ private:
     void 
     getperm(const boost::array<Index,NMAX+1>& oth_index_, Permutation& P) const;
 
+    //Stride of the ReIm Index in the storage: runs of this many
+    //real parts alternate with runs of as many imaginary parts
+    int 
+    reImStride() const;
+
+    //Complex tensor re + i*im, for re and im with the same indices
+    static ITensor 
+    joinReIm(const ITensor& re, const ITensor& im);
+
     friend struct ProductProps;
 
     friend void toMatrixProd(const ITensor& L, const ITensor& R, 
                              const ProductProps& pp,
                              MatrixRefNoLink& lref, MatrixRefNoLink& rref);
 
+    friend void batchMatrixProd(const ITensor& L, const ITensor& R, 
+                                const ProductProps& pp, Vector& res);
+
+    friend class ITensorSum;
+
+    friend Real Dot(const ITensor& x, const ITensor& y, bool doconj);
+
+    friend void Dot(const ITensor& x, const ITensor& y, Real& re, Real& im, 
+                    bool doconj);
+
 
     int _ind(int i1, int i2, int i3, int i4, 
              int i5, int i6, int i7, int i8) const;
@@ -571,6 +628,136 @@ public:
 
     }; // class ITensor
 
+//
+// ITensorSum
+//
+// Linear combination of ITensors made by operator+ and
+// operator-. Since scaling an ITensor only changes its
+// LogNumber scale, a*A + b*B - C just records shallow copies
+// of the three terms. On conversion to ITensor they are
+// summed in a single pass over storage into one new
+// allocation, instead of copying and re-adding an
+// intermediate for every + or -. Terms with a different
+// Index order than the first (or complex ones) are added
+// afterwards with operator+=, one fused permute-and-add
+// pass each.
+//
+// Holds copies rather than references, so it is safe
+// to keep one around, though it is meant to be converted
+// right away.
+//
+class ITensorSum
+    {
+public:
+
+    explicit
+    ITensorSum(const ITensor& A)
+        { term_.reserve(4); term_.push_back(A); }
+
+    explicit
+    ITensorSum(const std::vector<ITensor>& T) : term_(T) { }
+
+    ITensorSum(const ITensor& A, const ITensor& B, Real fb = 1)
+        { 
+        term_.reserve(4); 
+        term_.push_back(A); 
+        term_.push_back(B); 
+        term_.back() *= fb; 
+        }
+
+    int 
+    nterm() const { return term_.size(); }
+
+    ITensorSum& 
+    operator+=(const ITensor& T) { term_.push_back(T); return *this; }
+
+    ITensorSum& 
+    operator-=(const ITensor& T) 
+        { term_.push_back(T); term_.back() *= -1; return *this; }
+
+    ITensorSum& 
+    operator+=(const ITensorSum& S) 
+        { term_.insert(term_.end(),S.term_.begin(),S.term_.end()); return *this; }
+
+    ITensorSum& 
+    operator-=(const ITensorSum& S);
+
+    ITensorSum& 
+    operator*=(Real fac);
+
+    ITensorSum& 
+    operator/=(Real fac) { return operator*=(1./fac); }
+
+    operator ITensor() const { ITensor res; eval(res); return res; }
+
+    //Sum the terms into res (which may be one of them)
+    void 
+    eval(ITensor& res) const;
+
+private:
+
+    std::vector<ITensor> term_;
+
+    };
+
+inline void 
+swap(ITensor& A, ITensor& B) { A.swap(B); }
+
+//Sums terms into res (which may be one of them) as an
+//ITensorSum, in one pass over storage instead of one per term
+void 
+sum(const std::vector<ITensor>& terms, ITensor& res);
+
+inline ITensor 
+conj(ITensor T) { T.conj(); return handover(T); }
+
+inline ITensorSum ITensor::
+operator+(const ITensor& o) const { return ITensorSum(*this,o); }
+
+inline ITensorSum ITensor::
+operator-(const ITensor& o) const { return ITensorSum(*this,o,-1); }
+
+inline ITensorSum 
+operator+(ITensorSum S, const ITensor& T) { return (S += T); }
+
+inline ITensorSum 
+operator-(ITensorSum S, const ITensor& T) { return (S -= T); }
+
+inline ITensorSum 
+operator+(const ITensor& T, const ITensorSum& S) 
+    { ITensorSum res(T); return (res += S); }
+
+inline ITensorSum 
+operator-(const ITensor& T, const ITensorSum& S) 
+    { ITensorSum res(T); return (res -= S); }
+
+inline ITensorSum 
+operator+(ITensorSum S, const ITensorSum& O) { return (S += O); }
+
+inline ITensorSum 
+operator-(ITensorSum S, const ITensorSum& O) { return (S -= O); }
+
+inline ITensorSum 
+operator*(ITensorSum S, Real fac) { return (S *= fac); }
+
+inline ITensorSum 
+operator*(Real fac, ITensorSum S) { return (S *= fac); }
+
+inline ITensorSum 
+operator/(ITensorSum S, Real fac) { return (S /= fac); }
+
+inline ITensor& ITensor::
+operator-=(const ITensorSum& S) { return operator+=(-1*S); }
+
+//Contracting a sum evaluates it first
+inline ITensor 
+operator*(const ITensorSum& S, ITensor T) 
+    { T *= ITensor(S); return handover(T); }
+
+inline ITensor 
+operator*(const ITensor& T, const ITensorSum& S) 
+    { ITensor res(S); res *= T; return res; }
+
 //
 // Counter
 //
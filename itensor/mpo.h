@@ -19,6 +19,7 @@ private:
     using Parent::right_orth_lim;
     using Parent::model_;
     using Parent::svd_;
+    using Parent::touch_all;
 public:
 
     operator MPOt<IQTensor>()
@@ -26,6 +27,7 @@ public:
         MPOt<IQTensor> res(*model_,maxm(),cutoff(),doRelCutoff(),refNorm()); 
         res.svd_ = svd_;
         convertToIQ(*model_,A,res.A);
+        res.touch_all();
         return res; 
     }
 
@@ -45,6 +47,7 @@ public:
 
     using Parent::AA;
     using Parent::AAnc;
+    using Parent::rev;
     using Parent::bondTensor;
 
     using Parent::doRelCutoff;
@@ -75,6 +78,8 @@ public:
 
     MPOt(BaseModel& model, std::istream& s) { read(model,s); }
 
+    void swap(MPOt& other) { Parent::swap(other); }
+
     virtual ~MPOt() { }
 
     using Parent::read;
@@ -84,11 +89,11 @@ public:
 
     MPOt& operator*=(Real a) { Parent::operator*=(a); return *this; }
     inline MPOt operator*(Real r) const { MPOt res(*this); res *= r; return res; }
-    friend inline MPOt operator*(Real r, MPOt res) { res *= r; return res; }
+    friend inline MPOt operator*(Real r, MPOt res) { res *= r; return handover(res); }
 
     MPOt& operator+=(const MPOt& oth) { Parent::operator+=(oth); return *this; }
-    inline MPOt operator+(MPOt res) const { res += *this; return res; }
-    inline MPOt operator-(MPOt res) const { res *= -1; res += *this; return res; }
+    inline MPOt operator+(MPOt res) const { res += *this; return handover(res); }
+    inline MPOt operator-(MPOt res) const { res *= -1; res += *this; return handover(res); }
 
     //MPOt: index methods --------------------------------------------------
 
@@ -317,6 +322,132 @@ Real psiHphi(const MPSType& psi, const MPOType& H, const MPSType& phi) //Re[<psi
     return re;
 }
 
+//
+// Computes <psi|phi> or <psi|H|phi> like psiphi and psiHphi,
+// keeping the partial contractions (environments) from the
+// left and right edges. Each is tagged with the revisions of
+// the site tensors it contains, so after changes to a few sites
+// (a bond optimized, a gate applied, the orthogonality center 
+// moved) only the environments across those sites are redone.
+// psi, H and phi must outlive the cache.
+//
+template <class MPSType, class MPOType = MPOt<typename MPSType::TensorT> >
+class EnvCache
+{
+public:
+    typedef typename MPSType::TensorT Tensor;
+
+    EnvCache(const MPSType& psi, const MPSType& phi)
+        : psi_(psi), phi_(phi), H_(0)
+        { init(); }
+
+    EnvCache(const MPSType& psi, const MPOType& H, const MPSType& phi)
+        : psi_(psi), phi_(phi), H_(&H)
+        { init(); }
+
+    void value(Real& re, Real& im);
+
+    Real value()
+    {
+        Real re, im;
+        value(re,im);
+        if(fabs(im) > 1.0e-12 * fabs(re))
+            std::cerr << "Real EnvCache::value: WARNING, dropping non-zero imaginary part.\n";
+        return re;
+    }
+
+    //Number of sites contracted into environments by the
+    //last call to value
+    int nupdated() const { return nupdated_; }
+
+private:
+    struct Rev 
+        { 
+        long psi, H, phi; 
+        Rev() : psi(0), H(0), phi(0) { }
+        bool operator==(const Rev& o) const 
+            { return psi == o.psi && H == o.H && phi == o.phi; }
+        };
+
+    const MPSType& psi_;
+    const MPSType& phi_;
+    const MPOType* H_;
+    int N, nupdated_;
+    int lastsite_; //site where psi was dotted in by the last call
+    std::vector<Tensor> L, R; //L[j]: sites 1..j, R[j]: sites j..N
+    std::vector<Rev> Lrev, Rrev; //revisions of site j when L[j], R[j] were made
+
+    void init()
+    {
+        N = psi_.NN();
+        if(phi_.NN() != N || (H_ != 0 && H_->NN() != N)) 
+            Error("EnvCache: mismatched N");
+        L.resize(N+2); R.resize(N+2);
+        Lrev.resize(N+2); Rrev.resize(N+2);
+        nupdated_ = 0;
+        lastsite_ = 0;
+    }
+
+    Rev rev(int j) const
+    {
+        Rev r;
+        r.psi = psi_.rev(j); r.phi = phi_.rev(j);
+        if(H_ != 0) r.H = H_->rev(j);
+        return r;
+    }
+
+    //Contracts site j into E
+    void addSite(Tensor& E, int j) const
+    {
+        if(E.is_null()) E = phi_.AA(j); else E *= phi_.AA(j);
+        if(H_ != 0) { E *= H_->AA(j); E *= conj(primed(psi_.AA(j))); }
+        else E *= conj(primelink(psi_.AA(j)));
+    }
+
+    void updateL(int j)
+    { L[j] = L[j-1]; addSite(L[j],j); Lrev[j] = rev(j); ++nupdated_; }
+
+    void updateR(int j)
+    { R[j] = R[j+1]; addSite(R[j],j); Rrev[j] = rev(j); ++nupdated_; }
+};
+
+template <class MPSType, class MPOType>
+void EnvCache<MPSType,MPOType>::
+value(Real& re, Real& im)
+{
+    //L[1..lv] and R[rv..N] are still valid
+    int lv = 0;
+    while(lv < N && Lrev[lv+1] == rev(lv+1)) ++lv;
+    int rv = N+1;
+    while(rv > 1 && Rrev[rv-1] == rev(rv-1)) --rv;
+
+    nupdated_ = 0;
+    if(lv == 0 && rv == N+1)
+    {
+        //Nothing cached: make every environment, so that later
+        //changes only cost the sites around them
+        for(int j = 1; j < N; ++j) updateL(j);
+        for(int j = N; j > 1; --j) updateR(j);
+        lv = N-1; rv = 2;
+    }
+
+    //Contract the changed sites lv+1..rv-1 into the left and
+    //right environments of the site s where psi is dotted in.
+    //s is the end of the changed sites away from the last one,
+    //which follows the orthogonality center in either direction
+    const int lo = max(1,min(N,min(lv+1,rv-1))),
+              hi = max(1,min(N,max(lv+1,rv-1)));
+    const int s = (lastsite_ <= lo ? hi : lo);
+    lastsite_ = s;
+    for(int j = lv+1; j < s; ++j) updateL(j);
+    for(int j = rv-1; j > s; --j) updateR(j);
+
+    Tensor X = (s > 1 ? L[s-1] * phi_.AA(s) : phi_.AA(s));
+    if(H_ != 0) X *= H_->AA(s);
+    if(s < N) X *= R[s+1];
+    Dot((H_ != 0 ? primed(psi_.AA(s)) : primelink(psi_.AA(s))),X,re,im);
+}
+
 inline void psiHphi(const MPS& psi, const MPO& H, const ITensor& LB, const ITensor& RB, const MPS& phi, Real& re, Real& im) //<psi|H|phi>
 {
     int N = psi.NN();
@@ -2,6 +2,7 @@
 #define __MPS_H
 #include "svdworker.h"
 #include "model.h"
+#include "DMRGOpts.h"
 
 static const LogNumber DefaultRefScale(7.58273202392352185);
 
@@ -10,6 +11,12 @@ void convertToIQ(const BaseModel& model, const std::vector<ITensor>& A, std::vec
 template<class Tensor, class TensorSet>
 Real doDavidson(Tensor& phi, const TensorSet& mpoh, const TensorSet& LH, const TensorSet& RH, int niter, int debuglevel, Real errgoal);
 
+class BaseDMRGOpts;
+
+template<class Tensor, class TensorSet>
+Real doDavidson(Tensor& phi, const TensorSet& mpoh, const TensorSet& LH, const TensorSet& RH, int niter, int debuglevel, Real errgoal,
+                const BaseDMRGOpts& opts, int& nproduct);
+
 template<class Tensor, class IndexT>
 IndexT index_in_common(const Tensor& A, const Tensor& B, IndexType t)
 {
@@ -60,6 +67,17 @@ protected:
     const ModelT* model_;
     SVDWorker svd_;
 
+    //Every change to A[i] gives it a new revision number, unique 
+    //among all MPSt's, so a cached contraction involving A[i] can
+    //tell whether it is still valid (see rev)
+    std::vector<long> rev_;
+
+    static long new_rev() 
+        { static long last_rev = 0; return __sync_add_and_fetch(&last_rev,1); }
+    void touch(int i) { GET(rev_,i) = new_rev(); }
+    void touch_all() 
+        { rev_.resize(N+1); for(int i = 1; i <= N; ++i) rev_[i] = new_rev(); }
+
     void new_tensors(std::vector<ITensor>& A_)
     {
         std::vector<Index> a(N+1);
@@ -123,10 +141,13 @@ public:
     const Tensor& AA(int i) const { return GET(A,i); }
     const ModelT& model() const { return *model_; }
     const SVDWorker& svd() const { return svd_; }
+    //Revision of A[i]: equal revisions mean identical tensors
+    long rev(int i) const { return GET(rev_,i); }
     Tensor& AAnc(int i) //nc means 'non const'
     { 
         if(i <= left_orth_lim) left_orth_lim = i-1;
         if(i >= right_orth_lim) right_orth_lim = i+1;
+        touch(i);
         return GET(A,i); 
     }
     Tensor& setU(int i, Direction dir) //set unitary
@@ -141,6 +162,7 @@ public:
         if(i == right_orth_lim-1) right_orth_lim = i;
         else Error("right_orth_lim not at i-1");
         }
+        touch(i);
         return GET(A,i);
     }
     bool is_null() const { return (model_==0); }
@@ -152,6 +174,12 @@ public:
     bool absoluteCutoff() const { return svd_.absoluteCutoff(); }
     void absoluteCutoff(bool val) { svd_.absoluteCutoff(val); }
 
+    bool useSVD() const { return svd_.useSVD(); }
+    void useSVD(bool val) { svd_.useSVD(val); }
+
+    bool partialDiag() const { return svd_.partialDiag(); }
+    void partialDiag(bool val) { svd_.partialDiag(val); }
+
     LogNumber refNorm() const { return svd_.refNorm(); }
     void refNorm(LogNumber val) { svd_.refNorm(val); }
 
@@ -181,10 +209,11 @@ public:
         { }
 
     MPSt(const ModelT& mod_,int maxmm = MAX_M, Real cut = MIN_CUT) 
-    : N(mod_.NN()), A(mod_.NN()+1),left_orth_lim(0),right_orth_lim(mod_.NN()),
+    : N(mod_.NN()), A(mod_.NN()+1),left_orth_lim(0),right_orth_lim(mod_.NN()+1),
     model_(&mod_), svd_(N,cut,1,maxmm,false,LogNumber(1))
         { 
         random_tensors(A);
+        touch_all();
         }
 
     MPSt(const ModelT& mod_,const InitState& initState,int maxmm = MAX_M, Real cut = MIN_CUT) 
@@ -192,6 +221,7 @@ public:
     model_(&mod_), svd_(N,cut,1,maxmm,false,LogNumber(1))
         { 
         init_tensors(A,initState);
+        touch_all();
         }
 
     MPSt(const ModelT& model, std::istream& s)
@@ -202,6 +232,19 @@ public:
 
     virtual ~MPSt() { }
 
+    //Exchange contents with other; the site tensors are
+    //not copied (see handover in types.h)
+    void swap(MPSt& other)
+        {
+        std::swap(N,other.N);
+        A.swap(other.A);
+        std::swap(left_orth_lim,other.left_orth_lim);
+        std::swap(right_orth_lim,other.right_orth_lim);
+        std::swap(model_,other.model_);
+        std::swap(svd_,other.svd_);
+        rev_.swap(other.rev_);
+        }
+
     void read(std::istream& s)
         {
         if(model_ == 0)
@@ -212,6 +255,7 @@ public:
         s.read((char*) &left_orth_lim,sizeof(left_orth_lim));
         s.read((char*) &right_orth_lim,sizeof(right_orth_lim));
         svd_.read(s);
+        touch_all();
         }
 
     void write(std::ostream& s) const
@@ -232,23 +276,23 @@ public:
         return *this;
     }
     inline MPSt operator*(Real r) const { MPSt res(*this); res *= r; return res; }
-    friend inline MPSt operator*(Real r, MPSt res) { res *= r; return res; }
+    friend inline MPSt operator*(Real r, MPSt res) { res *= r; return handover(res); }
 
     MPSt& operator+=(const MPSt& oth);
-    inline MPSt operator+(MPSt res) const { res += *this; return res; }
+    inline MPSt operator+(MPSt res) const { res += *this; return handover(res); }
     //friend inline MPSt operator+(MPSt A, const MPSt& B) { A += B; return A; }
-    inline MPSt operator-(MPSt res) const { res *= -1; res += *this; return res; }
+    inline MPSt operator-(MPSt res) const { res *= -1; res += *this; return handover(res); }
 
     //MPSt: index methods --------------------------------------------------
 
     void mapprime(int oldp, int newp, PrimeType pt = primeBoth)
-	{ for(int i = 1; i <= N; ++i) A[i].mapprime(oldp,newp,pt); }
+	{ for(int i = 1; i <= N; ++i) A[i].mapprime(oldp,newp,pt); touch_all(); }
 
     void primelinks(int oldp, int newp)
-	{ for(int i = 1; i <= N; ++i) A[i].mapprime(oldp,newp,primeLink); }
+	{ for(int i = 1; i <= N; ++i) A[i].mapprime(oldp,newp,primeLink); touch_all(); }
 
     void noprimelink()
-	{ for(int i = 1; i <= N; ++i) A[i].noprime(primeLink); }
+	{ for(int i = 1; i <= N; ++i) A[i].noprime(primeLink); touch_all(); }
 
     IndexT LinkInd(int b) const 
         { return index_in_common(AA(b),AA(b+1),Link); }
@@ -279,6 +323,8 @@ public:
         }
 
         svd_(b,AA,A[b],A[b+1],dir);
+        touch(b);
+        touch(b+1);
                  
         if(dir == Fromleft)
         {
@@ -398,6 +444,16 @@ public:
     template<class TensorSet>
     Real bondDavidson(int b, const TensorSet& mpoh, const TensorSet& LH, const TensorSet& RH, 
     int niter, int debuglevel, Direction dir, Real errgoal=1E-4)
+    {
+        int nproduct = 0;
+        return bondDavidson(b,mpoh,LH,RH,niter,debuglevel,dir,errgoal,DMRGOpts(),nproduct);
+    }
+
+    //As above, with the Davidson settings of opts (preconditioning,
+    //threads); nproduct is set to the number of Davidson iterations
+    template<class TensorSet>
+    Real bondDavidson(int b, const TensorSet& mpoh, const TensorSet& LH, const TensorSet& RH, 
+    int niter, int debuglevel, Direction dir, Real errgoal, const BaseDMRGOpts& opts, int& nproduct)
     {
         if(b-1 > left_orth_lim)
         {
@@ -410,7 +466,7 @@ public:
             Error("b+1 < right_orth_lim");
         }
         Tensor phi = GET(A,b); phi *= GET(A,b+1);
-        Real En = doDavidson(phi,mpoh,LH,RH,niter,debuglevel,errgoal);
+        Real En = doDavidson(phi,mpoh,LH,RH,niter,debuglevel,errgoal,opts,nproduct);
         doSVD(b,phi,dir);
         return En;
     }
@@ -443,7 +499,65 @@ public:
         doSVD(left_orth_lim+1,AA,Fromleft);
 	}
 
-    Real norm() const { return sqrt(psiphi(*this,*this)); }
+    //At the orthogonality center the rest of the chain
+    //contracts to the identity, leaving the center's norm
+    Real norm() const 
+    { 
+        if(is_ortho()) return fabs(AA(ortho_center()).norm());
+        return sqrt(psiphi(*this,*this)); 
+    }
+
+    //<psi|op|psi>/<psi|psi> for an operator op on site i (with
+    //indices si(i) and siP(i)). Only the sites between i and the 
+    //orthogonality center are contracted, the others being 
+    //orthogonal; without a center the whole chain is.
+    void expect(int i, const Tensor& op, Real& re, Real& im) const
+    {
+        int first = 1, last = N;
+        Real nrm2 = 0;
+        if(is_ortho())
+        {
+            const int c = ortho_center();
+            first = min(i,c); last = max(i,c);
+            nrm2 = sqr(AA(c).norm());
+        }
+        else nrm2 = psiphi(*this,*this);
+
+        //Sites first..i-1 and i+1..last, the links
+        //beyond them contracting to the identity
+        Tensor X = AA(i);
+        if(first < i)
+        {
+            Tensor L = AA(first) * conj(primeind(AA(first),RightLinkInd(first)));
+            for(int j = first+1; j < i; ++j)
+                { L *= AA(j); L *= conj(primelink(AA(j))); }
+            X *= L;
+        }
+        if(last > i)
+        {
+            Tensor R = AA(last) * conj(primeind(AA(last),LeftLinkInd(last)));
+            for(int j = last-1; j > i; --j)
+                { R *= AA(j); R *= conj(primelink(AA(j))); }
+            X *= R;
+        }
+        X *= op;
+
+        Tensor Ai = AA(i); 
+        Ai.mapprime(0,1,primeSite);
+        if(first < i) Ai.primeind(LeftLinkInd(i));
+        if(last > i) Ai.primeind(RightLinkInd(i));
+        Dot(Ai,X,re,im);
+        re /= nrm2; im /= nrm2;
+    }
+
+    Real expect(int i, const Tensor& op) const
+    {
+        Real re, im;
+        expect(i,op,re,im);
+        if(fabs(im) > 1.0e-12 * fabs(re))
+            std::cerr << "Real expect: WARNING, dropping non-zero imaginary part of expectation value.\n";
+        return re;
+    }
 
     Real normalize()
     {
@@ -471,6 +585,7 @@ public:
         iqpsi = MPSt<IQTensor>(*model_,maxm(),cutoff());
         iqpsi.svd_ = svd_;
         convertToIQ(*model_,A,iqpsi.A,totalq,cut);
+        iqpsi.touch_all();
     }
 
 private:
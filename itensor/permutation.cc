@@ -0,0 +1,182 @@
+#include "permutation.h"
+#include <algorithm>
+
+//Edge length of the square tiles used when the
+//fastest source and destination indices differ
+static const int PERM_TILE = 16;
+
+//
+// One (possibly fused) index of a permutation:
+// its dimension and its strides in src and dest
+//
+struct PermDim
+    {
+    int m, sstr, dstr;
+    };
+
+inline bool
+dstrLess(const PermDim& a, const PermDim& b) { return a.dstr < b.dstr; }
+
+//
+// Element operations applied by permuteWith:
+// dest = src, and dest = a*dest + b*src
+//
+struct PermCopy
+    {
+    void
+    operator()(Real& d, Real s) const { d = s; }
+    };
+
+struct PermAxpby
+    {
+    Real a, b;
+    PermAxpby(Real a_, Real b_) : a(a_), b(b_) { }
+    void
+    operator()(Real& d, Real s) const { d = a*d + b*s; }
+    };
+
+struct PermAxpy
+    {
+    Real b;
+    PermAxpy(Real b_) : b(b_) { }
+    void
+    operator()(Real& d, Real s) const { d += b*s; }
+    };
+
+//Applies op along a run of n elements which are
+//contiguous in both src and dest
+template <class Op>
+inline void
+runApply(const Real* src, Real* dest, int n, const Op& op)
+    { for(int i = 0; i < n; ++i) op(dest[i],src[i]); }
+
+inline void
+runApply(const Real* src, Real* dest, int n, const PermCopy&)
+    { std::copy(src,src+n,dest); }
+
+//
+// Applies op to a block which is fast (unit stride) along f
+// in dest and fast along s in src, working in tiles so that
+// both the reads and the writes stay in cache.
+//
+template <class Op>
+static void
+tiledApply(const PermDim& f, const PermDim& s, const Real* src, Real* dest,
+           const Op& op)
+    {
+    for(int jj = 0; jj < s.m; jj += PERM_TILE)
+        {
+        const int jlim = std::min(jj+PERM_TILE,s.m);
+        for(int ii = 0; ii < f.m; ii += PERM_TILE)
+            {
+            const int ilim = std::min(ii+PERM_TILE,f.m);
+            for(int j = jj; j < jlim; ++j)
+                {
+                const Real* sp = src + j;
+                Real* dp = dest + j*s.dstr;
+                for(int i = ii; i < ilim; ++i)
+                    op(dp[i],sp[i*f.sstr]);
+                }
+            }
+        }
+    }
+
+template <class Op>
+static void
+permuteWith(const Permutation& P, const boost::array<int,NMAX+1>& dims,
+            int r, const Real* src, Real* dest, const Op& op)
+    {
+    //Strides of each index of dest
+    boost::array<int,NMAX+2> dpos_str;
+    boost::array<int,NMAX+1> ddims;
+    ddims.assign(1);
+    for(int j = 1; j <= r; ++j) ddims[P.dest(j)] = dims[j];
+    dpos_str[1] = 1;
+    for(int k = 1; k <= r; ++k) dpos_str[k+1] = dpos_str[k]*ddims[k];
+
+    //Plan: drop m==1 indices and fuse indices which
+    //are adjacent in both src and dest
+    PermDim pd[NMAX];
+    int n = 0;
+    int sstr = 1;
+    for(int j = 1; j <= r; ++j)
+        {
+        if(dims[j] == 1) continue;
+        const int dstr = dpos_str[P.dest(j)];
+        if(n > 0 && pd[n-1].sstr*pd[n-1].m == sstr
+                 && pd[n-1].dstr*pd[n-1].m == dstr)
+            {
+            pd[n-1].m *= dims[j];
+            }
+        else
+            {
+            pd[n].m = dims[j];
+            pd[n].sstr = sstr;
+            pd[n].dstr = dstr;
+            ++n;
+            }
+        sstr *= dims[j];
+        }
+
+    if(n <= 1)
+        {
+        runApply(src,dest,sstr,op);
+        return;
+        }
+
+    //Order indices as they appear in dest, so
+    //pd[0] is the unit stride index of dest
+    std::sort(pd,pd+n,dstrLess);
+
+    //Find the unit stride index of src
+    int a = 0;
+    while(pd[a].sstr != 1) ++a;
+
+    //Remaining indices are looped over "odometer" style,
+    //fastest-in-dest first so the writes are nearly sequential
+    PermDim od[NMAX];
+    int cnt[NMAX];
+    int no = 0;
+    for(int k = 1; k < n; ++k)
+        {
+        if(k == a) continue;
+        od[no] = pd[k];
+        cnt[no] = 0;
+        ++no;
+        }
+
+    for(;;)
+        {
+        if(a == 0)
+            runApply(src,dest,pd[0].m,op);
+        else
+            tiledApply(pd[0],pd[a],src,dest,op);
+
+        int k = 0;
+        for(; k < no; ++k)
+            {
+            src += od[k].sstr;
+            dest += od[k].dstr;
+            if(++cnt[k] < od[k].m) break;
+            src -= od[k].sstr*od[k].m;
+            dest -= od[k].dstr*od[k].m;
+            cnt[k] = 0;
+            }
+        if(k == no) break;
+        }
+    }
+
+void
+permuteData(const Permutation& P, const boost::array<int,NMAX+1>& dims,
+            int r, const Real* src, Real* dest)
+    {
+    permuteWith(P,dims,r,src,dest,PermCopy());
+    }
+
+void
+permuteAddData(const Permutation& P, const boost::array<int,NMAX+1>& dims,
+               int r, Real a, Real b, const Real* src, Real* dest)
+    {
+    if(a == 1) permuteWith(P,dims,r,src,dest,PermAxpy(b));
+    else       permuteWith(P,dims,r,src,dest,PermAxpby(a,b));
+    }
@@ -97,6 +97,27 @@ set8(int9 *n, int i1, int i2, int i3, int i4, int i5, int i6, int i7, int i8)
     (*n)[5] = i5; (*n)[6] = i6; (*n)[7] = i7; (*n)[8] = i8;
     }
 
+//
+// Copy the column-major array src, whose
+// indices have dimensions dims[1],...,dims[r],
+// into dest such that index j of src becomes
+// index P.dest(j) of dest.
+// Adjacent indices are fused and the two fastest
+// indices are handled in cache-sized tiles, so
+// any rank and any permutation is efficient.
+//
+void 
+permuteData(const Permutation& P, const boost::array<int,NMAX+1>& dims, 
+            int r, const Real* src, Real* dest);
+
+//
+// Like permuteData, but sets dest to a*dest + b*P(src)
+// in the same single pass.
+//
+void 
+permuteAddData(const Permutation& P, const boost::array<int,NMAX+1>& dims, 
+               int r, Real a, Real b, const Real* src, Real* dest);
+
 inline std::ostream& 
 operator<<(std::ostream& s, const Permutation& p)
     {
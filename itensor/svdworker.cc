@@ -6,6 +6,127 @@ using std::cerr;
 using std::endl;
 using std::pair;
 
+//Oversampling and power iterations of partialEigen
+static const int partial_oversample = 10;
+static const int partial_npower = 2;
+
+//Use partialEigen only if a block is at least this
+//many times larger than the number of states sought
+static const int partial_minratio = 2;
+
+//Uniform pseudo-random number in [-1,1) from a linear
+//congruential generator, so results are reproducible
+//and the state of ran1 is left alone
+static Real
+lcgRandom(unsigned long& seed)
+    {
+    seed = seed*1103515245UL + 12345UL;
+    return ((seed >> 16) & 0x7fff)/16384.0 - 1.0;
+    }
+
+//Orthonormalize the columns of Q by Gram-Schmidt, twice 
+//per column. Unlike Orthog, a column (nearly) dependent on 
+//the previous ones is replaced by a random one: M*Q has 
+//such columns whenever M has rank less than k
+static void
+orthonormalize(Matrix& Q, unsigned long& seed)
+    {
+    Vector dots;
+    for(int j = 1; j <= Q.Ncols(); ++j)
+        {
+        VectorRef col;
+        col << Q.Column(j);
+        Real nrm0 = Norm(col);
+        for(int tries = 0; tries < 2; ++tries)
+            {
+            if(j > 1)
+                {
+                MatrixRef prev = Q.Columns(1,j-1);
+                for(int pass = 1; pass <= 2; ++pass)
+                    {
+                    dots = prev.t() * col;
+                    col -= prev * dots;
+                    }
+                }
+            Real nrm = Norm(col);
+            if(nrm > 1E-10*nrm0 && nrm > 0) 
+                { col /= nrm; break; }
+            for(int i = 1; i <= Q.Nrows(); ++i) Q(i,j) = lcgRandom(seed);
+            col << Q.Column(j);
+            nrm0 = Norm(col);
+            }
+        }
+    }
+
+//Leading k eigenpairs of the symmetric positive semidefinite
+//matrix M by a randomized range finder: the eigenvalues d,
+//largest first, and eigenvectors as the columns of U
+static void
+partialEigen(const MatrixRef& M, int k, Vector& d, Matrix& U)
+    {
+    const int n = M.Nrows();
+
+    unsigned long seed = 12345;
+    Matrix Q(n,k);
+    for(int j = 1; j <= k; ++j)
+    for(int i = 1; i <= n; ++i)
+        Q(i,j) = lcgRandom(seed);
+
+    for(int p = 0; p <= partial_npower; ++p)
+        {
+        Q = M * Q;
+        orthonormalize(Q,seed);
+        }
+
+    //Diagonalize M projected on the range found
+    Matrix B = Q.t() * (M * Q);
+    B *= -1;
+    Matrix W;
+    EigenValues(B,d,W);
+    d *= -1;
+    U = Q * W;
+    }
+
+//All eigenpairs of the symmetric matrix M, eigenvalues
+//largest first (M is left negated)
+static void
+fullEigen(Matrix& M, Vector& d, Matrix& U)
+    {
+    M *= -1;
+    EigenValues(M,d,U);
+    d *= -1;
+    }
+
+//The result of partialEigen can be trusted only if the weight
+//it did not find and the smallest eigenvalue it found are both
+//below wcut, the cutoff expressed as a weight. Otherwise the 
+//states it missed may not be negligible and the estimate of 
+//their weight is not good enough to truncate on.
+static bool
+partialReliable(const Vector& d, Real unresolved, Real wcut)
+    {
+    return unresolved <= wcut && d(d.Length()) <= wcut;
+    }
+
+//Redo the listed blocks with fullEigen
+static void
+redoFull(const vector<int>& redo, vector<Matrix>& mrho, 
+         vector<Vector>& mvector, vector<Matrix>& mmatrix, 
+         vector<Real>& unres, vector<char>& partial, bool parallel)
+    {
+    const int nredo = (int) redo.size();
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic,1) if(parallel)
+#endif
+    for(int j = 0; j < nredo; ++j)
+        {
+        const int b = redo[j];
+        fullEigen(mrho[b],mvector[b],mmatrix[b]);
+        unres[b] = 0;
+        partial[b] = false;
+        }
+    }
+
 Real SVDWorker::diag_denmat(const ITensor& rho, Vector& D, ITensor& U)
     {
     assert(rho.r() == 2);
@@ -16,42 +137,31 @@ Real SVDWorker::diag_denmat(const ITensor& rho, Vector& D, ITensor& U)
     //Do the diagonalization
     Index ri = rho.index(1); ri.noprime();
     Matrix R,UU; rho.toMatrix11NoScale(ri,ri.primed(),R);
-    R *= -1.0; EigenValues(R,D,UU); D *= -1.0;
-
-    //Truncate
-    Real svdtruncerr = 0.0;
-    int mp = D.Length();
-    Real sca = doRelCutoff_ ? D(1) : 1.0;
-    if(absoluteCutoff_)
-        {
-        mp = minm_;
-        while(mp < maxm_ && D(mp) < cutoff_ ) 
-            svdtruncerr += D(mp++);
-        }
-    else
+    const int k = maxm_ + partial_oversample;
+    Real unresolved = 0;
+    bool partial = partialDiag_ && !absoluteCutoff_ && partial_minratio*k <= R.Nrows();
+    if(partial)
         {
-        while(mp > maxm_ || (svdtruncerr+D(mp) < cutoff_*sca && mp > minm_)) 
-            svdtruncerr += D(mp--);
+        //Weight of the states not found is discarded
+        partialEigen(R,k,D,UU);
+        unresolved = max(0.0,Trace(R)-D.sumels());
+        const Real wcut = cutoff_*(doRelCutoff_ ? D(1) : 1.0);
+        partial = partialReliable(D,unresolved,wcut);
+        if(!partial) unresolved = 0;
         }
-    if(!absoluteCutoff_)
-        { svdtruncerr = (D(1) == 0 ? 0 : svdtruncerr/sca); }
-    D.ReduceDimension(mp); 
-    if(showeigs_)
+    if(!partial) fullEigen(R,D,UU);
+
+    //Truncate
+    Real svdtruncerr = truncateEigs(D,unresolved);
+
+    //A state not found could have been kept instead of
+    //the last one: diagonalize fully and truncate again
+    if(partial && D.Length() > 0 && unresolved >= D(D.Length()))
         {
-        cout << endl;
-        cout << boost::format("truncate_ = %s")%(truncate_?"true":"false")<<endl;
-        cout << boost::format("Kept %d states in diag_denmat\n")% mp;
-        cout << boost::format("svdtruncerr = %.2E\n")%svdtruncerr;
-        //cout << "doRelCutoff is " << doRelCutoff_ << endl;
-        //cout << "refNorm is " << refNorm_ << endl;
-        int stop = min(D.Length(),10);
-        cout << "Eigs: ";
-        for(int j = 1; j <= stop; ++j)
-            {
-            cout << boost::format(D(j) > 1E-3 ? ("%.3f") : ("%.3E")) % D(j);
-            cout << ((j != stop) ? ", " : "\n");
-            }
+        fullEigen(R,D,UU);
+        svdtruncerr = truncateEigs(D);
         }
+    int mp = D.Length();
     Index newmid(active.rawname(),mp,active.type());
     U = ITensor(active,newmid,UU.Columns(1,mp));
     lastd = D;
@@ -96,6 +206,11 @@ Real SVDWorker::diag_denmat(const IQTensor& rho, Vector& D, IQTensor& U)
 
 
     //1. Diagonalize each ITensor within rho
+
+    //Gather the blocks as matrices
+    const int nblock = rho.iten_size();
+    vector<Matrix> mrho(nblock);
+    vector<pair<int,int> > bysize(nblock);
     int itenind = 0;
     for(IQTensor::const_iten_it it = rho.const_iten_begin(); it != rho.const_iten_end(); ++it)
         {
@@ -109,15 +224,76 @@ Real SVDWorker::diag_denmat(const IQTensor& rho, Vector& D, IQTensor& U)
 
         t.scaleTo(refNorm_);
 
-        Matrix &UU = GET(mmatrix,itenind);
-        Vector &d = GET(mvector,itenind);
-
-        //Diag ITensors within rho
         int n = t.index(1).m();
-        Matrix M(n,n);
+        Matrix& M = GET(mrho,itenind);
+        M.ReDimension(n,n);
         t.toMatrix11NoScale(t.index(1),t.index(2),M);
+        GET(bysize,itenind) = std::make_pair(-n,itenind);
+        ++itenind;
+        }
+
+    //Blocks are independent: diagonalize them in parallel 
+    //(when built with OpenMP), largest first. Each block
+    //is handled the same way whatever the number of threads.
+    sort(bysize.begin(),bysize.end());
+    //Worth it only if the second largest block is big too
+    const Real n2 = (nblock > 1 ? -bysize[1].first : 0);
+    const bool parallel = (n2*n2*n2 >= Globals::minBlockTaskSize());
+    const int k = maxm_ + partial_oversample;
+    const bool usePartial = partialDiag_ && !absoluteCutoff_;
+    vector<Real> unres(nblock,0);
+    vector<char> partial(nblock,false);
+    if(!usePartial)
+        {
+        //All blocks in one go: the many small ones 
+        //without LAPACK's per-call overhead
+        for(int b = 0; b < nblock; ++b) mrho[b] *= -1;
+        EigenValuesBatched(mrho,mvector,mmatrix,parallel);
+        for(int b = 0; b < nblock; ++b) mvector[b] *= -1;
+        }
+    else
+        {
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic,1) if(parallel)
+#endif
+        for(int b = 0; b < nblock; ++b)
+            {
+            const int ind = bysize[b].second;
+            Matrix& M = mrho[ind];
+            Matrix& UU = mmatrix[ind];
+            Vector& d = mvector[ind];
+            const int n = M.Nrows();
+            if(partial_minratio*k <= n)
+                {
+                //Weight of the states not found is discarded
+                partialEigen(M,k,d,UU);
+                unres[ind] = max(0.0,Trace(M)-d.sumels());
+                partial[ind] = true;
+                }
+            else
+                fullEigen(M,d,UU);
+            }
+
+        //Check the partial results against the cutoff, which
+        //for doRelCutoff_ is relative to the largest eigenvalue
+        Real e1 = 0;
+        for(int b = 0; b < nblock; ++b)
+            if(mvector[b].Length() > 0) e1 = max(e1,mvector[b](1));
+        const Real wcut = cutoff_*(doRelCutoff_ ? e1 : 1.0);
+        vector<int> redo;
+        for(int b = 0; b < nblock; ++b)
+            if(partial[b] && !partialReliable(mvector[b],unres[b],wcut))
+                redo.push_back(b);
+        redoFull(redo,mrho,mvector,mmatrix,unres,partial,parallel);
+        }
 
 #ifdef STRONG_DEBUG
+    for(int b = 0; b < nblock; ++b)
+        {
+        const Matrix& M = mrho[b];
+        const Matrix& UU = mmatrix[b];
+        const Vector& d = mvector[b];
+        const int n = M.Nrows();
         for(int r = 1; r <= n; ++r)
 	    for(int c = r+1; c <= n; ++c)
 		{
@@ -127,14 +303,8 @@ Real SVDWorker::diag_denmat(const IQTensor& rho, Vector& D, IQTensor& U)
 		    Error("M not symmetric in diag_denmat");
 		    }
 		}
-#endif //STRONG_DEBUG
-
-        M *= -1;
-        EigenValues(M,d,UU);
-        d *= -1;
 
-#ifdef STRONG_DEBUG
-        Matrix Id(UU.Nrows(),UU.Nrows()); Id = 1;
+        Matrix Id(UU.Ncols(),UU.Ncols()); Id = 1;
         Matrix Diff = Id-(UU.t()*UU);
         if(Norm(Diff.TreatAsVector()) > 1E-12)
 	    {
@@ -143,7 +313,7 @@ Real SVDWorker::diag_denmat(const IQTensor& rho, Vector& D, IQTensor& U)
 	    Error("UU not unitary in diag_denmat");
 	    }
         
-        if(fabs(d.sumels() + Trace(M))/(fabs(d.sumels())+fabs(Trace(M))) > 1E-5)
+        if(!partial[b] && fabs(d.sumels() + Trace(M))/(fabs(d.sumels())+fabs(Trace(M))) > 1E-5)
 	    {
 	    cerr << boost::format("d.sumels() = %.10f, Trace(M) = %.10f\n")
 				 % d.sumels()        % Trace(M);
@@ -168,75 +338,43 @@ Real SVDWorker::diag_denmat(const IQTensor& rho, Vector& D, IQTensor& U)
             }
         }
         */
-#endif //STRONG_DEBUG
-
-        for(int j = 1; j <= n; ++j) 
-            { alleig.push_back(d(j)); }
-        ++itenind;
         }
+#endif //STRONG_DEBUG
 
-    //2. Truncate eigenvalues
-
-    //Sort all eigenvalues from smallest to largest
-    //irrespective of quantum numbers
-    sort(alleig.begin(),alleig.end());
-
-    //Truncate
     Real docut = -1;
+    int m = 0;
     Real svdtruncerr = 0;
-    Real e1 = max(alleig.back(),1.0e-60);
-    int mdisc = 0, m = (int)alleig.size();
-    if(absoluteCutoff_)
+    for(;;)
         {
-        //Sort all eigenvalues from largest to smallest
+        Real unresolved = 0;
+        alleig.clear();
+        for(int b = 0; b < nblock; ++b)
+            {
+            unresolved += unres[b];
+            const Vector& d = mvector[b];
+            for(int j = 1; j <= d.Length(); ++j) 
+                { alleig.push_back(d(j)); }
+            }
+
+        //2. Truncate eigenvalues
+
+        //Sort all eigenvalues from smallest to largest
         //irrespective of quantum numbers
-        reverse(alleig.begin(),alleig.end());
-        m = minm_;
-        while(m < maxm_ && m < (int)alleig.size() && alleig[m-1] > cutoff_ ) 
-            svdtruncerr += alleig[m++ - 1];
-        reverse(alleig.begin(),alleig.end());
-        mdisc = (int)alleig.size() - m;
-        docut = (mdisc > 0 ?  (alleig[mdisc-1] + alleig[mdisc])*0.5 : -1);
+        sort(alleig.begin(),alleig.end());
+
+        //Truncate
+        svdtruncerr = truncateEigs(alleig,m,docut,unresolved);
+
+        //A state not found in a partially diagonalized block could
+        //have been kept instead of the last one: redo such blocks
+        if(m == 0) break;
+        const Real minkept = alleig[alleig.size()-m];
+        vector<int> redo;
+        for(int b = 0; b < nblock; ++b)
+            if(partial[b] && unres[b] >= minkept) redo.push_back(b);
+        if(redo.empty()) break;
+        redoFull(redo,mrho,mvector,mmatrix,unres,partial,parallel);
         }
-    else
-	if(m > minm_)
-	    {
-	    Real sca = doRelCutoff_ ? e1 : 1.0;
-	    for(; mdisc < (int)alleig.size(); mdisc++, m--)
-		{
-		if(((svdtruncerr += GET(alleig,mdisc)/sca) > cutoff_ && m <= maxm_) 
-			   || m <= minm_)
-		    { 
-		    docut = (mdisc > 0 ?  (alleig[mdisc-1] + alleig[mdisc])*0.5 : -1);
-		    //Overshot by one, correct truncerr
-		    svdtruncerr -= alleig[mdisc]/sca;
-		    break; 
-		    }
-		}
-	    }
-    if(showeigs_)
-	{
-        cout << endl;
-        cout << boost::format("truncate_ = %s")%(truncate_?"true":"false")<<endl;
-        cout << boost::format("Kept %d, discarded %d states in diag_denmat")
-                                     % m % mdisc << endl;
-        cout << boost::format("svdtruncerr = %.2E")%svdtruncerr << endl;
-        cout << boost::format("docut = %.2E")%docut << endl;
-        cout << boost::format("cutoff=%.2E, minm=%d, maxm=%d")%cutoff_%minm_%maxm_ << endl;
-        cout << "doRelCutoff is " << (doRelCutoff_ ? "true" : "false") << endl;
-        cout << "absoluteCutoff is " << (absoluteCutoff_ ? "true" : "false") << endl;
-        cout << "refNorm is " << refNorm_ << endl;
-        int s = alleig.size();
-        const int max_show = 20;
-        int stop = s-min(s,max_show);
-        cout << "Eigs: ";
-        for(int j = s-1; j >= stop; --j)
-	    {
-            cout << boost::format(alleig[j] > 1E-3 ? ("%.3f") : ("%.3E")) 
-                                % alleig[j];
-            cout << ((j != stop) ? ", " : "\n");
-	    }
-	}
 
     assert(m <= maxm_); 
     assert(m < 20000);
@@ -374,21 +512,131 @@ Real SVDWorker::diag_denmat_complex(const IQTensor& rho, Vector& D, IQTensor& U)
 
     //Truncate
     Real docut = -1;
-    Real svdtruncerr = 0;
-    Real e1 = max(alleig.back(),1.0e-60);
-    int mdisc = 0, m = (int)alleig.size();
-    if(absoluteCutoff_)
+    int m = 0;
+    Real svdtruncerr = truncateEigs(alleig,m,docut);
+
+    assert(m <= maxm_); 
+    assert(m < 20000);
+
+    //3. Construct orthogonalized IQTensor U
+    vector<ITensor> terms; terms.reserve(rho.iten_size());
+    vector<inqn> iq; iq.reserve(rho.iten_size());
+    itenind = 0;
+    for(IQTensor::const_iten_it it = rho.const_iten_begin(); it != rho.const_iten_end(); ++it)
 	{
-	//Sort all eigenvalues from largest to smallest
-	//irrespective of quantum numbers
-	reverse(alleig.begin(),alleig.end());
-	m = minm_;
-	while(m < maxm_ && m < (int)alleig.size() && alleig[m-1] > cutoff_ ) 
-	    svdtruncerr += alleig[m++ - 1];
-	reverse(alleig.begin(),alleig.end());
-	mdisc = (int)alleig.size() - m;
-	docut = (mdisc > 0 ?  (alleig.at(mdisc-1) + alleig[mdisc])*0.5 : -1);
+        const ITensor& t = *it;
+        const Vector& thisD = GET(mvector,itenind);
+
+        int this_m = 1;
+        for(; this_m <= thisD.Length(); ++this_m)
+            if(thisD(this_m) < docut) 
+		break;
+        --this_m; //since for loop overshoots by 1
+
+        if(m == 0 && thisD.Length() >= 1) // zero mps, just keep one arb state
+            { this_m = 1; m = 1; docut = 1; }
+
+        if(this_m == 0) 
+	    { 
+	    ++itenind; 
+	    continue; 
+	    }
+
+        Index nm("qlink",this_m);
+        Index act = t.index(1).deprimed();
+	if(docomplex && act == Index::IndReIm())
+	    act = t.index(2).deprimed();
+        iq.push_back(inqn(nm,active.qn(act)));
+
+        Matrix Utruncre = GET(mmatrixre,itenind).Columns(1,this_m);
+        Matrix Utruncim;
+	if(docomplex)
+	    Utruncim = GET(mmatrixim,itenind).Columns(1,this_m);
+
+        ITensor termre(act,nm),termim(act,nm); 
+        termre.fromMatrix11(act,nm,Utruncre); 
+	if(docomplex)
+	    {
+	    termim.fromMatrix11(act,nm,Utruncim); 
+	    termre += ITensor::Complex_i() * termim;
+	    }
+        terms.push_back(termre);
+        ++itenind;
 	}
+    IQIndex newmid("qlink",iq,In);
+    U = IQTensor(active,newmid);
+    if(docomplex)
+	U *= IQTensor::Complex_1();
+    foreach(const ITensor& t, terms) 
+	U += t;
+    D.ReDimension(m);
+    for(int i = 1; i <= m; ++i) 
+        D(i) = GET(alleig,alleig.size()-i);
+    lastd = D;
+    return svdtruncerr;
+    } //Real SVDWorker::diag_denmat
+
+
+Real SVDWorker::
+truncateEigs(Vector& D, Real discarded) const
+    {
+    Real svdtruncerr = discarded;
+    int mp = D.Length();
+    Real sca = doRelCutoff_ ? D(1) : 1.0;
+    if(absoluteCutoff_)
+        {
+        mp = minm_;
+        while(mp < maxm_ && D(mp) < cutoff_ ) 
+            svdtruncerr += D(mp++);
+        }
+    else
+        {
+        while(mp > maxm_ || (svdtruncerr+D(mp) < cutoff_*sca && mp > minm_)) 
+            svdtruncerr += D(mp--);
+        }
+    if(!absoluteCutoff_)
+        { svdtruncerr = (D(1) == 0 ? 0 : svdtruncerr/sca); }
+    D.ReduceDimension(mp); 
+    if(showeigs_)
+        {
+        cout << endl;
+        cout << boost::format("truncate_ = %s")%(truncate_?"true":"false")<<endl;
+        cout << boost::format("Kept %d states in diag_denmat\n")% mp;
+        cout << boost::format("svdtruncerr = %.2E\n")%svdtruncerr;
+        //cout << "doRelCutoff is " << doRelCutoff_ << endl;
+        //cout << "refNorm is " << refNorm_ << endl;
+        int stop = min(D.Length(),10);
+        cout << "Eigs: ";
+        for(int j = 1; j <= stop; ++j)
+            {
+            cout << boost::format(D(j) > 1E-3 ? ("%.3f") : ("%.3E")) % D(j);
+            cout << ((j != stop) ? ", " : "\n");
+            }
+        }
+    return svdtruncerr;
+    }
+
+Real SVDWorker::
+truncateEigs(std::vector<Real>& alleig, int& m, Real& docut,
+             Real discarded) const
+    {
+    docut = -1;
+    Real e1 = max(alleig.back(),1.0e-60);
+    Real svdtruncerr = discarded/(doRelCutoff_ ? e1 : 1.0);
+    int mdisc = 0;
+    m = (int)alleig.size();
+    if(absoluteCutoff_)
+        {
+        //Sort all eigenvalues from largest to smallest
+        //irrespective of quantum numbers
+        reverse(alleig.begin(),alleig.end());
+        m = minm_;
+        while(m < maxm_ && m < (int)alleig.size() && alleig[m-1] > cutoff_ ) 
+            svdtruncerr += alleig[m++ - 1];
+        reverse(alleig.begin(),alleig.end());
+        mdisc = (int)alleig.size() - m;
+        docut = (mdisc > 0 ?  (alleig[mdisc-1] + alleig[mdisc])*0.5 : -1);
+        }
     else
 	if(m > minm_)
 	    {
@@ -398,7 +646,7 @@ Real SVDWorker::diag_denmat_complex(const IQTensor& rho, Vector& D, IQTensor& U)
 		if(((svdtruncerr += GET(alleig,mdisc)/sca) > cutoff_ && m <= maxm_) 
 			   || m <= minm_)
 		    { 
-		    docut = (mdisc > 0 ? (alleig[mdisc-1] + alleig[mdisc])*0.5 : -1);
+		    docut = (mdisc > 0 ?  (alleig[mdisc-1] + alleig[mdisc])*0.5 : -1);
 		    //Overshot by one, correct truncerr
 		    svdtruncerr -= alleig[mdisc]/sca;
 		    break; 
@@ -429,14 +677,121 @@ Real SVDWorker::diag_denmat_complex(const IQTensor& rho, Vector& D, IQTensor& U)
 	    }
 	}
 
+    return svdtruncerr;
+    }
+
+Real SVDWorker::
+svd_combined(const ITensor& AAc, const Index& active, 
+             Vector& D, ITensor& U, ITensor& DV)
+    {
+    //View AAc as a matrix with rows labeled by active
+    Combiner rcomb;
+    for(int j = 1; j <= AAc.r(); ++j)
+        if(AAc.index(j) != active) rcomb.addleft(AAc.index(j));
+    rcomb.init("svd");
+    ITensor M; rcomb.product(AAc,M);
+
+    Matrix A,UU,VV; 
+    Vector d;
+    M.toMatrix11NoScale(active,rcomb.right(),A);
+    newSVD(A,UU,d,VV);
+
+    //Eigenvalues of the density matrix, scaled as in diag_denmat
+    const Real f = doRelCutoff_ ? 1.0 : (M.scale()*M.scale()/refNorm_).real();
+    D.ReDimension(d.Length());
+    for(int j = 1; j <= d.Length(); ++j) 
+        D(j) = d(j)*d(j)*f;
+
+    Real svdtruncerr = truncateEigs(D);
+    int mp = D.Length();
+
+    Index newmid(active.rawname(),mp,active.type());
+    U = ITensor(active,newmid,UU.Columns(1,mp));
+
+    Matrix dV = VV.Rows(1,mp);
+    for(int j = 1; j <= mp; ++j) 
+        dV.Row(j) *= d(j);
+    ITensor DVc(newmid,rcomb.right(),dV);
+    DVc *= M.scale();
+    rcomb.conj();
+    rcomb.product(DVc,DV);
+
+    lastd = D;
+    return svdtruncerr;
+    }
+
+Real SVDWorker::
+svd_combined(const IQTensor& AAc, const IQIndex& active, 
+             Vector& D, IQTensor& U, IQTensor& DV)
+    {
+    //View each block of AAc as a matrix with rows labeled by
+    //active; with condensing there is one block per QN sector
+    IQCombiner rcomb;
+    rcomb.doCondense(true);
+    for(int j = 1; j <= AAc.r(); ++j)
+        if(AAc.index(j) != active) rcomb.addleft(AAc.index(j));
+    rcomb.init("svd");
+    IQTensor M; rcomb.product(AAc,M);
+
+    if(doRelCutoff_ && M.iten_size() > 0)
+        {
+        //Largest block scale, however small: the eigenvalues 
+        //are then relative to it even if exp(2*maxLogNum) 
+        //is not a representable double
+        Real maxLogNum = M.const_iten_begin()->scale().logNum();
+        foreach(const ITensor& t, M.itensors())
+	    maxLogNum = max(maxLogNum,t.scale().logNum());
+        refNorm_ = LogNumber(2*maxLogNum,1);
+        }
+
+    //1. SVD each block of M
+    vector<Matrix> mmatrix(M.iten_size()), vmatrix(M.iten_size());
+    vector<Vector> mvector(M.iten_size()), svector(M.iten_size());
+    vector<Real> alleig;
+    int itenind = 0;
+    for(IQTensor::const_iten_it it = M.const_iten_begin(); it != M.const_iten_end(); ++it)
+        {
+        const ITensor& t = *it;
+        const bool act1 = active.hasindex(t.index(1));
+        const Index& act = t.index(act1 ? 1 : 2);
+        const Index& ri = t.index(act1 ? 2 : 1);
+
+        Matrix A;
+        t.toMatrix11NoScale(act,ri,A);
+        Vector& s = GET(svector,itenind);
+        newSVD(A,GET(mmatrix,itenind),s,GET(vmatrix,itenind));
+
+        //Eigenvalues of the density matrix block
+        const Real f = (t.scale()*t.scale()/refNorm_).real();
+        Vector& d = GET(mvector,itenind);
+        d.ReDimension(s.Length());
+        for(int j = 1; j <= s.Length(); ++j) 
+            { 
+            d(j) = s(j)*s(j)*f; 
+            alleig.push_back(d(j)); 
+            }
+        ++itenind;
+        }
+
+    //2. Truncate eigenvalues
+
+    //Sort all eigenvalues from smallest to largest
+    //irrespective of quantum numbers
+    sort(alleig.begin(),alleig.end());
+
+    Real docut = -1;
+    int m = 0;
+    Real svdtruncerr = truncateEigs(alleig,m,docut);
+
     assert(m <= maxm_); 
-    assert(m < 20000);
 
-    //3. Construct orthogonalized IQTensor U
-    vector<ITensor> terms; terms.reserve(rho.iten_size());
-    vector<inqn> iq; iq.reserve(rho.iten_size());
+    //3. Construct orthogonalized IQTensor U and DV = D*V
+    vector<ITensor> terms, dvterms; 
+    terms.reserve(M.iten_size());
+    dvterms.reserve(M.iten_size());
+    vector<inqn> iq; iq.reserve(M.iten_size());
     itenind = 0;
-    for(IQTensor::const_iten_it it = rho.const_iten_begin(); it != rho.const_iten_end(); ++it)
+    for(IQTensor::const_iten_it it = M.const_iten_begin(); it != M.const_iten_end(); ++it)
 	{
         const ITensor& t = *it;
         const Vector& thisD = GET(mvector,itenind);
@@ -450,43 +805,44 @@ Real SVDWorker::diag_denmat_complex(const IQTensor& rho, Vector& D, IQTensor& U)
         if(m == 0 && thisD.Length() >= 1) // zero mps, just keep one arb state
             { this_m = 1; m = 1; docut = 1; }
 
-        if(this_m == 0) 
-	    { 
-	    ++itenind; 
-	    continue; 
-	    }
+        if(this_m == 0) { ++itenind; continue; }
+
+        const bool act1 = active.hasindex(t.index(1));
+        const Index& act = t.index(act1 ? 1 : 2);
+        const Index& ri = t.index(act1 ? 2 : 1);
 
         Index nm("qlink",this_m);
-        Index act = t.index(1).deprimed();
-	if(docomplex && act == Index::IndReIm())
-	    act = t.index(2).deprimed();
         iq.push_back(inqn(nm,active.qn(act)));
 
-        Matrix Utruncre = GET(mmatrixre,itenind).Columns(1,this_m);
-        Matrix Utruncim;
-	if(docomplex)
-	    Utruncim = GET(mmatrixim,itenind).Columns(1,this_m);
+        ITensor term(act,nm); 
+        term.fromMatrix11(act,nm,GET(mmatrix,itenind).Columns(1,this_m)); 
+        terms.push_back(term);
+
+        const Vector& s = GET(svector,itenind);
+        Matrix dV = GET(vmatrix,itenind).Rows(1,this_m);
+        for(int j = 1; j <= this_m; ++j) 
+            dV.Row(j) *= s(j);
+        ITensor dvterm(nm,ri,dV);
+        dvterm *= t.scale();
+        dvterms.push_back(dvterm);
 
-        ITensor termre(act,nm),termim(act,nm); 
-        termre.fromMatrix11(act,nm,Utruncre); 
-	if(docomplex)
-	    {
-	    termim.fromMatrix11(act,nm,Utruncim); 
-	    termre += ITensor::Complex_i() * termim;
-	    }
-        terms.push_back(termre);
         ++itenind;
 	}
     IQIndex newmid("qlink",iq,In);
     U = IQTensor(active,newmid);
-    if(docomplex)
-	U *= IQTensor::Complex_1();
     foreach(const ITensor& t, terms) 
 	U += t;
+
+    IQIndex cmid(newmid); cmid.conj();
+    IQTensor DVc(cmid,rcomb.right());
+    foreach(const ITensor& t, dvterms) 
+	DVc += t;
+    rcomb.conj();
+    rcomb.product(DVc,DV);
+
     D.ReDimension(m);
     for(int i = 1; i <= m; ++i) 
         D(i) = GET(alleig,alleig.size()-i);
     lastd = D;
     return svdtruncerr;
-    } //Real SVDWorker::diag_denmat
-
+    } //Real SVDWorker::svd_combined
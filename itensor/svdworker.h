@@ -45,6 +45,24 @@ public:
     bool absoluteCutoff() const { return absoluteCutoff_; }
     void absoluteCutoff(bool val) { absoluteCutoff_ = val; }
 
+    // If useSVD_ == true, real tensors are decomposed by
+    // an SVD of the combined AA (per QN block for IQTensors)
+    // instead of diagonalizing its density matrix. 
+    // The eigenvalues kept are the squared singular values.
+    bool useSVD() const { return useSVD_; }
+    void useSVD(bool val) { useSVD_ = val; }
+
+    // If partialDiag_ == true, density matrix blocks much
+    // larger than maxm are only partially diagonalized: a 
+    // randomized range finder finds their leading maxm states
+    // plus oversampling; the weight of the rest counts as
+    // truncation error. A block is diagonalized fully instead
+    // if that weight or the smallest state found is above the
+    // cutoff, or the weight is above the smallest state kept.
+    // (Not used with absoluteCutoff.)
+    bool partialDiag() const { return partialDiag_; }
+    void partialDiag(bool val) { partialDiag_ = val; }
+
     LogNumber refNorm() const { return refNorm_; }
     void refNorm(const LogNumber& val) 
         { 
@@ -78,6 +96,13 @@ public:
     Real diag_denmat_complex(const IQTensor& rho, Vector& D, IQTensor& U);
     Real diag_denmat_complex(const ITensor& rho, Vector& D, ITensor& U);
 
+    //Truncated SVD AAc = U * DV, where active is the
+    //Index of AAc which U keeps
+    Real svd_combined(const ITensor& AAc, const Index& active, 
+                      Vector& D, ITensor& U, ITensor& DV);
+    Real svd_combined(const IQTensor& AAc, const IQIndex& active, 
+                      Vector& D, IQTensor& U, IQTensor& DV);
+
     template <class Tensor>
     void operator()(int b, const Tensor& AA, Tensor& A, Tensor& B, Direction dir);
 
@@ -87,6 +112,17 @@ public:
 
 private:
 
+    //Reduces the eigenvalues D, largest first, to the
+    //number kept and returns the truncation error
+    Real truncateEigs(Vector& D, Real discarded = 0) const;
+
+    //Finds the number m of eigenvalues in alleig, sorted from
+    //smallest to largest, to keep and the value docut below
+    //which they are discarded; returns the truncation error.
+    //The weight discarded counts eigenvalues not in D or alleig.
+    Real truncateEigs(std::vector<Real>& alleig, int& m, Real& docut,
+                      Real discarded = 0) const;
+
     int N;
     std::vector<Real> truncerr_;
     Real cutoff_;
@@ -96,6 +132,8 @@ private:
     bool showeigs_;
     bool doRelCutoff_;
     bool absoluteCutoff_;
+    bool useSVD_;
+    bool partialDiag_;
     LogNumber refNorm_;
     std::vector<Vector> eigsKept_;
 
@@ -126,7 +164,7 @@ SVDWorker::
 SVDWorker() 
     : N(1), truncerr_(N+1), cutoff_(MIN_CUT), minm_(1), maxm_(MAX_M),
       truncate_(true), showeigs_(false), doRelCutoff_(false),
-      absoluteCutoff_(false), refNorm_(1), eigsKept_(N+1)
+      absoluteCutoff_(false), useSVD_(false), partialDiag_(false), refNorm_(1), eigsKept_(N+1)
     { }
 
 inline
@@ -134,7 +172,7 @@ SVDWorker::
 SVDWorker(int N_)
     : N(N_), truncerr_(N+1), cutoff_(MIN_CUT), minm_(1), maxm_(MAX_M),
       truncate_(true), showeigs_(false), doRelCutoff_(false),
-      absoluteCutoff_(false), refNorm_(1), eigsKept_(N+1)
+      absoluteCutoff_(false), useSVD_(false), partialDiag_(false), refNorm_(1), eigsKept_(N+1)
     { }
 
 inline
@@ -143,7 +181,7 @@ SVDWorker(int N_, Real cutoff, int minm, int maxm,
           bool doRelCutoff, const LogNumber& refNorm)
     : N(N_), truncerr_(N+1), cutoff_(cutoff), minm_(minm), maxm_(maxm),
       truncate_(true), showeigs_(false), doRelCutoff_(doRelCutoff),
-      absoluteCutoff_(false), refNorm_(refNorm), eigsKept_(N+1)
+      absoluteCutoff_(false), useSVD_(false), partialDiag_(false), refNorm_(refNorm), eigsKept_(N+1)
     { }
 
 inline
@@ -164,6 +202,11 @@ read(std::istream& s)
     s.read((char*)&refNorm_,sizeof(refNorm_));
     for(int j = 1; j <= N; ++j)
         readVec(s,eigsKept_[j]);
+    //Written last, so older files read with these off
+    useSVD_ = false;
+    partialDiag_ = false;
+    s.read((char*)&useSVD_,sizeof(useSVD_));
+    s.read((char*)&partialDiag_,sizeof(partialDiag_));
     }
 
 inline
@@ -183,6 +226,8 @@ write(std::ostream& s) const
     s.write((char*)&refNorm_,sizeof(refNorm_));
     for(int j = 1; j <= N; ++j)
         writeVec(s,eigsKept_[j]);
+    s.write((char*)&useSVD_,sizeof(useSVD_));
+    s.write((char*)&partialDiag_,sizeof(partialDiag_));
     }
 
 template<class Tensor>
@@ -248,6 +293,31 @@ void SVDWorker::operator()(int b, const Tensor& AA,
 
     const IndexT& active = comb.right();
 
+    Real saved_cutoff = cutoff_; 
+    int saved_minm = minm_; 
+    int saved_maxm = maxm_; 
+    if(!truncate_)
+        {
+        cutoff_ = -1;
+        minm_ = mid.m();
+        maxm_ = mid.m();
+        }
+
+    Tensor U;
+    if(useSVD_ && !AAc.is_complex())
+        {
+        //The singular values and vectors give newoc directly
+        truncerr_.at(b) = svd_combined(AAc,active,eigsKept_.at(b),U,newoc);
+
+        cutoff_ = saved_cutoff; 
+        minm_ = saved_minm; 
+        maxm_ = saved_maxm; 
+
+        comb.conj();
+        comb.product(U,to_orth);
+        return;
+        }
+
     Tensor rho;
     if(0 && AAc.is_complex())
 	{
@@ -265,17 +335,6 @@ void SVDWorker::operator()(int b, const Tensor& AA,
 	rho = AAc*AAcc; 
 	}
 
-    Real saved_cutoff = cutoff_; 
-    int saved_minm = minm_; 
-    int saved_maxm = maxm_; 
-    if(!truncate_)
-        {
-        cutoff_ = -1;
-        minm_ = mid.m();
-        maxm_ = mid.m();
-        }
-
-    Tensor U;
     if(AAc.is_complex())
         truncerr_.at(b) = diag_denmat_complex(rho,eigsKept_.at(b),U);
     else
@@ -57,12 +57,23 @@ static const int MAX_M = 5000;
 #endif						//}
 
 //---------------------------------------
+//Reference counts are updated atomically so that tensors
+//sharing data may be copied and destroyed in different threads
 #define ENABLE_INTRUSIVE_PTR(ClassName) \
-friend inline void intrusive_ptr_add_ref(ClassName* p) { ++(p->numref); } \
-friend inline void intrusive_ptr_release(ClassName* p) { if(--(p->numref) == 0){ delete p; } } \
+friend inline void intrusive_ptr_add_ref(ClassName* p) { __sync_add_and_fetch(&(p->numref),1); } \
+friend inline void intrusive_ptr_release(ClassName* p) { if(__sync_sub_and_fetch(&(p->numref),1) == 0){ delete p; } } \
 int count() const { return numref; }
 //---------------------------------------
 
+//Returns the contents of x, leaving x default constructed,
+//for types with a swap method. Returning a by-value argument
+//through handover moves it out instead of copying it:
+//  ITensor f(ITensor A) { A.doprime(primeBoth); return handover(A); }
+//so a temporary passed to f is never copied at all
+template <class T> 
+T 
+handover(T& x) { T res; res.swap(x); return res; }
+
 enum Printdat { ShowData, HideData };
 
 #define PrintEither(X,Y) \
@@ -232,6 +243,13 @@ public:
     static bool checkArrows_ = true;
     return checkArrows_;
     }
+    //Minimum estimated multiply-adds per parallel task
+    //in IQTensor products; smaller blocks are batched
+    static Real& minBlockTaskSize()
+    {
+    static Real minBlockTaskSize_ = 32768;
+    return minBlockTaskSize_;
+    }
     };
 
 extern bool printdat;		// want to deprecate this
@@ -0,0 +1,640 @@
+// backend.cc -- Choice of implementation for GEMM, eigen, SVD and QR
+//
+// See backend.h. The implementations of each operation are listed
+// in impl_names and the *_impl arrays below, in the same order; the
+// table holds, for each operation, a list of (from size, index) in
+// increasing size, the first entry starting at size 0.
+//
+
+#include "backend.h"
+#include "minmax.h"
+#include <math.h>
+#include <float.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <sys/time.h>
+
+extern "C" {
+void dgemm_(char*,char*,LapackInt*,LapackInt*,LapackInt*,Real*,const Real*,LapackInt*,
+	    const Real*,LapackInt*,Real*,Real*,LapackInt*);
+void dsyevd_(char* jobz, char* uplo, LapackInt* n, Real* a, LapackInt* lda, Real* w,
+	     Real* work, LapackInt* lwork, LapackInt* iwork, LapackInt* liwork, LapackInt* info);
+void dsyevr_(char* jobz, char* range, char* uplo, LapackInt* n, Real* a, LapackInt* lda,
+	     Real* vl, Real* vu, LapackInt* il, LapackInt* iu, Real* abstol, LapackInt* m,
+	     Real* w, Real* z, LapackInt* ldz, LapackInt* isuppz, Real* work, LapackInt* lwork,
+	     LapackInt* iwork, LapackInt* liwork, LapackInt* info);
+void dgesdd_(char* jobz, LapackInt* m, LapackInt* n, Real* a, LapackInt* lda, Real* s,
+	     Real* u, LapackInt* ldu, Real* vt, LapackInt* ldvt, Real* work, LapackInt* lwork,
+	     LapackInt* iwork, LapackInt* info);
+void dgeqrf_(LapackInt* m, LapackInt* n, Real* a, LapackInt* lda, Real* tau,
+	     Real* work, LapackInt* lwork, LapackInt* info);
+void dorgqr_(LapackInt* m, LapackInt* n, LapackInt* k, Real* a, LapackInt* lda, Real* tau,
+	     Real* work, LapackInt* lwork, LapackInt* info);
+}
+
+// Only these libraries identify themselves
+#if defined(__GNUC__) && defined(__linux__)
+extern "C" char* openblas_get_config() __attribute__((weak));
+extern "C" void MKL_Get_Version_String(char*, int) __attribute__((weak));
+#endif
+
+void BackupEigenValues(const MatrixRef& A, Vector& D, Matrix& Z);	// utility.cc
+
+namespace {
+
+//
+// The implementations
+//
+
+void
+gemmBlas(char transa, char transb, int m, int n, int k, Real alpha,
+	const Real* a, int lda, const Real* b, int ldb,
+	Real beta, Real* c, int ldc)
+    {
+    LapackInt M = m, N = n, K = k, LDA = lda, LDB = ldb, LDC = ldc;
+    dgemm_(&transa,&transb,&M,&N,&K,&alpha,a,&LDA,b,&LDB,&beta,c,&LDC);
+    }
+
+void
+eigInternal(const MatrixRef& A, Vector& D, Matrix& Z)
+    { BackupEigenValues(A,D,Z); }
+
+void
+eigSyevd(const MatrixRef& A, Vector& D, Matrix& Z)
+    {
+    LapackInt n = A.Ncols();
+    char jobz = 'V', uplo = 'U';
+    Z = A;
+    D.ReDimension(n);
+
+    //Query work size; the work space is on the heap
+    //since for large n it does not fit on the stack
+    Real qwork = 0;
+    LapackInt qiwork = 0, lwork = -1, liwork = -1, info = 0;
+    dsyevd_(&jobz,&uplo,&n,Z.Store(),&n,D.Store(),&qwork,&lwork,&qiwork,&liwork,&info);
+    if(info != 0)
+	{
+	cerr << "info is " << info << endl;
+	_merror("Error condition in dsyevd_ (query call).");
+	}
+    lwork = (LapackInt) qwork; liwork = qiwork;
+    std::vector<Real> work(lwork);
+    std::vector<LapackInt> iwork(liwork);
+    dsyevd_(&jobz,&uplo,&n,Z.Store(),&n,D.Store(),&work[0],&lwork,&iwork[0],&liwork,&info);
+    if(info != 0)
+	{
+	cerr << "info is " << info << endl;
+	_merror("Error condition in dsyevd_.");
+	}
+    //Rows of Z are the eigenvectors
+    Z = Z.t();
+    }
+
+void
+eigSyevr(const MatrixRef& A, Vector& D, Matrix& Z)
+    {
+    LapackInt n = A.Ncols();
+    char jobz = 'V', range = 'A', uplo = 'U';
+    Matrix AA(A);
+    Z.ReDimension(n,n);
+    D.ReDimension(n);
+
+    Real vl = 0, vu = 0, abstol = DBL_MIN;
+    LapackInt il = 0, iu = 0, nfound = 0, info = 0;
+    std::vector<LapackInt> isuppz(2*n);
+    Real qwork = 0;
+    LapackInt qiwork = 0, lwork = -1, liwork = -1;
+    dsyevr_(&jobz,&range,&uplo,&n,AA.Store(),&n,&vl,&vu,&il,&iu,&abstol,&nfound,
+	    D.Store(),Z.Store(),&n,&isuppz[0],&qwork,&lwork,&qiwork,&liwork,&info);
+    if(info != 0)
+	{
+	cerr << "info is " << info << endl;
+	_merror("Error condition in dsyevr_ (query call).");
+	}
+    lwork = (LapackInt) qwork; liwork = qiwork;
+    std::vector<Real> work(lwork);
+    std::vector<LapackInt> iwork(liwork);
+    dsyevr_(&jobz,&range,&uplo,&n,AA.Store(),&n,&vl,&vu,&il,&iu,&abstol,&nfound,
+	    D.Store(),Z.Store(),&n,&isuppz[0],&work[0],&lwork,&iwork[0],&liwork,&info);
+    if(info != 0)
+	{
+	cerr << "info is " << info << endl;
+	_merror("Error condition in dsyevr_.");
+	}
+    Z = Z.t();
+    }
+
+void
+svdInternal(const MatrixRef& A, Matrix& U, Vector& d, Matrix& V)
+    { SVD(A,U,d,V); }
+
+void
+svdGesdd(const MatrixRef& A, Matrix& U, Vector& d, Matrix& V)
+    {
+    int m = A.Nrows(), n = A.Ncols();
+    if(m < n)
+	{
+	Matrix AA = A.t();
+	Matrix Ut, Vt;
+	svdGesdd(AA,Ut,d,Vt);
+	U = Vt.t();
+	V = Ut.t();
+	return;
+	}
+    char jobz = 'S';
+    Matrix AA = A.t();
+    Matrix UU(n,m), VV(n,n);
+    d.ReDimension(n);
+
+    LapackInt lm = m, ln = n, lwork = -1, info = 0;
+    Real qwork = 0;
+    //Workspace is on the heap: for large m it
+    //does not fit on the stack
+    std::vector<LapackInt> iwork(8*n);
+    dgesdd_(&jobz,&lm,&ln,AA.Store(),&lm,d.Store(),UU.Store(),&lm,
+	    VV.Store(),&ln,&qwork,&lwork,&iwork[0],&info);
+    lwork = (LapackInt) qwork;
+    std::vector<Real> work(lwork);
+    info = 0;
+    dgesdd_(&jobz,&lm,&ln,AA.Store(),&lm,d.Store(),UU.Store(),&lm,
+	    VV.Store(),&ln,&work[0],&lwork,&iwork[0],&info);
+    //dgesdd occasionally fails to converge, fall back to SVD
+    if(info != 0)
+	{
+	SVD(A,U,d,V);
+	return;
+	}
+    U = UU.t();
+    V = VV.t();
+    }
+
+// Householder QR as in LAPACK dgeqr2/dorg2r (so with the same signs),
+// on A^T which holds A column-major
+void
+qrInternal(const MatrixRef& A, Matrix& Q, Matrix& R)
+    {
+    const int m = A.Nrows(), n = A.Ncols(), k = min(m,n);
+    Matrix At = A.t();
+    Real* a = At.Store();
+    std::vector<Real> tau(k,0);
+    for(int j = 0; j < k; ++j)
+	{
+	//Reflector I - tau v v^T, v = (1,v[1..]), taking
+	//column j below the diagonal to zero
+	Real* v = a + j*m + j;
+	const int len = m-j;
+	Real xnorm = 0;
+	for(int i = 1; i < len; ++i) xnorm += v[i]*v[i];
+	if(xnorm == 0) continue;
+	const Real alpha = v[0];
+	const Real beta = (alpha >= 0 ? -1 : 1) * sqrt(alpha*alpha + xnorm);
+	tau[j] = (beta-alpha)/beta;
+	const Real sc = 1.0/(alpha-beta);
+	for(int i = 1; i < len; ++i) v[i] *= sc;
+	v[0] = beta;
+	for(int c = j+1; c < n; ++c)
+	    {
+	    Real* w = a + c*m + j;
+	    Real s = w[0];
+	    for(int i = 1; i < len; ++i) s += v[i]*w[i];
+	    s *= tau[j];
+	    w[0] -= s;
+	    for(int i = 1; i < len; ++i) w[i] -= s*v[i];
+	    }
+	}
+
+    R.ReDimension(k,n);
+    for(int i = 1; i <= k; ++i)
+    for(int c = 1; c <= n; ++c)
+	R(i,c) = (c >= i ? At(c,i) : 0);
+
+    //Q = H_1 ... H_k applied to the first k unit vectors
+    Matrix Qt(k,m);
+    Qt = 0;
+    Real* q = Qt.Store();
+    for(int i = 0; i < k; ++i) q[i*m+i] = 1;
+    for(int j = k-1; j >= 0; --j)
+	{
+	if(tau[j] == 0) continue;
+	const Real* v = a + j*m + j;
+	const int len = m-j;
+	for(int c = j; c < k; ++c)
+	    {
+	    Real* w = q + c*m + j;
+	    Real s = w[0];
+	    for(int i = 1; i < len; ++i) s += v[i]*w[i];
+	    s *= tau[j];
+	    w[0] -= s;
+	    for(int i = 1; i < len; ++i) w[i] -= s*v[i];
+	    }
+	}
+    Q = Qt.t();
+    }
+
+void
+qrGeqrf(const MatrixRef& A, Matrix& Q, Matrix& R)
+    {
+    const int m = A.Nrows(), n = A.Ncols(), k = min(m,n);
+    Matrix At = A.t();
+    LapackInt lm = m, ln = n, lk = k, lwork = -1, info = 0;
+    std::vector<Real> tau(k);
+    Real qwork = 0;
+    dgeqrf_(&lm,&ln,At.Store(),&lm,&tau[0],&qwork,&lwork,&info);
+    lwork = max((LapackInt) qwork,(LapackInt) 1);
+    std::vector<Real> work(lwork);
+    dgeqrf_(&lm,&ln,At.Store(),&lm,&tau[0],&work[0],&lwork,&info);
+    if(info != 0)
+	{
+	cerr << "info is " << info << endl;
+	_merror("Error condition in dgeqrf_.");
+	}
+
+    R.ReDimension(k,n);
+    for(int i = 1; i <= k; ++i)
+    for(int c = 1; c <= n; ++c)
+	R(i,c) = (c >= i ? At(c,i) : 0);
+
+    //The first k columns of A (rows of At) become Q
+    lwork = -1;
+    dorgqr_(&lm,&lk,&lk,At.Store(),&lm,&tau[0],&qwork,&lwork,&info);
+    lwork = max((LapackInt) qwork,(LapackInt) 1);
+    work.resize(lwork);
+    dorgqr_(&lm,&lk,&lk,At.Store(),&lm,&tau[0],&work[0],&lwork,&info);
+    if(info != 0)
+	{
+	cerr << "info is " << info << endl;
+	_merror("Error condition in dorgqr_.");
+	}
+    Q = At.SubMatrix(1,k,1,m).t();
+    }
+
+typedef void (*GemmImpl)(char,char,int,int,int,Real,const Real*,int,
+			 const Real*,int,Real,Real*,int);
+typedef void (*EigImpl)(const MatrixRef&, Vector&, Matrix&);
+typedef void (*SVDImpl)(const MatrixRef&, Matrix&, Vector&, Matrix&);
+typedef void (*QRImpl)(const MatrixRef&, Matrix&, Matrix&);
+
+const GemmImpl gemm_impl[] = { &internal_dgemm, &gemmBlas };
+const EigImpl eig_impl[] = { &eigInternal, &eigSyevd, &eigSyevr };
+const SVDImpl svd_impl[] = { &svdInternal, &svdGesdd };
+const QRImpl qr_impl[] = { &qrInternal, &qrGeqrf };
+
+const int max_impl = 3;
+const char* const op_names[NumLinalgOps] = { "gemm", "eig", "svd", "qr" };
+const char* const impl_names[NumLinalgOps][max_impl+1] =
+    {
+    { "internal", "dgemm", 0 },
+    { "internal", "dsyevd", "dsyevr", 0 },
+    { "internal", "dgesdd", 0 },
+    { "internal", "dgeqrf", 0 }
+    };
+
+int
+implIndex(int op, const std::string& name)
+    {
+    for(int j = 0; impl_names[op][j] != 0; ++j)
+	if(name == impl_names[op][j]) return j;
+    return -1;
+    }
+
+//
+// The table
+//
+
+struct Choice
+    {
+    int from, impl;
+    Choice(int f, int i) : from(f), impl(i) { }
+    };
+
+typedef std::vector<Choice> Choices[NumLinalgOps];
+
+void
+defaultChoices(Choices& c)
+    {
+    for(int op = 0; op < NumLinalgOps; ++op)
+	c[op].assign(1,Choice(0,1));
+#ifdef MATRIX_INTERNAL_GEMM
+    c[GemmOp].assign(1,Choice(0,0));
+#endif
+    }
+
+void
+setChoice(Choices& c, int op, int impl, int from)
+    {
+    if(from <= 0) { c[op].assign(1,Choice(0,impl)); return; }
+    while(!c[op].empty() && c[op].back().from >= from) c[op].pop_back();
+    if(c[op].back().impl != impl) c[op].push_back(Choice(from,impl));
+    }
+
+// What the table was made for: the internal gemm kernel
+// and the library linked in
+std::string
+backendId()
+    {
+    std::string id = std::string("internal ") + internal_dgemm_kernel();
+    return id + ", " + linkedLapackName();
+    }
+
+bool
+readChoices(Choices& c, const char* file, bool quiet)
+    {
+    std::ifstream in(file);
+    if(!in)
+	{
+	if(!quiet) cerr << "Matrix: cannot read backend table " << file << endl;
+	return false;
+	}
+    Choices r;
+    bool seen[NumLinalgOps] = { false, false, false, false };
+    std::string line;
+    while(std::getline(in,line))
+	{
+	if(line.empty() || line[0] == '#') continue;
+	if(line.compare(0,3,"id ") == 0)
+	    {
+	    if(line.substr(3) != backendId())
+		{
+		cerr << "Matrix: ignoring backend table " << file << ", made for \""
+		     << line.substr(3) << "\" (now \"" << backendId() << "\")" << endl;
+		return false;
+		}
+	    continue;
+	    }
+	std::istringstream ls(line);
+	std::string opname, name;
+	int from = -1;
+	ls >> opname >> from >> name;
+	int op = 0;
+	while(op < NumLinalgOps && opname != op_names[op]) ++op;
+	const int impl = (op < NumLinalgOps ? implIndex(op,name) : -1);
+	if(impl < 0 || from < 0)
+	    {
+	    cerr << "Matrix: skipping line \"" << line << "\" of " << file << endl;
+	    continue;
+	    }
+	if(!seen[op]) r[op].assign(1,Choice(0,impl));
+	seen[op] = true;
+	setChoice(r,op,impl,from);
+	}
+    for(int op = 0; op < NumLinalgOps; ++op)
+	if(seen[op]) c[op] = r[op];
+    return true;
+    }
+
+//The tuning file read, $MATRIX_TUNE_FILE; empty if it is not set,
+//so that results never depend on a file left on the machine
+std::string
+tuneFile()
+    {
+    const char* f = getenv("MATRIX_TUNE_FILE");
+    return (f != 0 ? f : "");
+    }
+
+//The file autotuneBackends writes if not given one
+std::string
+defaultTuneFile()
+    {
+    const std::string f = tuneFile();
+    if(!f.empty()) return f;
+    const char* home = getenv("HOME");
+    if(home != 0 && home[0] != 0) return std::string(home) + "/.matrix_tune";
+    return ".matrix_tune";
+    }
+
+// Made on first use, which the compiler serializes
+struct BackendTable
+    {
+    Choices c;
+    BackendTable() { reset(); }
+    void
+    reset()
+	{
+	defaultChoices(c);
+	const std::string f = tuneFile();
+	if(f.empty()) return;
+	std::ifstream test(f.c_str());
+	if(test) { test.close(); readChoices(c,f.c_str(),true); }
+	}
+    };
+
+BackendTable&
+table()
+    {
+    static BackendTable t;
+    return t;
+    }
+
+inline int
+choose(int op, Real ops)
+    {
+    const std::vector<Choice>& c = table().c[op];
+    int impl = c[0].impl;
+    for(size_t j = 1; j < c.size(); ++j)
+	{
+	const Real f = c[j].from;
+	if(f*f*f > ops) break;
+	impl = c[j].impl;
+	}
+    return impl;
+    }
+
+inline Real
+svdOps(const MatrixRef& A)
+    { return Real(A.Nrows())*A.Ncols()*min(A.Nrows(),A.Ncols()); }
+
+//
+// Autotuning
+//
+
+inline Real
+walltime()
+    {
+    struct timeval tv;
+    gettimeofday(&tv,NULL);
+    return tv.tv_sec + tv.tv_usec * 1.0e-6;
+    }
+
+// The test problem of size s for op, run by implementation impl
+struct TuneCase
+    {
+    int op, s;
+    Matrix A, B, C, X, Y;
+    Vector d;
+    TuneCase(int op_, int s_) : op(op_), s(s_), A(s_,s_), B(s_,s_), C(s_,s_)
+	{
+	A.Randomize(); B.Randomize();
+	if(op == EigOp) { C = A + A.t(); A = C; }
+	}
+    void
+    run(int impl)
+	{
+	if(op == GemmOp)
+	    gemm_impl[impl]('N','N',s,s,s,1,A.Store(),s,B.Store(),s,0,C.Store(),s);
+	else if(op == EigOp) eig_impl[impl](A,d,X);
+	else if(op == SVDOp) svd_impl[impl](A,X,d,Y);
+	else qr_impl[impl](A,X,Y);
+	}
+    // Best of 3 runs of enough calls to take 10ms
+    Real
+    time(int impl)
+	{
+	Real t = walltime();
+	run(impl);
+	t = walltime() - t;
+	const int nrep = int(min(1000.0,max(1.0,0.01/max(t,1e-9))));
+	Real best = -1;
+	for(int trial = 0; trial < 3; ++trial)
+	    {
+	    t = walltime();
+	    for(int r = 0; r < nrep; ++r) run(impl);
+	    t = (walltime() - t)/nrep;
+	    if(best < 0 || t < best) best = t;
+	    }
+	return best;
+	}
+    };
+
+} //namespace
+
+const char*
+linalgOpName(LinalgOp op) { return op_names[op]; }
+
+const char*
+backendFor(LinalgOp op, int size)
+    { return impl_names[op][choose(op,Real(size)*size*size)]; }
+
+bool
+setBackend(LinalgOp op, const char* name, int from)
+    {
+    const int impl = implIndex(op,name);
+    if(impl < 0) return false;
+    setChoice(table().c,op,impl,from);
+    return true;
+    }
+
+void
+resetBackends() { table().reset(); }
+
+bool
+readBackends(const char* file) { return readChoices(table().c,file,false); }
+
+void
+printBackends(std::ostream& s)
+    {
+    s << "# Implementations of the matrix library kernels by size, see backend.h\n";
+    s << "# <op> <from size> <implementation>\n";
+    s << "id " << backendId() << "\n";
+    for(int op = 0; op < NumLinalgOps; ++op)
+    for(size_t j = 0; j < table().c[op].size(); ++j)
+	{
+	const Choice& ch = table().c[op][j];
+	s << op_names[op] << " " << ch.from << " " << impl_names[op][ch.impl] << "\n";
+	}
+    }
+
+bool
+writeBackends(const char* file)
+    {
+    std::ofstream out(file);
+    if(!out)
+	{
+	cerr << "Matrix: cannot write backend table " << file << endl;
+	return false;
+	}
+    printBackends(out);
+    return bool(out);
+    }
+
+const char*
+backendTuneFile()
+    {
+    static const std::string f = defaultTuneFile();
+    return f.c_str();
+    }
+
+const char*
+linkedLapackName()
+    {
+    struct Name
+	{
+	std::string s;
+	Name() : s("lapack")
+	    {
+#if defined(__GNUC__) && defined(__linux__)
+	    if(openblas_get_config != 0) s = openblas_get_config();
+	    else if(MKL_Get_Version_String != 0)
+		{
+		char buf[256];
+		MKL_Get_Version_String(buf,sizeof(buf));
+		s = buf;
+		}
+#endif
+	    }
+	};
+    static const Name name;
+    return name.s.c_str();
+    }
+
+void
+autotuneBackends(const char* file, int maxsize, bool verbose)
+    {
+    if(verbose)
+	printf("Tuning for %s\n",backendId().c_str());
+    for(int op = 0; op < NumLinalgOps; ++op)
+	{
+	Choices& c = table().c;
+	for(int s = 4; s <= maxsize; s *= 2)
+	    {
+	    TuneCase tc(op,s);
+	    if(verbose) printf("%-5s %5d ",op_names[op],s);
+	    int best = -1;
+	    Real tbest = 0;
+	    for(int impl = 0; impl_names[op][impl] != 0; ++impl)
+		{
+		const Real t = tc.time(impl);
+		if(verbose) printf(" %8s %9.3e",impl_names[op][impl],t);
+		if(best < 0 || t < tbest) { best = impl; tbest = t; }
+		}
+	    if(verbose) printf("  -> %s\n",impl_names[op][best]);
+	    //Switch halfway (on a log scale) from the previous size
+	    setChoice(c,op,best,(s == 4 ? 0 : int(s*0.7071+0.5)));
+	    }
+	}
+    const std::string f = (file != 0 ? std::string(file) : defaultTuneFile());
+    if(writeBackends(f.c_str()) && verbose)
+	{
+	printf("Wrote %s\n",f.c_str());
+	if(tuneFile() != f)
+	    printf("Set MATRIX_TUNE_FILE=%s to use it\n",f.c_str());
+	}
+    }
+
+void
+backendGemm(char transa, char transb, int m, int n, int k, Real alpha,
+	    const Real* a, int lda, const Real* b, int ldb,
+	    Real beta, Real* c, int ldc)
+    {
+    const int impl = choose(GemmOp,Real(m)*n*k);
+    gemm_impl[impl](transa,transb,m,n,k,alpha,a,lda,b,ldb,beta,c,ldc);
+    }
+
+void
+backendEigen(const MatrixRef& A, Vector& D, Matrix& Z)
+    {
+    const Real n = A.Nrows();
+    eig_impl[choose(EigOp,n*n*n)](A,D,Z);
+    }
+
+void
+backendSVD(const MatrixRef& A, Matrix& U, Vector& d, Matrix& V)
+    { svd_impl[choose(SVDOp,svdOps(A))](A,U,d,V); }
+
+void
+backendQR(const MatrixRef& A, Matrix& Q, Matrix& R)
+    { qr_impl[choose(QROp,svdOps(A))](A,Q,R); }
@@ -0,0 +1,80 @@
+// backend.h -- Choice of implementation for GEMM, eigen, SVD and QR
+
+#ifndef _backend_h
+#define _backend_h
+
+#include "matrix.h"
+#include <iostream>
+
+//
+// Each of the dense kernels below has more than one implementation:
+//
+//   gemm:  internal (internal_dgemm), dgemm
+//   eig:   internal (tred2/tql2),     dsyevd, dsyevr
+//   svd:   internal (svd port),       dgesdd
+//   qr:    internal (Householder),    dgeqrf
+//
+// the named ones being those of the BLAS/LAPACK linked in (OpenBLAS,
+// MKL or Accelerate, as set by BLAS_LAPACK_LIBFLAGS in options.mk).
+// mult(), EigenValues(), newSVD() and QR() use the implementation
+// a table gives for the size of the problem, measured as the cube
+// root of its operation count: (m n k)^(1/3) for a product, n for
+// an n x n eigenproblem and (m n min(m,n))^(1/3) for SVD and QR.
+//
+// The table starts from the linked library throughout (except for
+// gemm if MATRIX_INTERNAL_GEMM is defined) and, on first use, is
+// read from the tuning file named by $MATRIX_TUNE_FILE, if that is
+// set: no file is read otherwise. Its lines are
+//
+//   <op> <from size> <implementation>
+//
+// autotuneBackends() times every implementation over a range of
+// sizes and writes the fastest to a file, by default the one of
+// $MATRIX_TUNE_FILE, else $HOME/.matrix_tune; "timeit tune" in this
+// directory runs it. The file records the kernels it was tuned for
+// and is ignored once they change.
+//
+
+// Integer type of the LAPACK interface (long for ILP64 builds of MKL)
+#ifdef MATRIX_ILP64
+typedef long LapackInt;
+#else
+typedef int LapackInt;
+#endif
+
+enum LinalgOp { GemmOp = 0, EigOp, SVDOp, QROp };
+const int NumLinalgOps = 4;
+
+const char* linalgOpName(LinalgOp op);
+
+// Implementation used for op at the given size
+const char* backendFor(LinalgOp op, int size);
+
+// Use the named implementation of op from size "from" up; returns
+// false if op has no implementation of that name
+bool setBackend(LinalgOp op, const char* name, int from = 0);
+
+// Back to the table of $MATRIX_TUNE_FILE, or the defaults without one
+void resetBackends();
+
+bool readBackends(const char* file);
+bool writeBackends(const char* file);
+void printBackends(std::ostream& s);
+
+// Time the implementations at sizes 4, 8, ... maxsize, use the fastest
+// and write them to file (backendTuneFile() if file is 0)
+void autotuneBackends(const char* file = 0, int maxsize = 512, bool verbose = true);
+
+const char* backendTuneFile();	// $MATRIX_TUNE_FILE, else $HOME/.matrix_tune
+const char* linkedLapackName();	// as far as it can be told
+
+// The dispatched operations: the same arguments as internal_dgemm
+// (or dgemm_), EigenValues, newSVD and QR
+void backendGemm(char transa, char transb, int m, int n, int k, Real alpha,
+		const Real* a, int lda, const Real* b, int ldb,
+		Real beta, Real* c, int ldc);
+void backendEigen(const MatrixRef& A, Vector& D, Matrix& Z);
+void backendSVD(const MatrixRef& A, Matrix& U, Vector& d, Matrix& V);
+void backendQR(const MatrixRef& A, Matrix& Q, Matrix& R);
+
+#endif
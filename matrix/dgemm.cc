@@ -0,0 +1,504 @@
+// dgemm.cc -- Built-in matrix multiplication
+//
+// internal_dgemm computes C = alpha*op(A)*op(B) + beta*C with the
+// arguments of BLAS dgemm_. mult() uses it in place of dgemm_ for
+// the sizes backend.h gives it (all of them with MATRIX_INTERNAL_GEMM).
+//
+// The products are done in the usual packed scheme: op(B) is copied
+// one kc x nc panel at a time into slivers nr columns wide, op(A)
+// one mc x kc block at a time into slivers mr rows tall, and a
+// register-blocked micro-kernel makes each mr x nr tile of C from
+// one sliver of each. kc, mc and nc come from the cache sizes, so
+// that a B sliver stays in L1, the A block in L2 and the B panel
+// in L3. The micro-kernel (AVX-512, AVX2 with FMA, or plain C++)
+// is picked once, at run time, from what the CPU supports.
+//
+
+#include "matrix.h"
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define GEMM_X86
+#include <immintrin.h>
+#endif
+
+namespace {
+
+//
+// A micro-kernel computes the mr x nr tile
+//   acc(i,j) = sum_p a[p*as+i]*b[p*nr+j], p < kc
+// from a sliver a of A (packed, as = mr, or read in place, as = lda)
+// and a packed sliver b of B, and sets
+//   c(i,j) = alpha*acc(i,j) + beta*c(i,j),
+// c being column-major with leading dimension ldc.
+// c is not read if beta == 0.
+//
+typedef void (*MicroKernel)(int kc, const Real* a, int as, const Real* b,
+                            Real alpha, Real beta, Real* c, int ldc);
+
+struct GemmKernel
+    {
+    int mr, nr;
+    MicroKernel run;
+    const char* name;
+    };
+
+template <int MR, int NR>
+void
+kernelGeneric(int kc, const Real* a, int as, const Real* b,
+              Real alpha, Real beta, Real* c, int ldc)
+    {
+    Real acc[MR*NR];
+    for(int x = 0; x < MR*NR; ++x) acc[x] = 0;
+    for(int p = 0; p < kc; ++p, a += as, b += NR)
+        for(int j = 0; j < NR; ++j)
+            for(int i = 0; i < MR; ++i)
+                acc[j*MR+i] += a[i]*b[j];
+    for(int j = 0; j < NR; ++j)
+        for(int i = 0; i < MR; ++i)
+            c[i+j*ldc] = alpha*acc[j*MR+i] + (beta == 0 ? 0 : beta*c[i+j*ldc]);
+    }
+
+#ifdef GEMM_X86
+
+//8 x 6 tile: twelve 4-wide accumulators
+__attribute__((target("avx2,fma")))
+void
+kernelAVX2(int kc, const Real* a, int as, const Real* b,
+           Real alpha, Real beta, Real* c, int ldc)
+    {
+    __m256d c00 = _mm256_setzero_pd(), c01 = _mm256_setzero_pd(),
+            c10 = _mm256_setzero_pd(), c11 = _mm256_setzero_pd(),
+            c20 = _mm256_setzero_pd(), c21 = _mm256_setzero_pd(),
+            c30 = _mm256_setzero_pd(), c31 = _mm256_setzero_pd(),
+            c40 = _mm256_setzero_pd(), c41 = _mm256_setzero_pd(),
+            c50 = _mm256_setzero_pd(), c51 = _mm256_setzero_pd();
+    for(int p = 0; p < kc; ++p, a += as, b += 6)
+        {
+        const __m256d a0 = _mm256_loadu_pd(a), a1 = _mm256_loadu_pd(a+4);
+        __m256d bj;
+#define GEMM_AVX2_STEP(j) \
+        bj = _mm256_broadcast_sd(b+j); \
+        c##j##0 = _mm256_fmadd_pd(a0,bj,c##j##0); \
+        c##j##1 = _mm256_fmadd_pd(a1,bj,c##j##1);
+        GEMM_AVX2_STEP(0) GEMM_AVX2_STEP(1) GEMM_AVX2_STEP(2)
+        GEMM_AVX2_STEP(3) GEMM_AVX2_STEP(4) GEMM_AVX2_STEP(5)
+#undef GEMM_AVX2_STEP
+        }
+    const __m256d va = _mm256_set1_pd(alpha), vb = _mm256_set1_pd(beta);
+#define GEMM_AVX2_STORE(j) \
+        { \
+        Real* cj = c + j*ldc; \
+        if(beta == 0) \
+            { \
+            _mm256_storeu_pd(cj,_mm256_mul_pd(va,c##j##0)); \
+            _mm256_storeu_pd(cj+4,_mm256_mul_pd(va,c##j##1)); \
+            } \
+        else \
+            { \
+            _mm256_storeu_pd(cj,_mm256_fmadd_pd(va,c##j##0,_mm256_mul_pd(vb,_mm256_loadu_pd(cj)))); \
+            _mm256_storeu_pd(cj+4,_mm256_fmadd_pd(va,c##j##1,_mm256_mul_pd(vb,_mm256_loadu_pd(cj+4)))); \
+            } \
+        }
+    GEMM_AVX2_STORE(0) GEMM_AVX2_STORE(1) GEMM_AVX2_STORE(2)
+    GEMM_AVX2_STORE(3) GEMM_AVX2_STORE(4) GEMM_AVX2_STORE(5)
+#undef GEMM_AVX2_STORE
+    }
+
+//16 x 8 tile: sixteen 8-wide accumulators
+__attribute__((target("avx512f")))
+void
+kernelAVX512(int kc, const Real* a, int as, const Real* b,
+             Real alpha, Real beta, Real* c, int ldc)
+    {
+    __m512d c00 = _mm512_setzero_pd(), c01 = _mm512_setzero_pd(),
+            c10 = _mm512_setzero_pd(), c11 = _mm512_setzero_pd(),
+            c20 = _mm512_setzero_pd(), c21 = _mm512_setzero_pd(),
+            c30 = _mm512_setzero_pd(), c31 = _mm512_setzero_pd(),
+            c40 = _mm512_setzero_pd(), c41 = _mm512_setzero_pd(),
+            c50 = _mm512_setzero_pd(), c51 = _mm512_setzero_pd(),
+            c60 = _mm512_setzero_pd(), c61 = _mm512_setzero_pd(),
+            c70 = _mm512_setzero_pd(), c71 = _mm512_setzero_pd();
+    for(int p = 0; p < kc; ++p, a += as, b += 8)
+        {
+        const __m512d a0 = _mm512_loadu_pd(a), a1 = _mm512_loadu_pd(a+8);
+        __m512d bj;
+#define GEMM_AVX512_STEP(j) \
+        bj = _mm512_set1_pd(b[j]); \
+        c##j##0 = _mm512_fmadd_pd(a0,bj,c##j##0); \
+        c##j##1 = _mm512_fmadd_pd(a1,bj,c##j##1);
+        GEMM_AVX512_STEP(0) GEMM_AVX512_STEP(1) GEMM_AVX512_STEP(2) GEMM_AVX512_STEP(3)
+        GEMM_AVX512_STEP(4) GEMM_AVX512_STEP(5) GEMM_AVX512_STEP(6) GEMM_AVX512_STEP(7)
+#undef GEMM_AVX512_STEP
+        }
+    const __m512d va = _mm512_set1_pd(alpha), vb = _mm512_set1_pd(beta);
+#define GEMM_AVX512_STORE(j) \
+        { \
+        Real* cj = c + j*ldc; \
+        if(beta == 0) \
+            { \
+            _mm512_storeu_pd(cj,_mm512_mul_pd(va,c##j##0)); \
+            _mm512_storeu_pd(cj+8,_mm512_mul_pd(va,c##j##1)); \
+            } \
+        else \
+            { \
+            _mm512_storeu_pd(cj,_mm512_fmadd_pd(va,c##j##0,_mm512_mul_pd(vb,_mm512_loadu_pd(cj)))); \
+            _mm512_storeu_pd(cj+8,_mm512_fmadd_pd(va,c##j##1,_mm512_mul_pd(vb,_mm512_loadu_pd(cj+8)))); \
+            } \
+        }
+    GEMM_AVX512_STORE(0) GEMM_AVX512_STORE(1) GEMM_AVX512_STORE(2) GEMM_AVX512_STORE(3)
+    GEMM_AVX512_STORE(4) GEMM_AVX512_STORE(5) GEMM_AVX512_STORE(6) GEMM_AVX512_STORE(7)
+#undef GEMM_AVX512_STORE
+    }
+
+#endif //GEMM_X86
+
+//The kernel called name (generic, avx2 or avx512),
+//0 if there is none or the CPU lacks it
+const GemmKernel*
+findKernel(const char* name)
+    {
+    static const GemmKernel generic = { 4, 4, &kernelGeneric<4,4>, "generic" };
+    if(strcmp(name,"generic") == 0) return &generic;
+#ifdef GEMM_X86
+    static const GemmKernel avx2 = { 8, 6, &kernelAVX2, "avx2" };
+    static const GemmKernel avx512 = { 16, 8, &kernelAVX512, "avx512" };
+    __builtin_cpu_init();
+    if(strcmp(name,"avx2") == 0 
+       && __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) 
+        return &avx2;
+    if(strcmp(name,"avx512") == 0 && __builtin_cpu_supports("avx512f")) 
+        return &avx512;
+#endif
+    return 0;
+    }
+
+const GemmKernel&
+selectKernel()
+    {
+    //MATRIX_GEMM_KERNEL=generic, avx2 or avx512 asks for a
+    //kernel; one the CPU lacks is never used
+    const char* want = getenv("MATRIX_GEMM_KERNEL");
+    const GemmKernel* K = (want != 0 ? findKernel(want) : 0);
+    if(K == 0) K = findKernel("avx512");
+    if(K == 0) K = findKernel("avx2");
+    if(K == 0) K = findKernel("generic");
+    return *K;
+    }
+
+const GemmKernel&
+kernel()
+    {
+    static const GemmKernel& k = selectKernel();
+    return k;
+    }
+
+long
+cacheSize(int level)
+    {
+    long s = 0;
+#ifdef _SC_LEVEL1_DCACHE_SIZE
+    if(level == 1) s = sysconf(_SC_LEVEL1_DCACHE_SIZE);
+    if(level == 2) s = sysconf(_SC_LEVEL2_CACHE_SIZE);
+    if(level == 3) s = sysconf(_SC_LEVEL3_CACHE_SIZE);
+#endif
+    if(s > 0) return s;
+    static const long fallback[] = { 0, 32768, 262144, 4194304 };
+    return fallback[level];
+    }
+
+//
+// Block sizes for a kernel: a kc x nr sliver of B takes at
+// most half of L1, an mc x kc block of A half of L2 and a
+// kc x nc panel of B half of L3
+//
+struct Blocking
+    {
+    int kc, mc, nc;
+
+    Blocking(const GemmKernel& K)
+        {
+        const long l1 = cacheSize(1), l2 = cacheSize(2), l3 = cacheSize(3);
+        kc = int(l1/(2*sizeof(Real)*K.nr));
+        kc = std::max(64,std::min(512,kc - kc%8));
+        mc = int(l2/(2*sizeof(Real)*kc));
+        mc = std::max(K.mr,std::min(1024,mc - mc%K.mr));
+        nc = int(l3/(2*sizeof(Real)*kc));
+        nc = std::max(K.nr,std::min(8192,nc - nc%K.nr));
+        }
+    };
+
+const Blocking&
+blocking()
+    {
+    static const Blocking b(kernel());
+    return b;
+    }
+
+//Buffer aligned for the micro-kernel loads
+struct PackBuffer
+    {
+    Real* p;
+    PackBuffer(size_t n) : p(0)
+        {
+        if(posix_memalign((void**)&p,64,n*sizeof(Real)) != 0)
+            _merror("internal_dgemm: out of memory");
+        }
+    ~PackBuffer() { free(p); }
+    };
+
+//
+// Copies rows i0..i0+mc-1, columns p0..p0+kc-1 of op(A)
+// into slivers of mr rows: element (i,p) of sliver s goes
+// to buf[s*kc*mr + p*mr + i], padded with zeros
+//
+void
+packA(bool ta, const Real* a, int lda, int i0, int mc, int p0, int kc,
+      int mr, Real* buf)
+    {
+    for(int is = 0; is < mc; is += mr, buf += kc*mr)
+        {
+        const int ib = std::min(mr,mc-is);
+        for(int p = 0; p < kc; ++p)
+            {
+            Real* bp = buf + p*mr;
+            if(!ta)
+                {
+                const Real* ap = a + (i0+is) + (long)(p0+p)*lda;
+                for(int i = 0; i < ib; ++i) bp[i] = ap[i];
+                }
+            else
+                {
+                const Real* ap = a + (p0+p) + (long)(i0+is)*lda;
+                for(int i = 0; i < ib; ++i) bp[i] = ap[(long)i*lda];
+                }
+            for(int i = ib; i < mr; ++i) bp[i] = 0;
+            }
+        }
+    }
+
+//
+// Copies rows p0..p0+kc-1, columns j0..j0+nc-1 of op(B)
+// into slivers of nr columns: element (p,j) of sliver s
+// goes to buf[s*kc*nr + p*nr + j], padded with zeros
+//
+void
+packB(bool tb, const Real* b, int ldb, int p0, int kc, int j0, int nc,
+      int nr, Real* buf)
+    {
+    const int nsliver = (nc+nr-1)/nr;
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static) if(nsliver > 8 && (long)kc*nc > 65536)
+#endif
+    for(int s = 0; s < nsliver; ++s)
+        {
+        const int js = s*nr;
+        const int jb = std::min(nr,nc-js);
+        Real* bs = buf + (long)s*kc*nr;
+        for(int p = 0; p < kc; ++p)
+            {
+            Real* bp = bs + p*nr;
+            if(!tb)
+                {
+                const Real* sp = b + (p0+p) + (long)(j0+js)*ldb;
+                for(int j = 0; j < jb; ++j) bp[j] = sp[(long)j*ldb];
+                }
+            else
+                {
+                const Real* sp = b + (j0+js) + (long)(p0+p)*ldb;
+                for(int j = 0; j < jb; ++j) bp[j] = sp[j];
+                }
+            for(int j = jb; j < nr; ++j) bp[j] = 0;
+            }
+        }
+    }
+
+//
+// The rows of op(A) for one macro-kernel: sliver s (mr rows)
+// starts at a + s*step, its columns stride apart, except
+// that a final partial sliver is at tail (packed)
+//
+struct ABlock
+    {
+    const Real* a;
+    long step;
+    int stride;
+    const Real* tail;
+    };
+
+//
+// C block (mc x nc at c) = alpha*A*Bpack + beta*C block.
+// Parallel over slivers of B when there is enough work.
+//
+void
+macroKernel(const GemmKernel& K, int mc, int nc, int kc, Real alpha, Real beta,
+            const ABlock& A, const Real* bpack, Real* c, int ldc)
+    {
+    const int mr = K.mr, nr = K.nr;
+    const int nsliver = (nc+nr-1)/nr;
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static) if(nsliver > 1 && (long)mc*nc*kc > 1000000)
+#endif
+    for(int s = 0; s < nsliver; ++s)
+        {
+        Real tile[16*16] __attribute__((aligned(64)));
+        const int js = s*nr;
+        const int jb = std::min(nr,nc-js);
+        const Real* bs = bpack + (long)s*kc*nr;
+        for(int is = 0; is < mc; is += mr)
+            {
+            const int ib = std::min(mr,mc-is);
+            const Real* as = A.a + (is/mr)*A.step;
+            int astride = A.stride;
+            if(ib < mr && A.tail) { as = A.tail; astride = mr; }
+            Real* cs = c + is + (long)js*ldc;
+            if(ib == mr && jb == nr)
+                {
+                K.run(kc,as,astride,bs,alpha,beta,cs,ldc);
+                continue;
+                }
+            //Partial tile: compute in full, then merge
+            K.run(kc,as,astride,bs,1,0,tile,mr);
+            for(int j = 0; j < jb; ++j)
+            for(int i = 0; i < ib; ++i)
+                {
+                Real& cij = cs[i+(long)j*ldc];
+                cij = alpha*tile[i+j*mr] + (beta == 0 ? 0 : beta*cij);
+                }
+            }
+        }
+    }
+
+//Unpacked product for small matrices, where packing does not pay
+void
+smallGemm(bool ta, bool tb, int m, int n, int k, Real alpha,
+          const Real* a, int lda, const Real* b, int ldb,
+          Real beta, Real* c, int ldc)
+    {
+    for(int j = 0; j < n; ++j)
+        {
+        Real* cj = c + (long)j*ldc;
+        if(beta == 0) for(int i = 0; i < m; ++i) cj[i] = 0;
+        else if(beta != 1) for(int i = 0; i < m; ++i) cj[i] *= beta;
+        if(!ta)
+            {
+            for(int p = 0; p < k; ++p)
+                {
+                const Real bpj = alpha*(tb ? b[j+(long)p*ldb] : b[p+(long)j*ldb]);
+                const Real* ap = a + (long)p*lda;
+                for(int i = 0; i < m; ++i) cj[i] += ap[i]*bpj;
+                }
+            }
+        else
+            {
+            for(int i = 0; i < m; ++i)
+                {
+                const Real* ai = a + (long)i*lda;
+                Real s = 0;
+                if(!tb) { const Real* bj = b + (long)j*ldb; for(int p = 0; p < k; ++p) s += ai[p]*bj[p]; }
+                else    { for(int p = 0; p < k; ++p) s += ai[p]*b[j+(long)p*ldb]; }
+                cj[i] += alpha*s;
+                }
+            }
+        }
+    }
+
+void
+gemm(const GemmKernel& K, const Blocking& B, char transa, char transb, 
+     int m, int n, int k, Real alpha, const Real* a, int lda, 
+     const Real* b, int ldb, Real beta, Real* c, int ldc)
+    {
+    if(m <= 0 || n <= 0) return;
+    const bool ta = (transa == 'T' || transa == 't' || transa == 'C' || transa == 'c');
+    const bool tb = (transb == 'T' || transb == 't' || transb == 'C' || transb == 'c');
+
+    if(alpha == 0 || k == 0)
+        {
+        for(int j = 0; j < n; ++j)
+        for(int i = 0; i < m; ++i)
+            c[i+(long)j*ldc] = (beta == 0 ? 0 : beta*c[i+(long)j*ldc]);
+        return;
+        }
+
+    //Skinny products (m < mr or n < nr) are packed too: 
+    //partial tiles cost less than the unpacked loops
+    if((long)m*n*k < 32768)
+        {
+        smallGemm(ta,tb,m,n,k,alpha,a,lda,b,ldb,beta,c,ldc);
+        return;
+        }
+
+    const int kc0 = std::min(B.kc,k);
+    const int mc0 = std::min(B.mc,m + (K.mr - m%K.mr)%K.mr);
+    const int nc0 = std::min(B.nc,n + (K.nr - n%K.nr)%K.nr);
+
+    //When B has only a few slivers, each A sliver is used only
+    //a few times and packing it costs more than it saves: the
+    //micro-kernel reads A in place (only possible if its columns
+    //are contiguous, and except for a final partial sliver)
+    const bool packa = ta || n > 4*K.nr;
+    PackBuffer apack(packa ? (size_t)kc0*mc0 : (size_t)kc0*K.mr), 
+               bpack((size_t)kc0*nc0);
+
+    for(int jc = 0; jc < n; jc += nc0)
+        {
+        const int nc = std::min(nc0,n-jc);
+        for(int pc = 0; pc < k; pc += kc0)
+            {
+            const int kc = std::min(kc0,k-pc);
+            //beta applies to the first pass over C only
+            const Real bet = (pc == 0 ? beta : 1);
+            packB(tb,b,ldb,pc,kc,jc,nc,K.nr,bpack.p);
+            for(int ic = 0; ic < m; ic += mc0)
+                {
+                const int mc = std::min(mc0,m-ic);
+                ABlock A;
+                if(packa)
+                    {
+                    packA(ta,a,lda,ic,mc,pc,kc,K.mr,apack.p);
+                    A.a = apack.p; A.step = (long)kc*K.mr; A.stride = K.mr; A.tail = 0;
+                    }
+                else
+                    {
+                    A.a = a + ic + (long)pc*lda; A.step = K.mr; A.stride = lda; A.tail = 0;
+                    const int mfull = mc - mc%K.mr;
+                    if(mfull < mc)
+                        {
+                        packA(ta,a,lda,ic+mfull,mc-mfull,pc,kc,K.mr,apack.p);
+                        A.tail = apack.p;
+                        }
+                    }
+                macroKernel(K,mc,nc,kc,alpha,bet,A,bpack.p,
+                            c + ic + (long)jc*ldc,ldc);
+                }
+            }
+        }
+    }
+
+} //namespace
+
+const char*
+internal_dgemm_kernel() { return kernel().name; }
+
+void
+internal_dgemm(char transa, char transb, int m, int n, int k, Real alpha,
+               const Real* a, int lda, const Real* b, int ldb,
+               Real beta, Real* c, int ldc)
+    {
+    gemm(kernel(),blocking(),transa,transb,m,n,k,alpha,a,lda,b,ldb,beta,c,ldc);
+    }
+
+bool
+internal_dgemm(const char* kname, char transa, char transb, int m, int n, int k, 
+               Real alpha, const Real* a, int lda, const Real* b, int ldb,
+               Real beta, Real* c, int ldc)
+    {
+    const GemmKernel* K = findKernel(kname);
+    if(K == 0) return false;
+    gemm(*K,Blocking(*K),transa,transb,m,n,k,alpha,a,lda,b,ldb,beta,c,ldc);
+    return true;
+    }
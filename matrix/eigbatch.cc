@@ -0,0 +1,266 @@
+// eigbatch.cc -- Eigen-decomposition of many small symmetric matrices
+//
+// EigenValuesBatched does for each of a set of blocks, such as the
+// quantum number blocks of a density matrix, what EigenValues does
+// for one matrix. Most such blocks are tiny, where the cost of
+// EigenValues is mostly LAPACK's workspace query and allocations,
+// so
+//   1 x 1 and 2 x 2 blocks are done in closed form,
+//   blocks up to jacobi_max by cyclic Jacobi rotations,
+//   larger ones by dsyevd,
+// all with one workspace, sized for the largest block, per thread.
+// Sizes for which backend.h gives another implementation (tred2/tql2
+// or dsyevr, after tuning) use that instead of Jacobi or dsyevd.
+//
+
+#include "matrix.h"
+#include "backend.h"
+#include <math.h>
+#include <float.h>
+#include <algorithm>
+#include <utility>
+#include <string.h>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+extern "C" void dsyevd_(char* jobz, char* uplo, LapackInt* n, Real* a, LapackInt* lda,
+                        Real* w, Real* work, LapackInt* lwork, LapackInt* iwork,
+                        LapackInt* liwork, LapackInt* info);
+
+namespace {
+
+// Largest block done by Jacobi rotations: around here dsyevd
+// catches up, the rotations costing O(n^3) a sweep
+const int jacobi_max = 6;
+const int jacobi_max_sweeps = 50;
+
+// dsyevd's workspace: sized on first use for the largest block,
+// which comes first, and kept for the rest of the batch
+struct EigWork
+    {
+    int nsized;
+    std::vector<Real> work;
+    std::vector<LapackInt> iwork;
+    EigWork() : nsized(0) { }
+    void sizeFor(int n);
+    };
+
+void EigWork::
+sizeFor(int nn)
+    {
+    if(nn <= nsized) return;
+    char jobz = 'V', uplo = 'U';
+    LapackInt n = nn, lwork = -1, liwork = -1, info = 0, qiwork = 0;
+    Real qwork = 0, dummy = 0;
+    dsyevd_(&jobz,&uplo,&n,&dummy,&n,&dummy,&qwork,&lwork,&qiwork,&liwork,&info);
+    if(info != 0)
+        _merror("EigenValuesBatched: error in dsyevd_ (query call)");
+    work.resize(max((LapackInt) qwork,(LapackInt) 1));
+    iwork.resize(max(qiwork,(LapackInt) 1));
+    nsized = nn;
+    }
+
+// Rotation by c = cos(phi), s = sin(phi) zeroing the off-diagonal
+// element apq of [[app, apq], [apq, aqq]]; t = tan(phi)
+inline void
+rotation(Real app, Real apq, Real aqq, Real& c, Real& s, Real& t)
+    {
+    const Real theta = (aqq-app)/(2*apq);
+    t = 1/(fabs(theta) + sqrt(theta*theta+1));
+    if(theta < 0) t = -t;
+    c = 1/sqrt(t*t+1);
+    s = t*c;
+    }
+
+// Sort the n eigenvalues d ascending, carrying the columns of the
+// row-major n x n v along, into D and Z
+void
+sortedResult(int n, const Real* d, const Real* v, Vector& D, Matrix& Z)
+    {
+    int ord[jacobi_max];
+    for(int j = 0; j < n; ++j) ord[j] = j;
+    for(int j = 1; j < n; ++j)
+        for(int i = j; i > 0 && d[ord[i]] < d[ord[i-1]]; --i)
+            std::swap(ord[i],ord[i-1]);
+    D.ReDimension(n);
+    Z.ReDimension(n,n);
+    for(int j = 0; j < n; ++j)
+        {
+        D.el(j) = d[ord[j]];
+        for(int r = 0; r < n; ++r)
+            Z.el(r,j) = v[r*n+ord[j]];
+        }
+    }
+
+void
+eigen2(const MatrixRef& A, Vector& D, Matrix& Z)
+    {
+    const Real app = A(1,1), apq = A(1,2), aqq = A(2,2);
+    Real c = 1, s = 0, t = 0;
+    if(apq != 0) rotation(app,apq,aqq,c,s,t);
+    const Real d[2] = { app - t*apq, aqq + t*apq };
+    const Real v[4] = { c, s, -s, c };
+    sortedResult(2,d,v,D,Z);
+    }
+
+inline void
+rotate(Real& x, Real& y, Real s, Real tau)
+    {
+    const Real g = x, h = y;
+    x = g - s*(h + g*tau);
+    y = h + s*(g - h*tau);
+    }
+
+// Cyclic Jacobi (as in Numerical Recipes), on the upper triangle
+// only; the first sweeps skip elements below a threshold, later
+// ones set to zero any element negligible next to its diagonal.
+// False if the rotations do not converge.
+bool
+eigenJacobi(const MatrixRef& A, Vector& D, Matrix& Z)
+    {
+    const int n = A.Nrows();
+    Real a[jacobi_max*jacobi_max], v[jacobi_max*jacobi_max];
+    Real d[jacobi_max], bd[jacobi_max], zd[jacobi_max];
+    for(int r = 0; r < n; ++r)
+        {
+        for(int c = r; c < n; ++c) a[r*n+c] = A(r+1,c+1);
+        for(int c = 0; c < n; ++c) v[r*n+c] = (r == c ? 1 : 0);
+        d[r] = bd[r] = a[r*n+r];
+        zd[r] = 0;
+        }
+
+    for(int sweep = 0; sweep < jacobi_max_sweeps; ++sweep)
+        {
+        Real sm = 0;
+        for(int p = 0; p < n-1; ++p)
+        for(int q = p+1; q < n; ++q)
+            sm += fabs(a[p*n+q]);
+        if(sm == 0)
+            {
+            sortedResult(n,d,v,D,Z);
+            return true;
+            }
+        const Real tresh = (sweep < 3 ? 0.2*sm/(n*n) : 0);
+
+        for(int p = 0; p < n-1; ++p)
+        for(int q = p+1; q < n; ++q)
+            {
+            Real& apq = a[p*n+q];
+            const Real g = 100*fabs(apq);
+            if(sweep > 3 && fabs(d[p])+g == fabs(d[p]) && fabs(d[q])+g == fabs(d[q]))
+                { apq = 0; continue; }
+            if(fabs(apq) <= tresh) continue;
+
+            Real h = d[q]-d[p], t;
+            if(fabs(h)+g == fabs(h))
+                t = apq/h;
+            else
+                {
+                const Real theta = 0.5*h/apq;
+                t = 1/(fabs(theta)+sqrt(1+theta*theta));
+                if(theta < 0) t = -t;
+                }
+            const Real c = 1/sqrt(1+t*t), s = t*c, tau = s/(1+c);
+            h = t*apq;
+            zd[p] -= h; zd[q] += h;
+            d[p] -= h; d[q] += h;
+            apq = 0;
+            for(int j = 0; j < p; ++j) rotate(a[j*n+p],a[j*n+q],s,tau);
+            for(int j = p+1; j < q; ++j) rotate(a[p*n+j],a[j*n+q],s,tau);
+            for(int j = q+1; j < n; ++j) rotate(a[p*n+j],a[q*n+j],s,tau);
+            for(int j = 0; j < n; ++j) rotate(v[j*n+p],v[j*n+q],s,tau);
+            }
+        for(int p = 0; p < n; ++p)
+            {
+            bd[p] += zd[p];
+            d[p] = bd[p];
+            zd[p] = 0;
+            }
+        }
+    return false;
+    }
+
+void
+eigenSyevd(const MatrixRef& A, Vector& D, Matrix& Z, EigWork& w)
+    {
+    char jobz = 'V', uplo = 'U';
+    w.sizeFor(A.Nrows());
+    LapackInt n = A.Nrows(), info = 0;
+    LapackInt lwork = w.work.size(), liwork = w.iwork.size();
+    Z = A;
+    D.ReDimension(n);
+    dsyevd_(&jobz,&uplo,&n,Z.Store(),&n,D.Store(),&w.work[0],&lwork,
+            &w.iwork[0],&liwork,&info);
+    if(info != 0)
+        {
+        cerr << "info is " << info << endl;
+        _merror("EigenValuesBatched: error in dsyevd_");
+        }
+    //Rows of Z are the eigenvectors
+    Real* z = Z.Store();
+    for(int r = 0; r < n; ++r)
+    for(int c = r+1; c < n; ++c)
+        std::swap(z[r*n+c],z[c*n+r]);
+    }
+
+inline bool
+isImpl(int n, const char* name)
+    { return strcmp(backendFor(EigOp,n),name) == 0; }
+
+void
+eigenBlock(const MatrixRef& A, Vector& D, Matrix& Z, EigWork& w)
+    {
+    const int n = A.Nrows();
+    if(n == 1)
+        {
+        D.ReDimension(1); D(1) = A(1,1);
+        Z.ReDimension(1,1); Z(1,1) = 1;
+        }
+    else if(n == 2)
+        eigen2(A,D,Z);
+    else if(isImpl(n,"dsyevd"))
+        {
+        if(n > jacobi_max || !eigenJacobi(A,D,Z))
+            eigenSyevd(A,D,Z,w);
+        }
+    else
+        backendEigen(A,D,Z);
+    }
+
+} //namespace
+
+void
+EigenValuesBatched(const std::vector<Matrix>& A, std::vector<Vector>& D,
+                   std::vector<Matrix>& Z, bool parallel)
+    {
+    const int nblock = A.size();
+    D.resize(nblock);
+    Z.resize(nblock);
+
+    //Largest first, so that threads finish together
+    std::vector<std::pair<int,int> > bysize(nblock);
+    for(int b = 0; b < nblock; ++b)
+        {
+        const int n = A[b].Nrows();
+        if(A[b].Ncols() != n || n < 1)
+            _merror("EigenValuesBatched: Input Matrix must be square");
+        bysize[b] = std::make_pair(-n,b);
+        }
+    std::sort(bysize.begin(),bysize.end());
+
+#ifdef _OPENMP
+#pragma omp parallel if(parallel && nblock > 1)
+#endif
+    {
+    EigWork w;
+#ifdef _OPENMP
+#pragma omp for schedule(dynamic,1)
+#endif
+    for(int j = 0; j < nblock; ++j)
+        {
+        const int b = bysize[j].second;
+        eigenBlock(A[b],D[b],Z[b],w);
+        }
+    }
+    }
@@ -0,0 +1,263 @@
+// expapply.cc -- Exponential of a BigMatrix applied to a vector
+//
+// Lanczos, with full reorthogonalization, builds an orthonormal basis
+// q_1 ... q_m of the Krylov space of H and v, in which H is the
+// tridiagonal T_m (diagonal a, off-diagonal b), and exp(-tau H) v is
+// approximated by |v| Q_m exp(-tau T_m) e_1. The error of that is
+// estimated (Saad, SIAM J. Numer. Anal. 29, 209 (1992)) by
+// |v| b_m |e_m^T exp(-tau T_m) e_1|, b_m being the norm of the part
+// of H q_m outside the space. Real time is done the same way with
+// cos(tau T_m) and sin(tau T_m).
+//
+
+#include "matrix.h"
+#include "expapply.h"
+#include <math.h>
+#include <float.h>
+using std::cout;
+using std::endl;
+
+namespace {
+
+enum ExpKind { Decay, Rotate };
+
+// Halvings of a time step before giving up
+const int max_halvings = 40;
+
+class Krylov
+    {
+public:
+    Krylov(const BigMatrix& H, Real sign, int maxdim);
+
+    // New space from v; false if v is zero
+    bool start(const VectorRef& v);
+
+    // Grow the space until the error estimate for a step dt is below
+    // err*(norm of the result)*dt/ttot, halving dt if maxdim vectors
+    // do not do; returns the estimate relative to the result
+    Real fit(ExpKind kind, Real& dt, Real err, Real ttot);
+
+    // Coefficients of the result for the step dt; returns the
+    // estimate relative to the result
+    Real step(ExpKind kind, Real dt);
+
+    // exp(-dt H) v, or cos(dt H) v and sin(dt H) v, for the last step
+    void result(VectorRef res) const;
+    void result(VectorRef cres, VectorRef sres) const;
+
+    int dim() const { return m; }
+
+private:
+    const BigMatrix& H;
+    const Real sign;
+    const int maxdim;
+    Matrix Q;		// rows are the q_j, and q_{m+1}
+    Vector a, b;	// T_m
+    Vector ev;		// eigenvalues and eigenvectors of T_m
+    Matrix S;
+    Vector yc, ys;	// result = |v| Q^T yc (Decay), Q^T (yc, ys) (Rotate)
+    Real beta0, tnorm, rnorm;
+    int m;
+    bool invariant;
+
+    void grow();
+    };
+
+Krylov::
+Krylov(const BigMatrix& H_, Real sign_, int maxdim_)
+    : H(H_), sign(sign_), maxdim(min(maxdim_,H_.Size())),
+      Q(maxdim+1,H_.Size()), a(maxdim), b(maxdim),
+      beta0(0), tnorm(0), rnorm(0), m(0), invariant(false)
+    { }
+
+bool Krylov::
+start(const VectorRef& v)
+    {
+    m = 0;
+    tnorm = 0;
+    invariant = false;
+    beta0 = Norm(v);
+    if(beta0 == 0) return false;
+    Q.Row(1) = v;
+    Q.Row(1) *= 1.0/beta0;
+    return true;
+    }
+
+void Krylov::
+grow()
+    {
+    const int j = ++m;
+    VectorRef w = Q.Row(j+1);
+    H.product(Q.Row(j),w);
+    a(j) = Q.Row(j) * w;
+    w -= a(j) * Q.Row(j);
+    if(j > 1) w -= b(j-1) * Q.Row(j-1);
+    for(int i = 1; i <= j; ++i)
+        w -= (Q.Row(i) * w) * Q.Row(i);
+    b(j) = Norm(w);
+
+    tnorm = max(tnorm,fabs(a(j)) + b(j) + (j > 1 ? b(j-1) : 0));
+    if(b(j) <= 100*DBL_EPSILON*tnorm || j == H.Size())
+        {
+        //H q_j is in the space: it is invariant under H
+        b(j) = 0;
+        invariant = true;
+        }
+    else
+        w *= 1.0/b(j);
+
+    Matrix T(j,j);
+    T = 0;
+    for(int i = 1; i <= j; ++i)
+        {
+        T(i,i) = a(i);
+        if(i < j) T(i,i+1) = T(i+1,i) = b(i);
+        }
+    EigenValues(T,ev,S);
+    }
+
+Real Krylov::
+step(ExpKind kind, Real dt)
+    {
+    const Real sdt = sign*dt;
+    yc.ReDimension(m);
+    yc = 0;
+    if(kind == Rotate) { ys.ReDimension(m); ys = 0; }
+    for(int i = 1; i <= m; ++i)
+        {
+        const Real s1 = S(1,i);
+        if(kind == Decay)
+            yc += (s1*exp(-sdt*ev(i))) * S.Column(i);
+        else
+            {
+            yc += (s1*cos(sdt*ev(i))) * S.Column(i);
+            ys += (s1*sin(sdt*ev(i))) * S.Column(i);
+            }
+        }
+    Real last = fabs(yc(m));
+    if(kind == Decay)
+        rnorm = beta0*Norm(yc);
+    else
+        {
+        last = sqrt(yc(m)*yc(m) + ys(m)*ys(m));
+        rnorm = beta0;
+        }
+    if(rnorm == 0) return 0;
+    return beta0*b(m)*last/rnorm;
+    }
+
+Real Krylov::
+fit(ExpKind kind, Real& dt, Real err, Real ttot)
+    {
+    if(m == 0) grow();
+    for(;;)
+        {
+        const Real est = step(kind,dt);
+        if(est <= err*dt/ttot || invariant) return est;
+        if(m == maxdim) break;
+        grow();
+        }
+    for(int h = 0; h < max_halvings; ++h)
+        {
+        dt /= 2;
+        const Real est = step(kind,dt);
+        if(est <= err*dt/ttot) return est;
+        }
+    _merror("ExpApply: no convergence, even for a very small time step");
+    return 0;
+    }
+
+void Krylov::
+result(VectorRef res) const
+    {
+    res = 0;
+    for(int k = 1; k <= m; ++k)
+        res += (beta0*yc(k)) * Q.Row(k);
+    }
+
+void Krylov::
+result(VectorRef cres, VectorRef sres) const
+    {
+    cres = 0;
+    sres = 0;
+    for(int k = 1; k <= m; ++k)
+        {
+        cres += (beta0*yc(k)) * Q.Row(k);
+        sres += (beta0*ys(k)) * Q.Row(k);
+        }
+    }
+
+} //namespace
+
+Real
+ExpApply(const BigMatrix& H, Real tau, VectorRef v, Real err, int maxdim, int debug)
+    {
+    if(v.Length() != H.Size())
+        _merror("ExpApply: v and H have different sizes");
+    const Real ttot = fabs(tau);
+    Krylov K(H,(tau < 0 ? -1 : 1),maxdim);
+    Real left = ttot, errsum = 0;
+    while(left > 0)
+        {
+        if(!K.start(v)) break;
+        Real dt = left;
+        errsum += K.fit(Decay,dt,err,ttot);
+        K.result(v);
+        left -= dt;
+        if(debug > 0)
+            cout << "ExpApply: step " << dt << " with " << K.dim()
+                 << " vectors, time " << ttot-left << endl;
+        }
+    return errsum;
+    }
+
+Real
+ExpApply(const BigMatrix& H, Real tau, VectorRef vr, VectorRef vi,
+         Real err, int maxdim, int debug)
+    {
+    if(vr.Length() != H.Size() || vi.Length() != H.Size())
+        _merror("ExpApply: vr or vi and H have different sizes");
+    const Real ttot = fabs(tau);
+    const Real sign = (tau < 0 ? -1 : 1);
+    Krylov Kr(H,sign,maxdim), Ki(H,sign,maxdim);
+    Vector c(H.Size()), s(H.Size());
+    Real left = ttot, errsum = 0;
+    while(left > 0)
+        {
+        const bool dor = Kr.start(vr), doi = Ki.start(vi);
+        if(!dor && !doi) break;
+
+        //One step for both parts: the shorter of the two they allow
+        Real dt = left, er = 0, ei = 0;
+        if(dor) er = Kr.fit(Rotate,dt,err,ttot);
+        if(doi)
+            {
+            const Real dtr = dt;
+            ei = Ki.fit(Rotate,dt,err,ttot);
+            if(dor && dt < dtr) er = Kr.step(Rotate,dt);
+            }
+        errsum += er + ei;
+
+        //exp(-i dt H) = cos(dt H) - i sin(dt H)
+        if(dor)
+            {
+            Kr.result(c,s);
+            vr = c;
+            vi = -s;
+            }
+        else
+            vr = 0;
+        if(doi)
+            {
+            Ki.result(c,s);
+            vr += s;
+            if(dor) vi += c;
+            else vi = c;
+            }
+        left -= dt;
+        if(debug > 0)
+            cout << "ExpApply: step " << dt << " with " << Kr.dim() << " + "
+                 << Ki.dim() << " vectors, time " << ttot-left << endl;
+        }
+    return errsum;
+    }
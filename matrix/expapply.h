@@ -0,0 +1,30 @@
+// expapply.h -- include file for ExpApply(), the exponential of a
+//               BigMatrix applied to a vector by Lanczos
+
+#ifndef _expapply_h
+#define _expapply_h
+
+#include "bigmatrix.h"
+
+// Only products with H are used (the product() of the BigMatrix, as
+// for David), at most maxdim of them per time step. H is taken to be
+// symmetric. The Krylov space grows until the estimated error of a
+// step is below err times the norm of its result; if maxdim vectors
+// are not enough, the step is cut in half until they are and tau is
+// covered in several steps. Both return the sum over the steps of the
+// estimated (relative) errors.
+
+// v <- exp(-tau H) v : imaginary time evolution
+Real ExpApply(const BigMatrix& H,	// Object containing big hamiltonian
+	      Real tau,			// time step, may be negative
+	      VectorRef v,		// start vector, result on return
+	      Real err = 1E-12,		// error goal for the whole of tau
+	      int maxdim = 30,		// largest Krylov space
+	      int debug = 0);		// Level of debugging printout
+
+// vr + i vi <- exp(-i tau H) (vr + i vi) : real time evolution, with
+// the real and imaginary parts of the wavefunction kept apart
+Real ExpApply(const BigMatrix& H, Real tau, VectorRef vr, VectorRef vi,
+	      Real err = 1E-12, int maxdim = 30, int debug = 0);
+
+#endif
@@ -4,6 +4,7 @@
 #define _matrix_h
 
 #include "matrixref.h"
+#include <vector>
 
 class Vector;			// Defined later 
 class SparseMatrix;
@@ -77,6 +78,10 @@ void Orthog(const MatrixRef &, int nr = 0, int numpass = 2);
 // one argument means do all columns < rows 
 
 void EigenValues(const MatrixRef &, Vector &, Matrix &);
+// EigenValues of each of many (mostly small) blocks, see eigbatch.cc;
+// blocks are shared out over threads if parallel
+void EigenValuesBatched(const std::vector<Matrix>& A, std::vector<Vector>& D,
+                        std::vector<Matrix>& Z, bool parallel = false);
 void GenEigenValues(const MatrixRef&, Vector&, Vector&);
 void HermitianEigenvalues(const Matrix& re, const Matrix& im, Vector& evals,
 	                                Matrix& revecs, Matrix& ievecs);
@@ -90,6 +95,8 @@ void newcomplexSVD(const Matrix& Are, const Matrix& Aim, Matrix& Ure, Matrix& Ui
 Real check_complex_SVD(const Matrix& Mre, const Matrix& Mim, const Matrix& Ure, 
 	        const Matrix& Uim, const Vector& d, const Matrix& Vre, const Matrix& Vim);
 
+void QR(const MatrixRef& A, Matrix& Q, Matrix& R);	// A = Q*R, Q orthonormal columns
+
 void Determinant(const MatrixRef &M,Real& logdet,Real& sign);
 
 Real Determinant(const MatrixRef &M);
@@ -6,6 +6,7 @@
 #include <iomanip>
 #include <memory>
 #include "indent.h"
+#include "backend.h"
 #if defined(i386) || defined(__x86_64)
 extern "C" void dcopy_(int*,Real*,int*,Real*,int*);
 extern "C" void dscal_(int*,Real*,Real*,int*);
@@ -20,8 +21,6 @@ extern "C" void dgema_(char*,char*,int*,int*,Real*,Real*,int*,
 			Real*,Real*,int*,Real*,int*);
 extern "C" void dgemv_(char*,int*,int*,Real*,Real*,int*,Real*,int*,
 				    Real*,Real*,int*);
-extern "C" void dgemm_(char*,char*,int*,int*,int*,Real*,Real*,int*,
-				Real*,int*,Real*,Real*,int*);
 #else
 void daxpy(int n, Real alpha, Real* x, int incx, Real* y, int incy);
 
@@ -385,7 +384,6 @@ AddOuter(const VectorRef & V1, const VectorRef & V2, MatrixRef & M)
 	}
     }
 
-#if defined(i386) || defined(__x86_64)
 void 
 mult(const MatrixRef & M1, const MatrixRef & M2, MatrixRef & M3, int noclear)
     {
@@ -414,68 +412,10 @@ mult(const MatrixRef & M1, const MatrixRef & M2, MatrixRef & M3, int noclear)
     static char pt[] = {'N','T'};
     char transb = pt[M1.DoTranspose()];
     char transa = pt[M2.DoTranspose()];
-    dgemm_(&transa,&transb,&m,&n,&k,&sca,pa,&lda,pb,&ldb, &beta, pc, &ldc);
-    }
-
-#else
-
-xxxx
-
-void dgemm(const MatrixRef & M1, const MatrixRef & M2, MatrixRef & M3,
-		Real alpha, Real beta);
-void 
-mult(const MatrixRef & M1, const MatrixRef & M2, MatrixRef & M3,int noclear)
-    {
-    Real beta = noclear ? 1.0 : 0.0;
-    Real sca = M1.Scale() * M2.Scale();
-    dgemm(M1,M2,M3,sca,beta);		// my own dgemm
-    					// It ignores
-					// scale factors in M1,M2
+// internal_dgemm or dgemm_, by size (see backend.h)
+    backendGemm(transa,transb,m,n,k,sca,pa,lda,pb,ldb,beta,pc,ldc);
     }
 
-/*
-void 
-mult(const MatrixRef & M1, const MatrixRef & M2, MatrixRef & M3,int noclear)
-    {
-// M3_ik = M1_ij * M2_jk
-// Row, Column, (), Nrows(), Ncols() include tranposes
-
-    if(!noclear) M3 = 0.0;
-    int dozeros = 0;	// dozeros: whether to decide by # of zeros
-    Real zf1 = 0.0,zf2 = 0.0;
-    if(min(M1.Nrows(),M2.Ncols()) > 5)
-	{
-	dozeros = 1;
-	Real minzf = min(zf1 = M1.zerofrac(), zf2 = M2.zerofrac());
-	Real maxzf = max(zf1, zf2);
-	if(maxzf < 0.7 || minzf/maxzf > 0.7) dozeros = 0;
-	}
-    if((dozeros && zf1 < zf2) || (!dozeros && M2.Ncols() < M1.Nrows()))
-	{					// want M2.Ncols() small
-	ColumnIter m2col(M2);
-	ColumnIter m3col(M3);
-	while(m2col.inc())			// want  zerofrac2 large
-	    {
-	    m3col.inc();
-	    mult(M1,m2col,m3col,1);
-	    }
-	}
-    else
-	{
-	MatrixRef m2t(M2.t());			// want M1.Nrows() small
-	RowIter m1row(M1);
-	RowIter m3row(M3);
-	while(m1row.inc())				// want  zerofrac1 large
-	    {
-	    m3row.inc();
-	    mult(m2t,m1row,m3row,1);
-	    }
-	}
-    }
-*/
-
-#endif
-
 inline Real 
 quickran(int & idum)
     {
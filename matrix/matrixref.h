@@ -162,6 +162,18 @@ void mult(const MatrixRef &, const MatrixRef &, MatrixRef &,int noclear = 0);
 void mult(const MatrixRef &, const VectorRef &, VectorRef &,int noclear = 0);
 void add(const MatrixRef &, const MatrixRef &, MatrixRef &,int noclear = 0);
 
+// C = alpha*op(A)*op(B) + beta*C, arguments as for BLAS dgemm_
+// (column-major, trans 'N' or 'T'), by the built-in kernels of dgemm.cc
+void internal_dgemm(char transa, char transb, int m, int n, int k, Real alpha,
+		const Real* a, int lda, const Real* b, int ldb,
+		Real beta, Real* c, int ldc);
+const char* internal_dgemm_kernel();	// name of the micro-kernel in use
+// The same with the micro-kernel named kname (generic, avx2 or avx512)
+// instead; false, with C left alone, if the CPU lacks it
+bool internal_dgemm(const char* kname, char transa, char transb, int m, int n, int k,
+		Real alpha, const Real* a, int lda, const Real* b, int ldb,
+		Real beta, Real* c, int ldc);
+
 class MatrixRef
     {
 public:
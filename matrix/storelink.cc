@@ -0,0 +1,162 @@
+// storelink.cc -- Code for StoreLink class
+
+#include <stdlib.h>
+#include <memory.h>
+#include "storelink.h"
+#include "minmax.h"
+
+int 
+StoreLink::defragment(int newsize)	// move object to lower place in heap 
+    {
+    if(NumRef() != 1) return 0;
+    newsize = min(newsize,Storage());
+    if(newsize < 1) return 0;
+    int rsize = sizeof(Real)*newsize;
+    const int stacksize = 10000;
+    if(newsize <= stacksize)
+    	{
+	Real tempstore[stacksize];
+	memcpy((void *) tempstore, (void*) Store(), rsize);
+	dodelete();
+	donew(newsize);
+	memcpy((void *) Store(), (void*) tempstore, rsize);
+	return 1;
+	}
+    else
+    	{
+	StoreLink S(newsize);
+	if(S.Store() != 0 && S.Store() < Store())
+	    {
+	    memcpy((void*) S.Store(), (void*) Store(), rsize);
+	    *this << S;
+	    return 1;
+	    }
+	return 0;
+	}
+    }
+
+// Size-class pool
+
+#include <pthread.h>
+#ifdef STORELINK_HUGEPAGES
+#include <sys/mman.h>
+#endif
+
+#ifdef STORELINK_HUGEPAGES
+static const int hugepage = 2*1024*1024;	// bytes
+#endif
+
+static Real * 
+heapalloc(int n)
+    {
+    void * m = 0;
+#if defined(STORELINK_HUGEPAGES) && defined(MADV_HUGEPAGE)
+    if(n*sizeof(Real) >= (size_t) hugepage)
+	{
+	if(posix_memalign(&m,hugepage,n*sizeof(Real)) != 0) m = 0;
+	else madvise(m,n*sizeof(Real),MADV_HUGEPAGE);
+	}
+    else
+#endif
+    m = malloc(n*sizeof(Real));
+    if(m == 0)
+	{
+	std::cerr << "StoreLink: out of memory allocating " << n << " Reals" << std::endl;
+	abort();
+	}
+    return (Real *) m;
+    }
+
+// Free blocks are chained through their first word.
+// Plain data, so it can live in thread-local storage.
+struct PoolCache
+    {
+    Real * head[StoreLink::nclass];
+    long cached;			// Reals held by this cache
+    long hits, misses;
+    bool registered;
+    };
+
+static __thread PoolCache cache;
+
+static pthread_key_t cachekey;
+static pthread_once_t cachekeyonce = PTHREAD_ONCE_INIT;
+
+static void 
+releasecache(void *) 
+    { 
+    StoreLink::ReleasePool(); 
+    cache.registered = false;
+    }
+
+static void makecachekey() { pthread_key_create(&cachekey,releasecache); }
+
+int & 
+StoreLink::PoolLimit()
+    {
+    static int poollimit_ = 1 << 22;	// 32 MB of cached blocks per thread
+    return poollimit_;
+    }
+
+int 
+StoreLink::classsize(int c)
+    {
+    if(c == 0) return minclass;
+    int b = 4 + (c-1)/4;
+    return (5 + (c-1)%4) << (b-2);
+    }
+
+Real * 
+StoreLink::poolalloc(int n)
+    {
+    int c = sizeclass(n);
+    if(c < 0) return heapalloc(n);
+    Real * r = cache.head[c];
+    if(r != 0)
+	{
+	cache.head[c] = *((Real **) r);
+	int cs = classsize(c);
+	cache.cached -= cs;
+	cache.hits++;
+	return r;
+	}
+    cache.misses++;
+    return heapalloc(classsize(c));
+    }
+
+void 
+StoreLink::poolfree(Real * r, int n)
+    {
+    int c = sizeclass(n);
+    if(c < 0) { free(r); return; }
+    int cs = classsize(c);
+    if(cache.cached + cs > PoolLimit()) { free(r); return; }
+    if(!cache.registered)		// Hand the cache back at thread exit
+	{
+	pthread_once(&cachekeyonce,makecachekey);
+	pthread_setspecific(cachekey,&cache);
+	cache.registered = true;
+	}
+    *((Real **) r) = cache.head[c];
+    cache.head[c] = r;
+    cache.cached += cs;
+    }
+
+void 
+StoreLink::ReleasePool()
+    {
+    for(int c = 0; c < nclass; c++)
+	while(cache.head[c] != 0)
+	    {
+	    Real * r = cache.head[c];
+	    cache.head[c] = *((Real **) r);
+	    free(r);
+	    }
+    cache.cached = 0;
+    }
+
+long StoreLink::PoolHits() { return cache.hits; }
+
+long StoreLink::PoolMisses() { return cache.misses; }
+
+long StoreLink::PoolCached() { return cache.cached; }
@@ -10,9 +10,17 @@ typedef double Real;
 
 // The Matrix/Vector Ref classes have a StoreLink, which prevents the 
 // storage on which they are based from being deleted prematurely. 
-// StoreLink utilizes reference counting. The ref classes never 
+// StoreLink utilizes reference counting, with counts updated atomically
+// so that storage may be shared between threads. The ref classes never 
 // allocate storage. The actual storage classes utilize makestorage, 
 // etc. for allocation.
+//
+// Blocks are rounded up to a size class (four classes per power
+// of two) and freed blocks are kept in a per-thread cache, so
+// that the many equal-sized temporaries made by tensor code
+// are recycled instead of going back to the heap. Blocks larger
+// than the biggest class go straight to the heap. Compile with
+// -DSTORELINK_HUGEPAGES to back large blocks with huge pages.
 
 class StoreReport;
 
@@ -52,6 +60,15 @@ public:
     inline ~StoreLink();
     inline static int NumObjects();
     inline static int TotalStorage();
+// Size-class pool, for the calling thread: requests served from and
+// missed by its cache, and Reals held in it. PoolLimit is the 
+// per-thread cache limit in Reals (0 turns pooling off).
+    static long PoolHits();
+    static long PoolMisses();
+    static long PoolCached();
+    static int& PoolLimit();
+    static void ReleasePool();		// Empty this thread's cache.
+    enum { minclass = 16, maxpooled = 1 << 20, nclass = 65 };
     friend class StoreReport;
 private:
     storerep *p;			// Only data member
@@ -64,6 +81,10 @@ private:
     enum { offset = (sizeof(storerep)-1) / sizeof(Real) + 1 };
     inline void donew(int s);
     inline void dodelete();
+    inline static int sizeclass(int n);	// -1 if n is not pooled
+    static int classsize(int c);
+    static Real * poolalloc(int n);
+    static void poolfree(Real *, int n);
 // " =" is private, not allowed.  Put in to replace default shallow copy.
     inline StoreLink & operator = (const StoreLink &); 
     };
@@ -90,29 +111,42 @@ inline void StoreLink::donew(int s)
     {
     if (s > 0)
 	{
-	p = (storerep *) new Real[s + offset];
-	p->numref = 1; p->storage = s; storageinuse += s;
-	numberofobjects++;
+	p = (storerep *) poolalloc(s + offset);
+	p->numref = 1; p->storage = s; 
+	__sync_add_and_fetch(&storageinuse,s);
+	__sync_add_and_fetch(&numberofobjects,1);
 	// cout << "Making storage address " << (long)(p) << endl;
 	}
     else  
-	{ p = pnullrep; p->numref++; }
+	{ p = pnullrep; __sync_add_and_fetch(&p->numref,1); }
     }
 
 inline void StoreLink::dodelete()
     { 
-    if(--p->numref == 0) 
+    if(__sync_sub_and_fetch(&p->numref,1) == 0) 
 	{
 	// cout << "Deleting storage address " << (long)(p) << endl;
-	storageinuse -= p->storage; numberofobjects--;
-	delete [] ((Real *) p);
+	__sync_sub_and_fetch(&storageinuse,p->storage);
+	__sync_sub_and_fetch(&numberofobjects,1);
+	poolfree((Real *) p, p->storage + offset);
 //	if(storageinuse <= 0)
 //	    cout << "Storage in use is now " << storageinuse << endl;
 	}
     }
 
+// Class 0 holds up to 16 Reals; above that, n with 2^b < n <= 2^(b+1) 
+// is rounded up to a multiple of 2^(b-2).
+inline int StoreLink::sizeclass(int n)
+    {
+    if(n <= minclass) return 0;
+    if(n > maxpooled) return -1;
+    int b = 31 - __builtin_clz(n-1);
+    int q = ((n-1) >> (b-2)) + 1;		// 5..8
+    return 1 + 4*(b-4) + (q-5);
+    }
+
 inline StoreLink::StoreLink() : p(pnullrep)
-    { p->numref++; }
+    { __sync_add_and_fetch(&p->numref,1); }
 
 inline Real * StoreLink::Store() const
     { return ((Real *)p)+offset; }
@@ -124,11 +158,11 @@ inline int StoreLink::Storage() const { return p->storage; }
 inline StoreLink::~StoreLink() { dodelete(); }
 
 inline StoreLink::StoreLink(const StoreLink & S) : p(S.p)
-    { p->numref++; }
+    { __sync_add_and_fetch(&p->numref,1); }
 
 inline StoreLink & StoreLink::operator<<(const StoreLink & S)		
     { 			
-    if(this != &S) { dodelete(); p = S.p; p->numref++; }
+    if(this != &S) { __sync_add_and_fetch(&S.p->numref,1); dodelete(); p = S.p; }
     return *this; 
     }
 
@@ -137,7 +171,17 @@ inline StoreLink::StoreLink(int s)
 
 inline void StoreLink::makestorage(int s)	// Negative s treated as 0
     {
-    if(p->storage != s) { dodelete(); donew(s); }
+    if(p->storage == s) return;
+    // Unshared block of the same size class: just relabel it
+    if(s > 0 && p->numref == 1 && p != pnullrep
+       && sizeclass(s + offset) >= 0
+       && sizeclass(s + offset) == sizeclass(p->storage + offset))
+	{
+	__sync_add_and_fetch(&storageinuse,s - p->storage);
+	p->storage = s;
+	return;
+	}
+    dodelete(); donew(s);
     }
 
 inline void StoreLink::increasestorage(int s)
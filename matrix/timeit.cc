@@ -0,0 +1,177 @@
+// timeit.cc -- Time the matrix package
+//
+// "timeit gemm" times matrix products only: BLAS dgemm_ against
+// internal_dgemm, on square matrices and on the shapes which DMRG
+// produces for bond dimension m, site dimension d and MPO bond
+// dimension w. "timeit eig" times EigenValues only; with no
+// argument both are run. "timeit tune [maxsize] [file]" times each
+// implementation of gemm, eig, svd and qr and writes the fastest
+// by size to the tuning file (see backend.h).
+#define THIS_IS_MAIN
+
+#include "matrix.h"
+#include "backend.h"
+#include "cputime.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/time.h>
+
+extern "C" void dgemm_(char*,char*,int*,int*,int*,Real*,Real*,int*,
+				Real*,int*,Real*,Real*,int*);
+
+enum sii {size = 2000};
+
+inline Real
+walltime()
+    {
+    struct timeval tv;
+    gettimeofday(&tv,NULL); 
+    return tv.tv_sec + tv.tv_usec * 1.0e-6;
+    }
+
+// Times C = A*B for C m x n and A m x k, column-major as in
+// dgemm_, with op(A) = A^T if ta (and likewise for B);
+// returns the largest difference of the results
+Real
+timeGemm(const char* name, int m, int n, int k, bool ta, bool tb)
+    {
+    char transa = ta ? 'T' : 'N', transb = tb ? 'T' : 'N';
+    int lda = ta ? k : m, ldb = tb ? n : k, ldc = m;
+    Vector A(m*k), B(k*n), C1(m*n), C2(m*n);
+    A.Randomize(); B.Randomize();
+    Real alpha = 1, beta = 0;
+
+    const Real flop = 2.0*m*n*k;
+    const int nrep = int(std::max(1.0,std::min(1000.0,2e9/flop)));
+
+    Real t = walltime();
+    for(int r = 0; r < nrep; ++r)
+	dgemm_(&transa,&transb,&m,&n,&k,&alpha,A.Store(),&lda,B.Store(),&ldb,&beta,C1.Store(),&ldc);
+    const Real tblas = (walltime()-t)/nrep;
+
+    t = walltime();
+    for(int r = 0; r < nrep; ++r)
+	internal_dgemm(transa,transb,m,n,k,alpha,A.Store(),lda,B.Store(),ldb,beta,C2.Store(),ldc);
+    const Real tint = (walltime()-t)/nrep;
+
+    C2 -= C1;
+    const Real diff = Norm(C2)/Norm(C1);
+    printf("%-16s %5d %5d %5d  %c%c  %8.2f %8.2f  %5.2f  %.1e\n",name,m,n,k,transa,transb,
+	   flop/tblas*1e-9,flop/tint*1e-9,tblas/tint,diff);
+    return diff;
+    }
+
+void
+timeGemms()
+    {
+    printf("internal_dgemm kernel: %s\n",internal_dgemm_kernel());
+    printf("%-16s %5s %5s %5s  %2s  %8s %8s  %5s  %s\n","shape","m","n","k","op",
+	   "GF/s blas","GF/s int","ratio","rel. diff");
+    for(int s = 64; s <= 1024; s *= 2)
+	timeGemm("square",s,s,s,false,false);
+    timeGemm("square",1000,1000,1000,true,false);
+    timeGemm("square",1000,1000,1000,false,true);
+
+    const int w = 5;
+    for(int m = 100; m <= 400; m *= 2)
+    for(int d = 2; d <= 4; d += 2)
+	{
+	// L(m,w,m')*psi(m,d,d,m"): open m' w against d d m"
+	timeGemm("edge*psi",m*w,d*d*m,m,true,false);
+	// (L*psi)*W(w,d,d',w'): contracting w d with the MPO tensor
+	timeGemm("*mpo",m*d*m,d*w,w*d,false,false);
+	// density matrix psi*psi^T of a two-site wavefunction
+	timeGemm("denmat",m*d,m*d,m*d,false,true);
+	// projecting with A(m,d,m')
+	timeGemm("project",m*d,m,m*d,true,false);
+	}
+    }
+
+void
+timeEigs()
+{
+    for(int size = 125; size <= 1000; size += 50)
+	{
+    /*
+	cerr << "size = " << size << endl;
+	Matrix A(size, size);
+	A.Randomize();
+	Matrix B(A),C(A);
+	cpu_time cpu;
+	struct timeval tv;
+	gettimeofday(&tv,NULL);
+	Real startu = tv.tv_sec + tv.tv_usec * 1.0e-6;
+	//cerr << "starting " << startu << endl;
+	C = A * B;
+	gettimeofday(&tv,NULL);
+	Real endu = tv.tv_sec + tv.tv_usec * 1.0e-6;
+	//cerr << "done " << endu << endl;
+	Real wtime = (endu-startu);
+	cerr << "wall time is " << wtime << endl;
+	cpu_time since(cpu.sincemark());
+	cerr << "total computer time for matrix multiply is = " << since << endl;
+	cerr << (2.0*size*size*size*1.0e-6)/since.time << " Megaflops (each thread)\n";
+	cerr << (2.0*size*size*size*1.0e-6)/wtime << " Megaflops (total)\n";
+    */
+    Matrix A(size,size);
+    A.Randomize();
+    Matrix U(size,size); Vector d(size);
+	cpu_time cpu;
+	struct timeval tv;
+	gettimeofday(&tv,NULL); Real startu = tv.tv_sec + tv.tv_usec * 1.0e-6;
+    EigenValues(A,d,U);
+	gettimeofday(&tv,NULL); Real endu = tv.tv_sec + tv.tv_usec * 1.0e-6;
+	//cerr << "done " << endu << endl;
+	Real wtime = (endu-startu);
+	cerr << "wall time is " << wtime << endl;
+	cpu_time since(cpu.sincemark());
+	cerr << "total computer time for diagonalization is = " << since << endl;
+	cerr << (2.0*size*size*size*1.0e-6)/since.time << " Megaflops (each thread)\n";
+	cerr << (2.0*size*size*size*1.0e-6)/wtime << " Megaflops (total)\n";
+    //cerr << size << " " << since << endl;
+
+	} //for(int size = 125; size <= 1000; size += 50)
+
+    //Accuracy check
+    int size = 4;
+    Matrix A(size,size);
+    A(1,1) = 4; A(1,2) = 3; A(1,3) = 2; A(1,4) = 1;
+    A(2,1) = 3; A(2,2) = 3; A(2,3) = 7; A(2,4) = 6;
+    A(3,1) = 2; A(3,2) = 7; A(3,3) = 2; A(3,4) = 2;
+    A(4,1) = 1; A(4,2) = 6; A(4,3) = 2; A(4,4) = 1;
+    Matrix U(size,size); Vector d(size);
+    EigenValues(A,d,U);
+    cerr << "d is " << endl << d;
+    cerr << "U is " << endl << U;
+
+    /*
+    Output should be (up to a possible permutation of eigenvalues):
+        d is 
+        -5.996795 -0.616085 2.753738 13.859142 
+
+        U is 
+        -0.070702 -0.131570 0.925353 -0.348443 
+        0.724973 -0.010475 -0.194834 -0.660564 
+        -0.499688 0.680000 -0.136859 -0.518827 
+        -0.468752 -0.721235 -0.295011 -0.416006 
+    */
+
+
+}
+
+int main(int argc, char* argv[])
+    {
+    if(argc > 1 && strcmp(argv[1],"tune") == 0)
+	{
+	const int maxsize = (argc > 2 ? atoi(argv[2]) : 512);
+	autotuneBackends(argc > 3 ? argv[3] : 0,maxsize);
+	return 0;
+	}
+    const bool gemm = (argc < 2 || strcmp(argv[1],"gemm") == 0);
+    const bool eig = (argc < 2 || strcmp(argv[1],"eig") == 0);
+    if(gemm) timeGemms();
+    if(eig) timeEigs();
+    return 0;
+    }
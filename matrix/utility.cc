@@ -4,16 +4,15 @@
 #include "tarray1.h"
 #include "minmax.h"
 #include <math.h>
+#include <float.h>
 #define CHANGE      0
 #include <fstream>
-
-using std::cout;
-using std::cerr;
-using std::endl;
+#include <vector>
+#include "backend.h"
 
 void Orthog(const MatrixRef& M,int num,int numpass)	// Orthonormalize a Matrix M to num cols
     {
-    //const Real tolerance = 1e-10;
+    // const Real tolerance = 1e-10;
 
     int nkeep;			// Orthogonalize to at most the column dim 
     if (num > M.Nrows() || (num == 0 && M.Ncols() > M.Nrows()))
@@ -223,7 +222,9 @@ static void dotranspose(Real *z, int n)
 static void tql2(Vector& D, Vector& E, Matrix& Z)
     {
 //   Tracer et("Evalue(tql2)"); 
-    Real eps = FloatingPointPrecision::Epsilon ();
+    //Converge to the precision of Real, not that of
+    //FloatingPointPrecision (float, see precisio.h)
+    Real eps = DBL_EPSILON;
     int n = D.Length ();
     Real *z = Z.Store ();
     dotranspose(z,n);
@@ -383,8 +384,7 @@ static void tql2(Vector& D, Vector& E, Matrix& Z)
     dotranspose(z,n);
     }
 
-/*
-static void tred3(const Matrix& X, Vector& D, Vector& E, Matrix& A)
+/* static void tred3(const Matrix& X, Vector& D, Vector& E, Matrix& A)
 {
    Real tol =
       FloatingPointPrecision::Minimum()/FloatingPointPrecision::Epsilon();
@@ -423,11 +423,9 @@ static void tred3(const Matrix& X, Vector& D, Vector& E, Matrix& A)
       }
       *d = *a; *a = h;
    }
-}
-*/
+}*/
 
-/*
-static void tql1(Vector& D, Vector& E)
+/*static void tql1(Vector& D, Vector& E)
 {
 //   Tracer et("Evalue(tql1)");
    Real eps = FloatingPointPrecision::Epsilon();
@@ -484,8 +482,7 @@ static void tql1(Vector& D, Vector& E)
       if (!test) i=0;
       D.el(i) = p;
    }
-}
-*/
+}*/
 
 void BackupEigenValues(const MatrixRef& A, Vector& D, Matrix& Z)
 {
@@ -576,6 +573,7 @@ void EigenValues(const MatrixRef& A, Vector& D, Matrix& Z)
 }
 */
 
+
 #else      // }}---{{
            // copy from next "#else" till "endif", part of the origional code
  // C++ interfaces to Numerical Recipes routines, other machine
@@ -585,7 +583,7 @@ void EigenValues(const MatrixRef& A, Vector& D, Matrix& Z)
 void ludcmp(Matrix& a,int* indx,Real* d)
     {
     const Real TINY = 1e-20;
-    int i, imax, j, k;
+    int i, imax=0, j, k;
     Real big, dum, sum, temp;
     Real *vv;
     int n = a.Nrows();
@@ -1255,6 +1253,9 @@ void Sort(Vector& V, IntArray1& ind)
     }
 
 /*
+#ifdef __alpha
+// extern "C" int dfft_(char*,char*,char*,Real*,Real*,int*,int*);
+// extern "C" int dfft_(char*,char*,char*,Real*,Real*,Real*,Real*,int*,int*);
 
 int FFT(const VectorRef& in, Vector& outre, Vector& outim)
     {
@@ -1291,43 +1292,29 @@ Matrix Exp(const MatrixRef& M)
     return y * Transpose(evec);
     }
 
+extern "C" void dgeev_(char* jobvl, char* jobvr, LapackInt* n, Real* a, LapackInt* lda,
+		       Real* wr, Real* wi, Real* vl, LapackInt* ldvl, Real* vr, LapackInt* ldvr,
+		       Real* work, LapackInt* lwork, LapackInt* info);
 
+// Eigenvalues in increasing order, eigenvectors in the columns of Z;
+// tred2/tql2, dsyevd or dsyevr by size (see backend.h)
 void EigenValues(const MatrixRef& A, Vector& D, Matrix& Z)
 {
-    __CLPK_integer N = A.Ncols();
-    if (N != A.Nrows() || A.Nrows() < 1)
-      _merror("EigenValues: Input Matrix must be square");
-
-    char jobz = 'V';
-    char uplo = 'U';
-    __CLPK_integer lwork = max(1,3*N-1);//max(1, 1+6*N+2*N*N);
-    __CLPK_doublereal work[lwork];
-    __CLPK_integer info;
-    
-    D.ReDimension(N);
-    Z = A;
+    if (A.Ncols() != A.Nrows() || A.Nrows() < 1)
+        _merror("EigenValues: Input Matrix must be square");
 
-    dsyev_(&jobz,&uplo,&N,Z.Store(),&N,D.Store(),work,&lwork,&info);
+    //If in debug mode, check that A is symmetric
+    assert(Norm(((Matrix)(A -A.t())).TreatAsVector()) < 1E-10);
 
-    if(info != 0)
+    if(A.Ncols() == 1)
 	{
-        cerr << "info is " << info << endl;
-        cout << "info is " << info << endl;
-        cout << "redoing EigenValues " << endl;
-        cerr << "redoing EigenValues " << endl;
-        Matrix AA(A);
-        for(int i = 1; i <= N; i++)
-        for(int j = i+1; j <= N; j++)
-        {
-            if(AA(i,j) != AA(j,i))
-                cout << "Asym: " << i SP j SP AA(i,j) SP AA(j,i) << endl;
-        }
-        BackupEigenValues(A,D,Z);
+        Z = A;
+        Z(1,1) = 1.0;
+        D = A.Column(1);
         return;
 	}
 
-    //Transpose Z before return
-    Z = Z.t();
+    backendEigen(A,D,Z);
 }
 
 void GenEigenValues(const MatrixRef& A, Vector& Re, Vector& Im)
@@ -1342,30 +1329,37 @@ void GenEigenValues(const MatrixRef& A, Vector& Re, Vector& Im)
         return;
 	}
 
-    int n = A.Ncols();
+    LapackInt n = A.Ncols();
 
     char jobvl = 'N'; //don't compute left evecs
     char jobvr = 'N'; //don't compute right evecs
 
-    int lwork = max(1,4*n);
-    Vector Work(lwork); Work = 0;
-
     Matrix Z = A;
     Re = A.Column(1);
     Im = Re;
 
-    Vector noevecs(2); noevecs = 0; //Shouldn't be referenced by dgeev
-    int num_evecs = 1;
+    double QWORK[1];
+    LapackInt qlwork = -1;
+    double* noevecs = 0; LapackInt num_evecs = 1;
 
-    int info = 0;
+    //Query work size
+    LapackInt info = 0;
+    dgeev_(&jobvl,&jobvr,&n,Z.Store(),&n,Re.Store(),Im.Store(),noevecs,&num_evecs,noevecs,&num_evecs,QWORK,&qlwork,&info);
+	if(info != 0)
+    {
+        cerr << "info is " << info << endl;
+        _merror("Error condition in dgeev_ (query call).");
+    }
 
     //Call routine
-    //      JOBVL JOBVR  N   A       LDA   WR         WI         VL             LDVL       VR               LDVR      WORK        LWORK   INFO 
-    dgeev_(&jobvl,&jobvr,&n,Z.Store(),&n,Re.Store(),Im.Store(),noevecs.Store(),&num_evecs,noevecs.Store(),&num_evecs,Work.Store(),&lwork,&info);
+    LapackInt lwork = (LapackInt) QWORK[0];
+    std::vector<double> WORK(lwork);
+    info = 0;
+    dgeev_(&jobvl,&jobvr,&n,Z.Store(),&n,Re.Store(),Im.Store(),noevecs,&num_evecs,noevecs,&num_evecs,&WORK[0],&lwork,&info);
 	if(info != 0)
     {
         cerr << "info is " << info << endl;
-        _merror("Error condition in dsyev_.");
+        _merror("Error condition in dgeev_.");
     }
 }
 
@@ -1376,9 +1370,9 @@ void rotate22(double *zki,double *zki1,double c,double s,int n)
     double *pzki1 = zki1 - 1;
     double *pzki = zki - 1;
     static double junk[10];
-    int nr = n&3 + 4;	// Same as n%4 + 4
+    int nr = (n&3) + 4;	// Same as n%4 + 4
+    if(nr > n) nr = n;	// n < 4: no main loop, and no more than n left
     int nmain = n-nr;
-    if(nmain < 0) nmain = 0;
     int k;
     if(nmain > 0)
 	{
@@ -1467,7 +1461,7 @@ double dotprod(double *a,double *b, int l)
     register double s0 = 0, s1 = 0, s2 = 0, s3 = 0;	// 4
     register double t0 = 0, t1 = 0, t2 = 0, t3 = 0;	// 4
     register double a0,b0,a1,b1,a2,b2,a3,b3;
-    register double prea,preb;
+    register double prea=0,preb=0;
     int i,ll = l&3;
     for(i = l-ll; i < l; i++)
 	s3 += a[i] * b[i];
@@ -1991,79 +1985,17 @@ double dpythag_(double *a, double *b)
     } 
 
 
-typedef long int lint;
-
-/*
-extern "C" lint dgesdd_(char*,lint*,lint*,double*,lint*,double*,
-	    double*,lint*,double*,lint*,double*,lint*,lint*,lint*);
-*/
-
+// SVD (the port above) or dgesdd by size (see backend.h)
 void newSVD(const MatrixRef& A, Matrix& U, Vector& d, Matrix& V)
-    {
-    __CLPK_integer m = A.Nrows(), n = A.Ncols(); 
-    if(m < n)
-	{
-	Matrix AA = A.t();
-	Matrix Ut, Vt;
-	newSVD(AA,Ut,d,Vt);
-	U = Vt.t();
-	V = Ut.t();
-	return;
-	}
-    char jobz = 'S';
-    Matrix AA = A.t();
-    Matrix UU(n,m), VV(n,n);
-    d.ReDimension(n);
-    __CLPK_integer lda = m, ldu = m, ldv = n, info;
-    __CLPK_integer lwork = -1;
-    Vector work(10), iwork(8*n);
-
-    dgesdd_(&jobz,&m,&n,AA.Store(), &lda,d.Store(), UU.Store(), &ldu,
-	    VV.Store(), &ldv, work.Store(), &lwork,
-	    (__CLPK_integer *)iwork.Store(), &info);
-    lwork = (int)work(1);
-    //cout << "optimal size is " << work(1) << endl;
-    //cout << "m, n, lwork are " << m SP n SP lwork << endl;
-    work.ReDimension(lwork);
+    { backendSVD(A,U,d,V); }
 
-    dgesdd_(&jobz,&m,&n,AA.Store(), &lda,d.Store(), UU.Store(), &ldu,
-	    VV.Store(), &ldv, work.Store(), &lwork,
-	    (__CLPK_integer *)iwork.Store(), &info);
-    U = UU.t();
-    V = VV.t();
-    if(1)
-	{
-	Matrix du(U);
-	for(int i = 1; i <= du.Ncols(); i++)
-	    du.Column(i) *= d(i);
-	Matrix ch = du * V;
-	ch -= A;
-	Real er = Norm(ch.TreatAsVector())/d.sumels();
-	//cout << "SVD error is " << er << endl;
-	if(er > .0000001)
-	    {
-	    SVD(A,U,d,V);
-	    Matrix du(U);
-	    for(int i = 1; i <= du.Ncols(); i++)
-		du.Column(i) *= d(i);
-	    Matrix ch = du * V;
-	    ch -= A;
-	    Real er2 = Norm(ch.TreatAsVector())/d.sumels();
-	    if(er2 > .0000001)
-		{
-		cout << "A is " << endl << A;
-		cout << "U is " << endl << U;
-		cout << "d is " << endl << d;
-		cout << "V is " << endl << V;
-		Matrix t = U.t() * U;
-		cout << "U.t * U is\n" << t;
-		t = V * V.t();
-		cout << "V * V.t is\n" << t;
-		cout << "ch is \n" << ch;
-		exit(0);
-		}
-	    }
-	}
+// A = Q R, Q having orthonormal columns and R upper triangular,
+// both of inner dimension min(m,n)
+void QR(const MatrixRef& A, Matrix& Q, Matrix& R)
+    {
+    if(A.Nrows() < 1 || A.Ncols() < 1)
+	_merror("QR: empty Matrix");
+    backendQR(A,Q,R);
     }
 
 void getrowbasis(Matrix& B, Real cutoff,bool nopivot = false)	// cutoff is in norm^2 of a row, 10^-20 is OK
@@ -2193,10 +2125,11 @@ Real check_complex_SVD(const Matrix& Mre, const Matrix& Mim, const Matrix& Ure,
     return Norm(Matrix(Mre-resre).TreatAsVector()) + Norm(Matrix(Mim-resim).TreatAsVector());
     }
 
+/*
 void newcomplexSVD(const Matrix& Are, const Matrix& Aim, Matrix& Ure, Matrix& Uim, 
 	Vector& d, Matrix& Vre, Matrix& Vim)
     {
-    __CLPK_integer m = Are.Nrows(), n = Are.Ncols(); 
+    int m = Are.Nrows(), n = Are.Ncols(); 
     if(m < n)
 	{
 	Matrix mret = Are.t(), mimt = -Aim.t(),UUre,UUim,VVre,VVim;
@@ -2219,37 +2152,35 @@ void newcomplexSVD(const Matrix& Are, const Matrix& Aim, Matrix& Ure, Matrix& Ui
     Vre.ReDimension(n,n);
     Vim.ReDimension(n,n);
     d.ReDimension(n);
-    __CLPK_integer lda = m, ldu = m, ldv = n, info;
-    __CLPK_integer lwork = -1;
+    int lda = m, ldu = m, ldv = n, info;
+    int lwork = -1;
     Vector work(2*n*n+2*n+m+100), iwork(8*n), rwork(10*n*n+10 *n+1000);
     lwork = n*n+n+m+50;
 
-    /*
-    zgesdd_(&jobz,&m,&n,(__CLPK_doublecomplex*)AA.Store(), 
-	    &lda,d.Store(), (__CLPK_doublecomplex*)UU.Store(), 
-	    &ldu, (__CLPK_doublecomplex*)VV.Store(), &ldv, 
-	    (__CLPK_doublecomplex*)work.Store(), &lwork, (__CLPK_integer *)iwork.Store(), &info);
-     JOBZ, [M], [N], A, [LDA], S, U, [LDU], VT, [LDVT], 
-		  *       [WORK], [LWORK], [RWORK], [IWORK], [INFO])
-    int zgesdd_(char*, __CLPK_integer*, __CLPK_integer*, __CLPK_doublecomplex*,
-	    __CLPK_integer*, __CLPK_doublereal*, __CLPK_doublecomplex*,
-	    __CLPK_integer*, __CLPK_doublecomplex*, __CLPK_integer*,
-	    __CLPK_doublecomplex*, __CLPK_integer*, __CLPK_doublereal*,
-	    __CLPK_integer*, __CLPK_integer*)' 
-    lwork = (int)work(1);
+    //zgesdd_(&jobz,&m,&n,(__CLPK_doublecomplex*)AA.Store(), 
+	//    &lda,d.Store(), (__CLPK_doublecomplex*)UU.Store(), 
+	//    &ldu, (__CLPK_doublecomplex*)VV.Store(), &ldv, 
+	//    (__CLPK_doublecomplex*)work.Store(), &lwork, (int *)iwork.Store(), &info);
+    // JOBZ, [M], [N], A, [LDA], S, U, [LDU], VT, [LDVT], 
+    //		  *       [WORK], [LWORK], [RWORK], [IWORK], [INFO])
+    //int zgesdd_(char*, int*, int*, __CLPK_doublecomplex*,
+	//    int*, __CLPK_doublereal*, __CLPK_doublecomplex*,
+	//    int*, __CLPK_doublecomplex*, int*,
+	//    __CLPK_doublecomplex*, int*, __CLPK_doublereal*,
+	//    int*, int*)' 
+    //lwork = (int)work(1);
     //cout << "optimal size is " << work(1) << endl;
     //cout << "m, n, lwork are " << m SP n SP lwork << endl;
-    work.ReDimension(lwork*2);
-    */
+    //work.ReDimension(lwork*2);
 
     zgesdd_(&jobz,&m,&n,(__CLPK_doublecomplex*)AA.Store(), &lda,d.Store(), (__CLPK_doublecomplex*)UU.Store(), &ldu,
 	    (__CLPK_doublecomplex*)VV.Store(), &ldv, (__CLPK_doublecomplex*)work.Store(), &lwork,
-	    rwork.Store(), (__CLPK_integer *)iwork.Store(), &info);
+	    rwork.Store(), (int *)iwork.Store(), &info);
     bool do_over = false;
     if(info != 0) do_over = true;
     //dgesdd_(&jobz,&m,&n,AA.Store(), &lda,d.Store(), UU.Store(), &ldu,
 //	    VV.Store(), &ldv, work.Store(), &lwork,
-//	    (__CLPK_integer *)iwork.Store(), &info);
+//	    (int *)iwork.Store(), &info);
     for(int i = 1; i <= n; i++)
 	for(int j = 1; j <= m; j++)
 	    Ure(j,i) = UU(i,2*j-1), Uim(j,i) = UU(i,2*j);
@@ -2320,7 +2251,7 @@ void newcomplexSVD(const Matrix& Are, const Matrix& Aim, Matrix& Ure, Matrix& Ui
 	    cout << "Norm of Uim is " << Norm(Uim.TreatAsVector()) << endl;
 	    cout << "Norm of Vre is " << Norm(Vre.TreatAsVector()) << endl;
 	    cout << "Norm of Vim is " << Norm(Vim.TreatAsVector()) << endl;
-	    std::ofstream outfile;
+	    ofstream outfile;
 	    outfile.open("bad_matrix");
 	    int nrows = Are.Nrows(), ncols = Are.Ncols();
 	    outfile.write((char*)&nrows,sizeof(nrows)); 
@@ -2345,18 +2276,19 @@ void newcomplexSVD(const Matrix& Are, const Matrix& Aim, Matrix& Ure, Matrix& Ui
 	    }
 	}
     }
+*/
 
 
 #include <complex>
 #include <vector>
-typedef std::complex<double> Complex;
+typedef complex<double> Complex;
 static Complex I(0.0,1.0), C1(1.0,0.0),C0(0.0,0.0);
 inline Real sqr(Real a) { return a*a; }
 
 class ComplexVector
     {
 public:
-    std::vector<Complex> dat;
+    vector<Complex> dat;
     ComplexVector(int n=1) : dat(n,C0) { }
     Complex& operator()(int i) { return dat[i-1]; }			// access 1 ... n
     Complex operator()(int i) const { return dat[i-1]; }
@@ -2398,7 +2330,7 @@ public:
 class ComplexMatrix
     {
 public:
-    std::vector<Complex> dat;
+    vector<Complex> dat;
     int nrow, ncol;
     int index(int r, int c) const { 
 	if(r > nrow || c > ncol) error("bac index");
@@ -2498,8 +2430,8 @@ void CSVD(ComplexMatrix a,   ComplexMatrix& u, Vector& s, ComplexMatrix& v)
     double tol, w, x, y, z;
     eta = 2.8E-16;			/* eta = the relative machine precision */
     tol = 4.0E-293; 		/* tol = the smallest normalized positive number, divided by eta */
-    /* eta = 2^-52 * 1.26 fudge*/
-    /* tol = 2^-1023 / eta */
+    /* eta = 2^-52 * 1.26 fudge
+     * tol = 2^-1023 / eta */
     np = n + p;
     nM1 = n - 1;
     L = 0;
@@ -2817,10 +2749,15 @@ void SVDcomplex(const Matrix& Mre, const Matrix& Mim, Matrix& Ure,
     Vim = -V.ImMat().t();
     }
 
+extern "C"
+void zheev_(char *jobz, char *uplo, LapackInt *n, Complex *a, 
+            LapackInt *lda, double *w, Complex *work, LapackInt *lwork, 
+            double *rwork, LapackInt *info );
+
 void HermitianEigenvalues(const Matrix& re, const Matrix& im, Vector& evals,
 	                                Matrix& revecs, Matrix& ievecs)
     {
-    __CLPK_integer N = re.Ncols();
+    LapackInt N = re.Ncols();
     if (N != re.Nrows() || re.Nrows() < 1)
       _merror("HermitianEigenValues: Input Matrix must be square");
     if(im.Ncols() != N || im.Nrows() != N)
@@ -2831,14 +2768,15 @@ void HermitianEigenvalues(const Matrix& re, const Matrix& im, Vector& evals,
 
     char jobz = 'V';
     char uplo = 'U';
-    __CLPK_integer lwork = max(1,3*N-1);//max(1, 1+6*N+2*N*N);
-    __CLPK_doublecomplex work[lwork];
-    __CLPK_doublereal rwork[lwork];
-    __CLPK_integer info;
+    LapackInt lwork = max(1,3*(int)N-1);//max(1, 1+6*N+2*N*N);
+    std::vector<Complex> work(lwork);
+    std::vector<double> rwork(lwork);
+    LapackInt info;
     
     evals.ReDimension(N);
 
-    zheev_(&jobz,&uplo,&N,(__CLPK_doublecomplex*)&(H.dat[0]),&N,evals.Store(),work,&lwork,rwork,&info);
+    zheev_(&jobz,&uplo,&N,&(H.dat[0]),&N,evals.Store(),
+           &work[0],&lwork,&rwork[0],&info);
     revecs = H.RealMat().t();
     ievecs = H.ImMat().t();
 
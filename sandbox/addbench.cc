@@ -0,0 +1,80 @@
+//
+// Times ITensor::operator+= on wavefunctions A(l,s,t,r) of
+// bond dimension m, in the cases which used to take more
+// than one pass over storage: the left operand having the
+// smaller scale (so it had to be rescaled first), and the
+// right operand having its indices in another order, with
+// and without a scale factor. Also times summing nterm
+// such tensors, as projOpTerms does, one += at a time
+// against a single sum().
+//
+#define THIS_IS_MAIN
+#include "core.h"
+#include "cputime.h"
+using boost::format;
+using std::cout;
+using std::endl;
+using std::vector;
+
+int main(int argc, char* argv[])
+    {
+    const int m = (argc > 1 ? atoi(argv[1]) : 100);
+    const int d = (argc > 2 ? atoi(argv[2]) : 2);
+    const int nterm = (argc > 3 ? atoi(argv[3]) : 5);
+    const int nrep = (argc > 4 ? atoi(argv[4]) : 200);
+
+    Index l("l",m), s("s",d), t("t",d), r("r",m);
+    ITensor A(l,s,t,r), B(l,s,t,r), P(r,t,l,s);
+    A.Randomize(); B.Randomize(); P.Randomize();
+    ITensor Bs = B*1E3, Ps = P*1E3;
+
+    //R has storage of its own, so += never copies it. Scaling
+    //R down first (which only changes its scale) leaves the 
+    //larger scale on the right.
+    const char* name[] = { "same order, equal scales",
+                           "same order, larger scale on right",
+                           "permuted, equal scales",
+                           "permuted, larger scale on right" };
+    const ITensor* rhs[] = { &B, &Bs, &P, &Ps };
+    ITensor R(l,s,t,r);
+    R.Randomize();
+    cpu_time cpu;
+    for(int c = 0; c < 4; ++c)
+        {
+        const bool down = (c%2 == 1);
+        cpu.mark();
+        for(int n = 0; n < nrep; ++n) 
+            { 
+            if(down) R *= 1E-6; 
+            R += *rhs[c]; 
+            }
+        const Real tc = cpu.sincemark().time;
+        cout << format("%-34s %.3E s per +=\n")%name[c]%(tc/nrep);
+        }
+
+    vector<ITensor> terms(nterm);
+    for(int k = 0; k < nterm; ++k)
+        {
+        terms[k] = (k%2 == 0 ? A : P);
+        terms[k] *= (k+1);
+        }
+
+    cpu.mark();
+    for(int n = 0; n < nrep; ++n)
+        {
+        R = terms[0];
+        for(int k = 1; k < nterm; ++k) R += terms[k];
+        }
+    const Real tloop = cpu.sincemark().time/nrep;
+    ITensor R1 = R;
+
+    cpu.mark();
+    for(int n = 0; n < nrep; ++n) sum(terms,R);
+    const Real tsum = cpu.sincemark().time/nrep;
+
+    R -= R1;
+    cout << format("%d terms, one += each:  %.3E s\n")%nterm%tloop;
+    cout << format("%d terms, sum():         %.3E s (|diff|/|sum| = %.1E)\n")
+            %nterm%tsum%(R.norm()/R1.norm());
+    return 0;
+    }
@@ -0,0 +1,76 @@
+//
+// Counts the cost of handing tensors around by value on the
+// spin-1 Heisenberg chain of iqdmrg.cc. Times priming,
+// scaling and contracting the site tensors of a converged
+// IQMPS (and of its ITensor blocks), which pass and return
+// tensors by value, then runs a few more sweeps reporting
+// time, the number of storage requests (StoreLink pool hits
+// plus misses) and the storage objects still alive
+// (StoreLink::NumObjects).
+//
+#define THIS_IS_MAIN
+#include "core.h"
+#include "hams.h"
+#include "cputime.h"
+using boost::format;
+using std::cout;
+using std::endl;
+
+long 
+nrequests() { return StoreLink::PoolHits() + StoreLink::PoolMisses(); }
+
+int main(int argc, char* argv[])
+    {
+    const int N = (argc > 1 ? atoi(argv[1]) : 100);
+    const int maxm = (argc > 2 ? atoi(argv[2]) : 100);
+    const int nrep = (argc > 3 ? atoi(argv[3]) : 20);
+
+    SpinOne::Model model(N);
+    IQMPO H = SpinOne::Heisenberg(model)();
+    InitState initState(N);
+    for(int i = 1; i <= N; ++i) initState(i) = (i%2==1 ? model.Up(i) : model.Dn(i));
+    IQMPS psi(model,initState);
+    Sweeps sweeps(Sweeps::ramp_m,4,1,maxm,1E-5);
+    DMRGOpts opts;
+    dmrg(psi,H,sweeps,opts);
+
+    //Site tensors and their blocks
+    int nblock = 0;
+    cpu_time cpu;
+    IQTensor R;
+    for(int n = 0; n < nrep; ++n)
+    for(int i = 2; i < N; ++i)
+        {
+        R = primed(psi.AA(i));
+        R = 2 * psi.AA(i);
+        R = primelink(psi.AA(i)) * H.AA(i);
+        }
+    Real tiq = cpu.sincemark().time;
+
+    cpu.mark();
+    ITensor T;
+    for(int n = 0; n < nrep; ++n)
+    for(int i = 2; i < N; ++i)
+    for(IQTensor::const_iten_it b = psi.AA(i).const_iten_begin(); b != psi.AA(i).const_iten_end(); ++b)
+        {
+        T = primed(*b);
+        T = 2 * *b;
+        T = deprimed(T) * *b;
+        if(n == 0) ++nblock;
+        }
+    Real tit = cpu.sincemark().time;
+
+    cout << format("primed, 2*A and A*B on %d site tensors, %d times\n")%(N-2)%nrep;
+    cout << format("  IQTensor:          %.3f s\n")%tiq;
+    cout << format("  ITensor (%d blocks): %.3f s\n")%nblock%tit;
+
+    Sweeps more(Sweeps::fixed_m,2,maxm,maxm,1E-5);
+    long req = nrequests();
+    cpu.mark();
+    Real En = dmrg(psi,H,more,opts);
+    Real tdmrg = cpu.sincemark().time;
+    cout << format("2 sweeps: %.3f s, energy %.10f\n")%tdmrg%En;
+    cout << format("  storage requests %ld, live storage objects %d\n")
+            %(nrequests()-req)%StoreLink::NumObjects();
+    return 0;
+    }
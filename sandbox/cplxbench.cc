@@ -0,0 +1,89 @@
+//
+// Times products, conj and Dot of complex ITensors, as in
+// real-time evolution: a complex wavefunction A(l,s,m)
+// contracted with a complex B(m,t,r) over the link m.
+// Compares the primer path (contracting with ReImPrimer,
+// ReImPrimerP and the ComplexProd table) with the default
+// operator*=, and reports the real product of the same shape
+// as a reference.
+//
+#define THIS_IS_MAIN
+#include "core.h"
+#include "cputime.h"
+using boost::format;
+using std::cout;
+using std::endl;
+
+ITensor
+randomComplex(const Index& i1, const Index& i2, const Index& i3)
+    {
+    ITensor re(i1,i2,i3), im(i1,i2,i3);
+    re.Randomize();
+    im.Randomize();
+    return re*ITensor::Complex_1() + im*ITensor::Complex_i();
+    }
+
+int main(int argc, char* argv[])
+    {
+    const int m = (argc > 1 ? atoi(argv[1]) : 100);
+    const int d = (argc > 2 ? atoi(argv[2]) : 4);
+    const int nrep = (argc > 3 ? atoi(argv[3]) : 10);
+
+    Index l("l",m), s("s",d), k("k",m), t("t",d), r("r",m);
+    ITensor A = randomComplex(l,s,k);
+    ITensor B = randomComplex(k,t,r);
+    ITensor Ar, Ai, Br, Bi;
+    A.SplitReIm(Ar,Ai);
+    B.SplitReIm(Br,Bi);
+
+    cpu_time cpu;
+    ITensor C1;
+    for(int n = 0; n < nrep; ++n)
+        {
+        C1 = A;
+        C1 *= ITensor::ReImPrimer();
+        C1 *= ITensor::ComplexProd() * (B * ITensor::ReImPrimerP());
+        }
+    Real tprimer = cpu.sincemark().time/nrep;
+
+    cpu.mark();
+    ITensor C2;
+    for(int n = 0; n < nrep; ++n)
+        C2 = A * B;
+    Real tprod = cpu.sincemark().time/nrep;
+
+    cpu.mark();
+    ITensor C3;
+    for(int n = 0; n < nrep; ++n)
+        C3 = Ar * Br;
+    Real treal = cpu.sincemark().time/nrep;
+
+    ITensor diff = C1; diff *= -1; diff += C2;
+
+    cpu.mark();
+    ITensor cA;
+    for(int n = 0; n < nrep; ++n)
+        cA = A / ITensor::ConjTensor();
+    Real tconjprod = cpu.sincemark().time/nrep;
+
+    cpu.mark();
+    for(int n = 0; n < nrep; ++n)
+        cA = conj(A);
+    Real tconj = cpu.sincemark().time/nrep;
+
+    cpu.mark();
+    Real re = 0, im = 0;
+    for(int n = 0; n < nrep; ++n)
+        Dot(C2,C1,re,im);
+    Real tdot = cpu.sincemark().time/nrep;
+
+    cout << format("A(%d,%d,%d)*B(%d,%d,%d), %d repetitions\n")%m%d%m%m%d%m%nrep;
+    cout << format("primer product:  %.3E s\n")%tprimer;
+    cout << format("operator*=:      %.3E s (%.2f times faster)\n")%tprod%(tprimer/tprod);
+    cout << format("real product:    %.3E s\n")%treal;
+    cout << format("|primer - operator*=| / |C| = %.2E\n")%(fabs(diff.norm())/fabs(C1.norm()));
+    cout << format("conj by product: %.3E s\n")%tconjprod;
+    cout << format("conj:            %.3E s\n")%tconj;
+    cout << format("Dot (re,im):     %.3E s, <C,C> = %.6E + i %.2E\n")%tdot%re%im;
+    return 0;
+    }
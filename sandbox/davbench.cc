@@ -0,0 +1,131 @@
+//
+// Compares the Davidson solvers on the bond problems of
+// the spin-1 Heisenberg chain of iqdmrg.cc. After a few
+// warm-up sweeps, one left-to-right half sweep solves every
+// bond with David (flattening the wavefunction into a Vector
+// around every product), with the tensor-native davidson of
+// eigensolver.h, and with davidson preconditioned by the
+// diagonal of the local Hamiltonian (projOpDiag). Reports
+// matvecs, time and matvecs per second of each.
+//
+#define THIS_IS_MAIN
+#include "core.h"
+#include "hams.h"
+#include "cputime.h"
+using boost::format;
+using std::cout;
+using std::endl;
+using std::vector;
+
+typedef LocalHam<IQTensor,IQTensor> IQLocalHam;
+
+//BigMatrix for David counting its products
+class CountedHam : public BigMatrix
+    {
+    const IQLocalHam& H;
+public:
+    mutable int nmatvec;
+
+    CountedHam(const IQLocalHam& H_) : H(H_), nmatvec(0) { }
+
+    int Size() const { return H.Size(); }
+    VectorRef DiagRef() const { return H.DiagRef(); }
+
+    Vector operator*(const VectorRef& A) const
+        { Vector res(Size()); product(A,res); return res; }
+
+    void product(const VectorRef& A, VectorRef& B) const
+        { ++nmatvec; H.product(A,B); }
+    };
+
+//Tensor-native operator for davidson counting its products
+struct CountedOp
+    {
+    const IQLocalHam& H;
+    mutable int nmatvec;
+
+    CountedOp(const IQLocalHam& H_) : H(H_), nmatvec(0) { }
+
+    void product(const IQTensor& phi, IQTensor& Hphi) const
+        { ++nmatvec; H.product(phi,Hphi); }
+    };
+
+int main(int argc, char* argv[])
+    {
+    const int N = (argc > 1 ? atoi(argv[1]) : 100);
+    const int maxm = (argc > 2 ? atoi(argv[2]) : 100);
+    const int nwarm = (argc > 3 ? atoi(argv[3]) : 3);
+    const Real cutoff = (argc > 4 ? atof(argv[4]) : 1E-5);
+    const int niter = (argc > 5 ? atoi(argv[5]) : 4);
+    const Real errgoal = (argc > 6 ? atof(argv[6]) : 1E-4);
+
+    SpinOne::Model model(N);
+    IQMPO H = SpinOne::Heisenberg(model)();
+
+    InitState initState(N);
+    for(int i = 1; i <= N; ++i) initState(i) = (i%2==1 ? model.Up(i) : model.Dn(i));
+    IQMPS psi(model,initState);
+
+    Sweeps sweeps(Sweeps::ramp_m,nwarm,1,maxm,cutoff);
+    Real En = dmrg(psi,H,sweeps);
+    cout << format("Energy after %d warm-up sweeps = %.10f\n")%nwarm%En;
+
+    psi.position(1);
+    vector<IQTensor> PH(N+1);
+    for(int l = N-1; l >= 2; --l)
+        psi.projectOp(l+1,Fromright,PH[l+1],H.AA(l+1),PH[l]);
+
+    Real tflat = 0, ttens = 0, tprec = 0, maxdiff = 0;
+    int nflat = 0, ntens = 0, nprec = 0;
+    cpu_time cpu;
+    for(int b = 1; b < N; ++b)
+        {
+        IQTensor mpoh = H.bondTensor(b);
+        IQTensor phi = psi.bondTensor(b);
+        putInQNs(phi,mpoh,PH[b],PH[b+1]);
+
+        //David on a flattened copy of phi
+        IQTensor phi1(phi);
+        IQLocalHam lham1(PH[b],PH[b+1],mpoh,phi1);
+        CountedHam flat(lham1);
+        cpu.mark();
+        Matrix evecs(niter,phi1.vec_size());
+        Vector evals;
+        phi1.assignToVec(evecs.Row(1));
+        evecs.Row(1) /= Norm(evecs.Row(1));
+        David(flat,1,errgoal,evals,evecs,1,1,0);
+        phi1.assignFromVec(evecs.Row(1));
+        tflat += cpu.sincemark().time;
+        nflat += flat.nmatvec;
+
+        //davidson directly on the IQTensor blocks
+        IQTensor phi2(phi);
+        IQLocalHam lham2(PH[b],PH[b+1],mpoh,phi2);
+        CountedOp tens(lham2);
+        cpu.mark();
+        Real E2 = davidson(tens,phi2,niter,errgoal);
+        ttens += cpu.sincemark().time;
+        ntens += tens.nmatvec;
+
+        maxdiff = max(maxdiff,fabs(E2-evals(1)));
+
+        //Preconditioned davidson, including the cost of the diagonal
+        IQTensor phi3(phi);
+        IQLocalHam lham3(PH[b],PH[b+1],mpoh,phi3);
+        CountedOp prec(lham3);
+        cpu.mark();
+        lham3.computeDiag();
+        davidson(prec,lham3.DiagRef(),phi3,niter,errgoal);
+        tprec += cpu.sincemark().time;
+        nprec += prec.nmatvec;
+
+        psi.doSVD(b,phi2,Fromleft);
+        if(b != N-1) psi.projectOp(b,Fromleft,PH[b],H.AA(b),PH[b+1]);
+        }
+
+    cout << format("David:    %6d matvecs in %.3f s, %.1f matvecs/s\n")%nflat%tflat%(nflat/tflat);
+    cout << format("davidson: %6d matvecs in %.3f s, %.1f matvecs/s\n")%ntens%ttens%(ntens/ttens);
+    cout << format("precond.: %6d matvecs in %.3f s, %.1f matvecs/s\n")%nprec%tprec%(nprec/tprec);
+    cout << format("Largest bond energy difference = %.2E\n")%maxdiff;
+    return 0;
+    }
@@ -0,0 +1,58 @@
+//
+// Times EigenValuesBatched against one EigenValues call per
+// block on sets of nblock random symmetric blocks of each size
+// n from 1 to nmax, as the quantum number blocks of a density
+// matrix, and checks that both give the same eigenvalues.
+//
+#define THIS_IS_MAIN
+#include "core.h"
+#include "cputime.h"
+using boost::format;
+using std::cout;
+using std::endl;
+using std::vector;
+
+int main(int argc, char* argv[])
+    {
+    const int nmax = (argc > 1 ? atoi(argv[1]) : 24);
+    const int nblock = (argc > 2 ? atoi(argv[2]) : 64);
+
+    cout << format("%4s %12s %12s %7s %9s\n")%"n"%"EigenValues"%"batched"%"ratio"%"max diff";
+    cpu_time cpu;
+    for(int n = 1; n <= nmax; ++n)
+        {
+        vector<Matrix> A(nblock);
+        for(int b = 0; b < nblock; ++b)
+            {
+            Matrix S(n,n);
+            S.Randomize();
+            A[b] = S + S.t();
+            }
+        const int nrep = 20000/(n*n*n) + 1;
+
+        vector<Vector> d(nblock);
+        vector<Matrix> U(nblock);
+        cpu.mark();
+        for(int r = 0; r < nrep; ++r)
+        for(int b = 0; b < nblock; ++b)
+            EigenValues(A[b],d[b],U[b]);
+        const Real tone = cpu.sincemark().time/(nrep*nblock);
+
+        vector<Vector> D;
+        vector<Matrix> Z;
+        cpu.mark();
+        for(int r = 0; r < nrep; ++r)
+            EigenValuesBatched(A,D,Z);
+        const Real tbat = cpu.sincemark().time/(nrep*nblock);
+
+        Real diff = 0;
+        for(int b = 0; b < nblock; ++b)
+            {
+            d[b] -= D[b];
+            diff = max(diff,Norm(d[b]));
+            }
+        cout << format("%4d %9.3f us %9.3f us %7.2f %9.1E\n")
+                %n%(tone*1E6)%(tbat*1E6)%(tone/tbat)%diff;
+        }
+    return 0;
+    }
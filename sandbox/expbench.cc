@@ -0,0 +1,111 @@
+//
+// Compares ExpApply (expapply.h) with the dense Exp of utility.cc
+// on the two-site wavefunctions of the middle bond of a spin-1/2
+// Heisenberg chain, after a DMRG calculation at bond dimension m
+// (wavefunction size 4 m^2). The dense route has to make H
+// from one product per column before Exp can be taken. For real
+// time the reference is cos(tau H) and sin(tau H) from the
+// eigenvectors of H. Reports times, products of H and the
+// difference between the results.
+//
+#define THIS_IS_MAIN
+#include "core.h"
+#include "hams.h"
+#include "expapply.h"
+#include "cputime.h"
+using boost::format;
+using std::cout;
+using std::endl;
+using std::vector;
+
+void
+compare(int N, int m, Real tau, Real err)
+    {
+    SpinHalf::Model model(N);
+    MPO H = SpinHalf::SquareLattice::Heisenberg(model,1)();
+    InitState initState(N);
+    for(int i = 1; i <= N; ++i) initState(i) = (i%2==1 ? model.Up(i) : model.Dn(i));
+    MPS psi(model,initState);
+    Sweeps sweeps(Sweeps::ramp_m,2,m,m,0);
+    dmrg(psi,H,sweeps);
+
+    const int b = N/2;
+    psi.position(b);
+    vector<ITensor> L(N+2), R(N+2);
+    for(int l = 1; l < b; ++l)
+        psi.projectOp(l,Fromleft,L[l],H.AA(l),L[l+1]);
+    for(int l = N; l > b+1; --l)
+        psi.projectOp(l,Fromright,R[l],H.AA(l),R[l-1]);
+    ITensor mpoh = H.bondTensor(b);
+    ITensor phi = psi.bondTensor(b);
+    LocalHam<ITensor,ITensor> lham(L[b],R[b+1],mpoh,phi);
+    const int n = lham.Size();
+
+    Vector v(n);
+    phi.assignToVec(v);
+    v /= Norm(v);
+
+    //Dense: H from n products, then Exp
+    cpu_time cpu;
+    Matrix Hd(n,n);
+    Vector e(n);
+    for(int i = 1; i <= n; ++i)
+        {
+        e = 0; e(i) = 1;
+        VectorRef row = Hd.Row(i);
+        lham.product(e,row);
+        }
+    const Real tbuild = cpu.sincemark().time;
+    cpu.mark();
+    Vector xd = Exp(-tau*Hd)*v;
+    const Real texp = cpu.sincemark().time;
+
+    //Krylov, imaginary time
+    int np = lham.numProducts();
+    cpu.mark();
+    Vector x = v;
+    ExpApply(lham,tau,x,err);
+    const Real tkry = cpu.sincemark().time;
+    const int nimag = lham.numProducts() - np;
+    x -= xd;
+    const Real dimag = Norm(x)/Norm(xd);
+
+    //Krylov, real time, against the eigenvectors of Hd
+    Vector d; Matrix U;
+    EigenValues(Hd,d,U);
+    Vector c = v*U, s = v*U;
+    for(int i = 1; i <= n; ++i)
+        {
+        c(i) *= cos(tau*d(i));
+        s(i) *= -sin(tau*d(i));
+        }
+    Vector xr = U*c, xi = U*s;
+    np = lham.numProducts();
+    cpu.mark();
+    Vector yr = v, yi(n);
+    yi = 0;
+    ExpApply(lham,tau,yr,yi,err);
+    const Real treal = cpu.sincemark().time;
+    const int nreal = lham.numProducts() - np;
+    yr -= xr; yi -= xi;
+    const Real dreal = sqrt(yr*yr + yi*yi);
+
+    cout << format("m = %2d, n = %4d: dense %.3E s (%d products %.3E s, Exp %.3E s)\n")
+            %m%n%(tbuild+texp)%n%tbuild%texp;
+    cout << format("   ExpApply exp(-tau H):   %.3E s, %3d products, |diff| = %.1E\n")
+            %tkry%nimag%dimag;
+    cout << format("   ExpApply exp(-i tau H): %.3E s, %3d products, |diff| = %.1E\n")
+            %treal%nreal%dreal;
+    }
+
+int main(int argc, char* argv[])
+    {
+    const int N = (argc > 1 ? atoi(argv[1]) : 20);
+    const Real tau = (argc > 2 ? atof(argv[2]) : 0.1);
+    const Real err = (argc > 3 ? atof(argv[3]) : 1E-12);
+    const int ms[] = { 4, 8, 16, 24 };
+
+    for(int j = 0; j < 4; ++j)
+        compare(N,ms[j],tau,err);
+    return 0;
+    }
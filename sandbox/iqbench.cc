@@ -0,0 +1,92 @@
+//
+// Times IQTensor products on the Hubbard chain of hams.h:
+// building the Trotter gates (many products of small site
+// operators) and applying a gate to, and forming the reduced
+// density matrix of, a two-site wavefunction whose link
+// indices carry many (sz,Nf) sectors.
+//
+#define THIS_IS_MAIN
+#include "core.h"
+#include "hams.h"
+#include "cputime.h"
+using boost::format;
+using std::cout;
+using std::endl;
+using std::vector;
+
+//Link index with nsec (sz,Nf) sectors of dimension m each
+IQIndex
+makeLink(const std::string& name, int nf, int m, Arrow dir)
+    {
+    vector<inqn> iq;
+    for(int Nf = 0; Nf <= nf; ++Nf)
+    for(int sz = -Nf; sz <= Nf; sz += 2)
+        iq.push_back(inqn(Index(nameint(name+" sector ",iq.size()+1),m,Link),QN(sz,Nf)));
+    return IQIndex(name,iq,dir);
+    }
+
+//Random wavefunction with zero total divergence
+IQTensor
+randomPhi(const IQIndex& L, const IQIndex& s1, const IQIndex& s2, const IQIndex& R)
+    {
+    IQTensor phi(L,s1,s2,R);
+    for(int a = 1; a <= L.nindex(); ++a)
+    for(int b = 1; b <= s1.nindex(); ++b)
+    for(int c = 1; c <= s2.nindex(); ++c)
+    for(int d = 1; d <= R.nindex(); ++d)
+        {
+        QN div = L.qn(L.index(a))*L.dir() + s1.qn(s1.index(b))*s1.dir()
+               + s2.qn(s2.index(c))*s2.dir() + R.qn(R.index(d))*R.dir();
+        if(div != QN()) continue;
+        ITensor t(L.index(a),s1.index(b),s2.index(c),R.index(d));
+        t.Randomize();
+        phi += t;
+        }
+    return phi;
+    }
+
+int main(int argc, char* argv[])
+    {
+    const int N = 10;
+    const int nf = (argc > 1 ? atoi(argv[1]) : 8);
+    const int m = (argc > 2 ? atoi(argv[2]) : 4);
+    const int nrep = (argc > 3 ? atoi(argv[3]) : 20);
+
+    Hubbard::Model mod(N);
+    Hubbard::HubbardChain hc(mod);
+
+    cpu_time cpu;
+    vector<IQTensor> gates(N);
+    hc.getTrotterGates(4,0.05,0,gates);
+    Real tgate = cpu.sincemark().time;
+    cout << format("Trotter gates for N = %d: %.3f s\n")%N%tgate;
+
+    IQIndex L = makeLink("L",nf,m,In);
+    IQIndex R = makeLink("R",nf+2,m,Out);
+    IQTensor phi = randomPhi(L,mod.si(4),mod.si(5),R);
+    cout << format("phi: %d blocks, %d elements\n")%phi.iten_size()%phi.vec_size();
+
+    cpu.mark();
+    Real nrm = 0;
+    for(int k = 0; k < nrep; ++k)
+        {
+        IQTensor nphi = phi * gates[4];
+        nphi.noprime();
+        nrm += nphi.norm();
+        }
+    Real tapply = cpu.sincemark().time/nrep;
+
+    cpu.mark();
+    IQTensor rho;
+    for(int k = 0; k < nrep; ++k)
+        {
+        IQTensor cphi = primeind(phi,L,mod.si(4));
+        cphi.conj();
+        rho = phi * cphi;
+        }
+    Real trho = cpu.sincemark().time/nrep;
+
+    cout << format("apply gate:     %.3E s (norm %.6f)\n")%tapply%(nrm/nrep);
+    cout << format("density matrix: %.3E s (%d blocks, norm %.6f)\n")%trho%rho.iten_size()%rho.norm();
+    return 0;
+    }
@@ -0,0 +1,90 @@
+//
+// Compares permuteData with the generic Counter-style loop
+// formerly used by ITensor::reshapeDat, for every
+// permutation of rank 3 through 6 tensors.
+//
+#define THIS_IS_MAIN
+#include "core.h"
+#include "cputime.h"
+#include <algorithm>
+using boost::format;
+using std::cout;
+using std::endl;
+
+//The catch-all loop of the old reshapeDat: walk src in
+//order and recompute the full dest index for every element
+void
+oldPermute(const Permutation& P, const boost::array<int,NMAX+1>& dims,
+           int r, const Real* src, Real* dest)
+    {
+    const Permutation::int9& ind = P.ind();
+    boost::array<int,NMAX+1> n, i;
+    n.assign(1); i.assign(1);
+    for(int j = 1; j <= r; ++j) n[ind[j]] = dims[j];
+    boost::array<int*,NMAX+1> j;
+    for(int k = 1; k <= NMAX; ++k) { j[ind[k]] = &(i[k]); }
+    int len = 1;
+    for(int k = 1; k <= r; ++k) len *= dims[k];
+
+    for(int c = 0; c < len; ++c)
+        {
+        dest[((((((((*j[8]-1)*n[7]+*j[7]-1)*n[6]+*j[6]-1)*n[5]+*j[5]-1)*n[4]+*j[4]-1)*n[3]+*j[3]-1)*n[2]+*j[2]-1)*n[1]+*j[1])-1]
+            = src[c];
+        for(int k = 1; k <= r; ++k)
+            {
+            if(++i[k] <= dims[k]) break;
+            i[k] = 1;
+            }
+        }
+    }
+
+int main(int argc, char* argv[])
+    {
+    const int nrep = 5;
+    for(int r = 3; r <= 6; ++r)
+        {
+        //Roughly 2^20 elements for every rank
+        const int m = int(pow(1048576.,1./r)+0.5);
+        boost::array<int,NMAX+1> dims;
+        dims.assign(1);
+        int len = 1;
+        for(int j = 1; j <= r; ++j) { dims[j] = m; len *= m; }
+
+        Vector src(len); src.Randomize();
+        Vector d1(len), d2(len);
+
+        cout << format("\nRank %d, m = %d (%d elements)\n")%r%m%len;
+        cout << "permutation      old (s)   new (s)   speedup" << endl;
+
+        std::vector<int> perm(r);
+        for(int j = 0; j < r; ++j) perm[j] = j+1;
+        Real told_tot = 0, tnew_tot = 0;
+        do {
+            Permutation P;
+            for(int j = 1; j <= r; ++j) P.from_to(j,perm[j-1]);
+            if(P.is_trivial()) continue;
+
+            cpu_time cpu;
+            for(int k = 0; k < nrep; ++k)
+                oldPermute(P,dims,r,src.Store(),d1.Store());
+            Real told = cpu.sincemark().time/nrep;
+
+            cpu.mark();
+            for(int k = 0; k < nrep; ++k)
+                permuteData(P,dims,r,src.Store(),d2.Store());
+            Real tnew = cpu.sincemark().time/nrep;
+
+            d1 -= d2;
+            if(Norm(d1) != 0) Error("permuteData result differs from old loop");
+
+            told_tot += told; tnew_tot += tnew;
+            for(int j = 0; j < r; ++j) cout << perm[j];
+            for(int j = r; j < 16; ++j) cout << " ";
+            cout << format(" %.2E  %.2E  %.1f\n")%told%tnew%(tnew > 0 ? told/tnew : 0);
+        } while(std::next_permutation(perm.begin(),perm.end()));
+
+        cout << format("Rank %d total: old %.3f s, new %.3f s\n")%r%told_tot%tnew_tot;
+        }
+
+    return 0;
+    }
@@ -0,0 +1,72 @@
+//
+// Times the products of small tensors made in building the 
+// environments of a DMRG calculation, for a spin-1/2 chain 
+// (site dimension 2, MPO dimension 5) and a Hubbard chain 
+// (site dimension 4, MPO dimension 6) at small bond dimension 
+// m. Near the ends of the chain, or for small m, every product
+// in projectOp goes through the small-tensor path of operator*=.
+// Reports the time for projecting H from the left and from the
+// right over the whole chain.
+//
+#define THIS_IS_MAIN
+#include "core.h"
+#include "hams.h"
+#include "cputime.h"
+using boost::format;
+using std::cout;
+using std::endl;
+
+template <class ModelT>
+void
+timeProjections(const std::string& name, const ModelT& model, const MPO& H, 
+                const InitState& initState, int m, int nrep)
+    {
+    const int N = model.NN();
+    MPS psi(model,initState);
+    Sweeps sweeps(Sweeps::ramp_m,2,m,m,0);
+    dmrg(psi,H,sweeps);
+    psi.position(1);
+
+    //Right environments, as dmrg builds them, then left
+    //environments on the wavefunction moved to the last site
+    std::vector<ITensor> RH(N+2), LH(N+2);
+    cpu_time cpu;
+    for(int n = 0; n < nrep; ++n)
+    for(int l = N-1; l >= 1; --l) 
+        psi.projectOp(l+1,Fromright,RH.at(l+1),H.AA(l+1),RH.at(l));
+    const Real tr = cpu.sincemark().time/nrep;
+
+    psi.position(N);
+    cpu.mark();
+    for(int n = 0; n < nrep; ++n)
+    for(int b = 1; b < N; ++b) 
+        psi.projectOp(b,Fromleft,LH.at(b),H.AA(b),LH.at(b+1));
+    const Real tl = cpu.sincemark().time/nrep;
+
+    cout << format("%-10s N = %d, m = %2d: %.3E s from right, %.3E s from left\n")
+            %name%N%m%tr%tl;
+    }
+
+int main(int argc, char* argv[])
+    {
+    const int N = (argc > 1 ? atoi(argv[1]) : 20);
+    const int nrep = (argc > 2 ? atoi(argv[2]) : 200);
+    const int ms[] = { 2, 4, 8, 16 };
+
+    SpinHalf::Model shmodel(N);
+    MPO Hsh = SpinHalf::SquareLattice::Heisenberg(shmodel,1)();
+    InitState shstate(N);
+    for(int i = 1; i <= N; ++i) shstate(i) = (i%2==1 ? shmodel.Up(i) : shmodel.Dn(i));
+
+    Hubbard::Model hubmodel(N);
+    MPO Hhub;
+    Hubbard::HubbardChain(hubmodel).getMPO(4,Hhub);
+    InitState hubstate(N);
+    for(int i = 1; i <= N; ++i) hubstate(i) = (i%2==1 ? hubmodel.UpState(i) : hubmodel.DnState(i));
+
+    for(int j = 0; j < 4; ++j)
+        timeProjections("spin-1/2",shmodel,Hsh,shstate,ms[j],nrep);
+    for(int j = 0; j < 4; ++j)
+        timeProjections("Hubbard",hubmodel,Hhub,hubstate,ms[j],nrep);
+    return 0;
+    }
@@ -0,0 +1,89 @@
+//
+// Times sums of ITensors as they appear in dmrg.h, where
+// wavefunctions A(l,s,t,r) of bond dimension m are combined
+// with Real weights: a*A + b*B - C, and the accumulation
+// psip += w*phi of LocalHamOrth::product over several
+// states phi. Compares the ITensorSum expressions with the
+// same sums done one operator+= at a time on copies, as
+// operator+ and operator- used to do.
+//
+#define THIS_IS_MAIN
+#include "core.h"
+#include "cputime.h"
+using boost::format;
+using std::cout;
+using std::endl;
+using std::vector;
+
+int main(int argc, char* argv[])
+    {
+    const int m = (argc > 1 ? atoi(argv[1]) : 100);
+    const int d = (argc > 2 ? atoi(argv[2]) : 2);
+    const int nphi = (argc > 3 ? atoi(argv[3]) : 4);
+    const int nrep = (argc > 4 ? atoi(argv[4]) : 100);
+
+    Index l("l",m), s("s",d), t("t",d), r("r",m);
+    ITensor A(l,s,t,r), B(l,s,t,r), C(l,s,t,r);
+    A.Randomize(); B.Randomize(); C.Randomize();
+    const Real a = 0.3, b = -1.7;
+
+    cpu_time cpu;
+    ITensor R1;
+    for(int n = 0; n < nrep; ++n)
+        {
+        ITensor res(A); res *= a;
+        ITensor bB(B); bB *= b;
+        res += bB;
+        ITensor res2(res);
+        res2 -= C;
+        R1 = res2;
+        }
+    Real tcopy = cpu.sincemark().time/nrep;
+
+    cpu.mark();
+    ITensor R2;
+    for(int n = 0; n < nrep; ++n)
+        R2 = a*A + b*B - C;
+    Real tsum = cpu.sincemark().time/nrep;
+
+    ITensor diff = R1; diff -= R2;
+    cout << format("a*A + b*B - C, A(%d,%d,%d,%d), %d repetitions\n")%m%d%d%m%nrep;
+    cout << format("  copies:      %.3E s\n")%tcopy;
+    cout << format("  ITensorSum:  %.3E s (%.2f times faster), |diff| = %.2E\n")
+            %tsum%(tcopy/tsum)%diff.norm();
+
+    vector<ITensor> phi(nphi);
+    vector<Real> w(nphi);
+    for(int k = 0; k < nphi; ++k) 
+        { 
+        phi[k] = ITensor(l,s,t,r); 
+        phi[k].Randomize(); 
+        w[k] = 0.1*(k+1);
+        }
+
+    cpu.mark();
+    ITensor P1;
+    for(int n = 0; n < nrep; ++n)
+        {
+        P1 = A;
+        for(int k = 0; k < nphi; ++k) P1 += w[k] * phi[k];
+        }
+    Real tacc = cpu.sincemark().time/nrep;
+
+    cpu.mark();
+    ITensor P2;
+    for(int n = 0; n < nrep; ++n)
+        {
+        ITensorSum S(A);
+        for(int k = 0; k < nphi; ++k) S += w[k] * phi[k];
+        P2 = S;
+        }
+    Real tfused = cpu.sincemark().time/nrep;
+
+    diff = P1; diff -= P2;
+    cout << format("psip += w*phi over %d states\n")%nphi;
+    cout << format("  operator+=:  %.3E s\n")%tacc;
+    cout << format("  ITensorSum:  %.3E s (%.2f times faster), |diff| = %.2E\n")
+            %tfused%(tacc/tfused)%diff.norm();
+    return 0;
+    }
@@ -0,0 +1,109 @@
+//
+// Compares the truncation modes of SVDWorker on the spin-1
+// Heisenberg chain of sample/dmrg.cc: diagonalizing the
+// density matrix of each bond wavefunction (the default)
+// against a direct SVD of it (useSVD) and against partial 
+// diagonalization of it (partialDiag). Runs the sample DMRG
+// in each mode, then decomposes the bonds of the converged
+// wavefunction at a small cutoff, reporting time, the
+// truncation error returned and the actual error
+// |phi - A*B|^2/|phi|^2. Finally the bonds are truncated to
+// maxm/4 states, where partialDiag applies.
+//
+#define THIS_IS_MAIN
+#include "core.h"
+#include "hams.h"
+#include "cputime.h"
+using boost::format;
+using std::cout;
+using std::endl;
+
+template <class MPSType, class MPOType>
+void
+compare(const std::string& name, int N, int maxm, Real cutoff, Real bondcut)
+    {
+    typedef typename MPSType::TensorT Tensor;
+
+    SpinOne::Model model(N);
+    MPOType H = SpinOne::Heisenberg(model)();
+    InitState initState(N);
+    for(int i = 1; i <= N; ++i) initState(i) = (i%2==1 ? model.Up(i) : model.Dn(i));
+
+    cout << format("\n%s, N = %d, maxm = %d, cutoff = %.0E\n")%name%N%maxm%cutoff;
+    MPSType psi;
+    const char* modename[] = { "denmat", "svd", "partial" };
+    for(int mode = 0; mode <= 2; ++mode)
+        {
+        MPSType psi1(model,initState);
+        psi1.useSVD(mode == 1);
+        psi1.partialDiag(mode == 2);
+        Sweeps sweeps(Sweeps::ramp_m,5,1,maxm,cutoff);
+        cpu_time cpu;
+        Real En = dmrg(psi1,H,sweeps);
+        Real t = cpu.sincemark().time;
+        cout << format("  dmrg %-7s: %.3f s, energy %.10f, max truncerr %.2E\n")
+                %modename[mode]%t%En%psi1.svd().maxTruncerr();
+        if(mode == 0) psi = psi1;
+        }
+
+    //Decompose every bond of psi in both modes
+    psi.position(1);
+    Real time[2] = { 0, 0 }, maxerr[2] = { 0, 0 }, maxest[2] = { 0, 0 };
+    for(int b = 1; b < N; ++b)
+        {
+        Tensor phi = psi.bondTensor(b);
+        for(int mode = 0; mode <= 1; ++mode)
+            {
+            SVDWorker svd(N,bondcut,1,MAX_M,false,LogNumber(1));
+            svd.useSVD(mode == 1);
+            Tensor A = psi.AA(b), B = psi.AA(b+1);
+            cpu_time cpu;
+            svd(b,phi,A,B,Fromleft);
+            time[mode] += cpu.sincemark().time;
+            Tensor diff = A*B;
+            diff *= -1;
+            diff += phi;
+            Real err = sqr(diff.norm()/phi.norm());
+            maxerr[mode] = max(maxerr[mode],err);
+            maxest[mode] = max(maxest[mode],svd.truncerr(b));
+            }
+        psi.doSVD(b,phi,Fromleft);
+        }
+    for(int mode = 0; mode <= 1; ++mode)
+        cout << format("  bonds %-6s: %.3f s, truncerr %.2E, actual error %.2E (cutoff %.0E)\n")
+                %modename[mode]%time[mode]%maxest[mode]%maxerr[mode]%bondcut;
+
+    //Truncate every bond to maxm/4 states
+    psi.position(1);
+    Real ptime[2] = { 0, 0 }, perr[2] = { 0, 0 };
+    for(int b = 1; b < N; ++b)
+        {
+        Tensor phi = psi.bondTensor(b);
+        for(int mode = 0; mode <= 1; ++mode)
+            {
+            SVDWorker svd(N,bondcut,1,maxm/4,false,LogNumber(1));
+            svd.partialDiag(mode == 1);
+            Tensor A = psi.AA(b), B = psi.AA(b+1);
+            cpu_time cpu;
+            svd(b,phi,A,B,Fromleft);
+            ptime[mode] += cpu.sincemark().time;
+            perr[mode] = max(perr[mode],svd.truncerr(b));
+            }
+        psi.doSVD(b,phi,Fromleft);
+        }
+    for(int mode = 0; mode <= 1; ++mode)
+        cout << format("  m = %d %-7s: %.3f s, max truncerr %.6E\n")
+                %(maxm/4)%modename[2*mode]%ptime[mode]%perr[mode];
+    }
+
+int main(int argc, char* argv[])
+    {
+    const int N = (argc > 1 ? atoi(argv[1]) : 100);
+    const int maxm = (argc > 2 ? atoi(argv[2]) : 100);
+    const Real cutoff = (argc > 3 ? atof(argv[3]) : 1E-5);
+    const Real bondcut = (argc > 4 ? atof(argv[4]) : 1E-14);
+
+    compare<MPS,MPO>("MPS",N,maxm,cutoff,bondcut);
+    compare<IQMPS,IQMPO>("IQMPS",N,maxm,cutoff,bondcut);
+    return 0;
+    }
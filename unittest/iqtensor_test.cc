@@ -1,5 +1,6 @@
 #include "test.h"
 #include "iqtensor.h"
+#include "contract.h"
 #include <boost/test/unit_test.hpp>
 
 struct IQTensorDefaults
@@ -141,4 +142,168 @@ BOOST_AUTO_TEST_CASE(ITensorConversion)
 
     }
 
+BOOST_AUTO_TEST_CASE(BlockTaskSize)
+    {
+    //Result must not depend on how block products are batched
+    IQTensor Ac = primeind(A,L2);
+    Ac.conj();
+
+    const Real oldsize = Globals::minBlockTaskSize();
+    Globals::minBlockTaskSize() = 1;
+    ITensor fine = A * Ac;
+    Globals::minBlockTaskSize() = 1E20;
+    ITensor coarse = A * Ac;
+    Globals::minBlockTaskSize() = oldsize;
+
+    CHECK_EQUAL(fine.vec_size(),coarse.vec_size());
+    Vector vf(fine.vec_size()), vc(coarse.vec_size());
+    fine.assignToVec(vf);
+    coarse.assignToVec(vc);
+    for(int j = 1; j <= vf.Length(); ++j)
+        CHECK_EQUAL(vf(j),vc(j));
+
+    ITensor dense = ITensor(A) * ITensor(Ac);
+    for(int j1 = 1; j1 <= L2.m(); ++j1)
+    for(int j2 = 1; j2 <= L2.m(); ++j2)
+        {
+        CHECK_CLOSE(fine(Index(L2)(j1),primed(Index(L2))(j2)),
+                    dense(Index(L2)(j1),primed(Index(L2))(j2)),1E-5);
+        }
+    }
+
+BOOST_AUTO_TEST_CASE(BlockLookup)
+    {
+    CHECK_EQUAL(L2.sector(l20),2);
+    CHECK_EQUAL(L2.sector(primed(l20)),-1);
+    CHECK_EQUAL(primed(L2).sector(primed(l20)),2);
+    CHECK_EQUAL(L2.sector(l10),-1);
+
+    //Blocks are found whatever the order of their indices
+    IQTensor T(L1,S1,L2);
+    ITensor b1(l10,s1u,l2d), b2(l2d,l10,s1u);
+    b1.Randomize(); b2.Randomize();
+    T += b1;
+    T += b2;
+    CHECK_EQUAL(T.iten_size(),1);
+    CHECK_CLOSE(T(L1(3),S1(1),L2(7)),
+                b1(l10(1),s1u(1),l2d(1))+b2(l10(1),s1u(1),l2d(1)),1E-10);
+
+    //Element access creates the missing block
+    T(L1(1),S1(2),L2(1)) = 2;
+    CHECK_EQUAL(T.iten_size(),2);
+    CHECK_CLOSE(T(L1(1),S1(2),L2(1)),2,1E-10);
+    }
+
+BOOST_AUTO_TEST_CASE(BlockDot)
+    {
+    //Same IQIndex's, blocks listed in another order
+    //and with their indices permuted
+    IQTensor C(S2,L2,L1,S1);
+    for(IQTensor::const_iten_it it = A.const_iten_end(); it != A.const_iten_begin(); )
+        {
+        --it;
+        ITensor T(it->index(4),it->index(2),it->index(1),it->index(3));
+        T.Randomize();
+        C += T;
+        }
+    C *= -2;
+
+    Real d = Dot(A,C);
+    Real dd = ReSingVal(IQTensor::Sing()*conj(A)*C);
+    CHECK_CLOSE(d,dd,1E-10);
+    CHECK_CLOSE(Dot(A,A),A.norm()*A.norm(),1E-10);
+    }
+
+BOOST_AUTO_TEST_CASE(ComplexConjDot)
+    {
+    IQTensor Ai(A), C(A);
+    Ai.Randomize(); C.Randomize();
+    IQTensor Z = A*IQTensor::Complex_1() + Ai*IQTensor::Complex_i();
+    IQTensor W = C*IQTensor::Complex_1() + A*IQTensor::Complex_i();
+
+    //In-place conj against the definition z* = re - i*im
+    IQTensor cZ = conj(Z);
+    IQTensor cZr, cZi;
+    cZ.SplitReIm(cZr,cZi);
+    CHECK(cZ.index(1).dir() == A.index(1).dir()*Switch);
+    cZi += Ai;
+    CHECK(fabs(cZi.norm()) < 1E-10);
+    cZr *= -1; cZr += A;
+    CHECK(fabs(cZr.norm()) < 1E-10);
+
+    Real re, im, sre, sim;
+    Dot(Z,W,re,im);
+    IQTensor res(IQTensor::Sing()*conj(Z)*W);
+    res.GetSingComplex(sre,sim);
+    CHECK_CLOSE(re,sre,1E-10);
+    CHECK_CLOSE(im,sim,1E-10);
+    CHECK_CLOSE(Dot(Z,W),sre,1E-10);
+
+    Dot(Z,W,re,im,false);
+    Dot(ITensor(Z),ITensor(W),sre,sim,false);
+    CHECK_CLOSE(re,sre,1E-10);
+    CHECK_CLOSE(im,sim,1E-10);
+    }
+
+BOOST_AUTO_TEST_CASE(ContractOrder)
+{
+    //phi*A*B left to right would first make a rank 6 tensor
+    IQTensor Bc = conj(B), phic = conj(phi);
+    IQTensor R1 = A * Bc; R1 *= phic;
+    IQTensor R2 = contract(phic,A,Bc);
+    CHECK_EQUAL(R2.r(),R1.r());
+
+    ITensor diff = R2; diff *= -1; diff += ITensor(R1);
+    CHECK(fabs(diff.norm()) < 1E-12*fabs(R1.norm()));
+}
+
+BOOST_AUTO_TEST_CASE(RelabelSharesData)
+{
+    //Priming and conj of real tensors only change indices
+    const int objs = StoreLink::NumObjects();
+    IQTensor P = primed(A);
+    IQTensor C = conj(A);
+    IQTensor Q = primeind(A,L1);
+    P.mapprime(1,2);
+    P.noprime();
+    CHECK_EQUAL(StoreLink::NumObjects(),objs);
+
+    //Blocks are still found by sector after relabeling
+    IQTensor S(A);
+    S += P;
+    CHECK_EQUAL(S.iten_size(),A.iten_size());
+    CHECK_CLOSE(S.norm(),2*A.norm(),1E-10);
+
+    IQTensor R = primed(A);
+    R += primed(A);
+    CHECK_EQUAL(R.iten_size(),A.iten_size());
+    CHECK_CLOSE(R.norm(),2*A.norm(),1E-10);
+    CHECK_CLOSE(Dot(conj(Q),Q),Dot(conj(A),A),1E-10);
+}
+
+BOOST_AUTO_TEST_CASE(SumTerms)
+{
+    //Terms with different blocks and block Index orders
+    IQTensor P = A*2.;
+    IQTensor Q = conj(primed(A));
+    Q.conj();
+    Q.noprime();
+    std::vector<IQTensor> terms;
+    terms.push_back(A);
+    terms.push_back(P);
+    terms.push_back(IQTensor());
+    terms.push_back(Q);
+
+    IQTensor S;
+    sum(terms,S);
+    IQTensor S1(A); S1 += P; S1 += Q;
+    CHECK_EQUAL(S.iten_size(),S1.iten_size());
+    IQTensor diff(S); diff *= -1; diff += S1;
+    CHECK(diff.norm() < 1E-12*S1.norm());
+    CHECK_CLOSE(S.norm(),4*A.norm(),1E-10);
+
+    sum(terms,terms[0]);
+    CHECK_CLOSE(terms[0].norm(),4*A.norm(),1E-10);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
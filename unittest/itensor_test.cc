@@ -1,5 +1,7 @@
 #include "test.h"
 #include "itensor.h"
+#include "eigensolver.h"
+#include "contract.h"
 #include <boost/test/unit_test.hpp>
 
 struct ITensorDefaults
@@ -500,6 +502,36 @@ BOOST_AUTO_TEST_CASE(reshape)
 
 }
 
+BOOST_AUTO_TEST_CASE(reshapeRank4)
+{
+    ITensor T(b2,b3,b4,b5);
+    T.Randomize();
+
+    Permutation P;
+    P.from_to(1,3);
+    P.from_to(2,1);
+    P.from_to(3,4);
+    P.from_to(4,2);
+
+    ITensor R(T);
+    T.reshapeTo(P,R);
+
+    CHECK_EQUAL(R.index(1),b3);
+    CHECK_EQUAL(R.index(2),b5);
+    CHECK_EQUAL(R.index(3),b2);
+    CHECK_EQUAL(R.index(4),b4);
+
+    for(int j2 = 1; j2 <= 2; ++j2)
+    for(int j3 = 1; j3 <= 3; ++j3)
+    for(int j4 = 1; j4 <= 4; ++j4)
+    for(int j5 = 1; j5 <= 5; ++j5)
+    {
+        CHECK_CLOSE(R(b2(j2),b3(j3),b4(j4),b5(j5)),
+                    T(b2(j2),b3(j3),b4(j4),b5(j5)),1E-10);
+    }
+
+}
+
 BOOST_AUTO_TEST_CASE(findindex)
 {
     ITensor T(mixed_inds);
@@ -688,6 +720,132 @@ BOOST_AUTO_TEST_CASE(ContractingProduct)
     CHECK(!Hpsi.hasindex(a2));
 }
 
+BOOST_AUTO_TEST_CASE(BatchedProduct)
+{
+    //Contracted indices in the middle of a large tensor
+    //are handled by a batch of matrix multiplications
+    Index a("a",64), s("s",8), w("w",8), b("b",128), c("c",16), d("d",20);
+    ITensor L(a,s,w,b), R(s,w,c), R2(c,s,w,d);
+    L.Randomize(); R.Randomize(); R2.Randomize();
+
+    ITensor P = L * R;
+    CHECK_EQUAL(P.r(),3);
+    for(int i = 1; i <= a.m(); i += 7)
+    for(int k = 1; k <= b.m(); k += 13)
+    for(int j = 1; j <= c.m(); j += 5)
+    {
+        Real val = 0;
+        for(int is = 1; is <= s.m(); ++is)
+        for(int iw = 1; iw <= w.m(); ++iw)
+            { val += L(a(i),s(is),w(iw),b(k))*R(s(is),w(iw),c(j)); }
+        CHECK_CLOSE(P(a(i),b(k),c(j)),val,1E-10);
+    }
+
+    ITensor P2 = L * R2;
+    CHECK_EQUAL(P2.r(),4);
+    for(int i = 1; i <= a.m(); i += 11)
+    for(int k = 1; k <= b.m(); k += 17)
+    for(int j = 1; j <= c.m(); j += 5)
+    for(int l = 1; l <= d.m(); l += 7)
+    {
+        Real val = 0;
+        for(int is = 1; is <= s.m(); ++is)
+        for(int iw = 1; iw <= w.m(); ++iw)
+            { val += L(a(i),s(is),w(iw),b(k))*R2(c(j),s(is),w(iw),d(l)); }
+        CHECK_CLOSE(P2(a(i),b(k),c(j),d(l)),val,1E-10);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(SmallProduct)
+{
+    //Products of small tensors: the contracted indices form one
+    //run in both tensors (A*C, A*D), two runs (A*B, l and r being
+    //in another order in B) or runs too long for the fixed-size
+    //kernels (K1*K2, X*Y)
+    Index l("l",7), s("s",2), t("t",3), r("r",5), k("k",40), q("q",35);
+    ITensor A(l,s,r), B(r,t,l), C(r,t), D(s,r,t), K1(l,k), K2(k,s,t);
+    A.Randomize(); B.Randomize(); C.Randomize(); D.Randomize(); 
+    K1.Randomize(); K2.Randomize();
+
+    ITensor P1 = A * C, P2 = A * D, P3 = A * B, P4 = K1 * K2;
+    CHECK_EQUAL(P1.r(),3);
+    CHECK_EQUAL(P2.r(),2);
+    CHECK_EQUAL(P3.r(),2);
+    CHECK_EQUAL(P4.r(),3);
+    for(int i = 1; i <= l.m(); ++i)
+    for(int it = 1; it <= t.m(); ++it)
+    {
+        for(int is = 1; is <= s.m(); ++is)
+        {
+            Real val = 0;
+            for(int ir = 1; ir <= r.m(); ++ir) 
+                { val += A(l(i),s(is),r(ir))*C(r(ir),t(it)); }
+            CHECK_CLOSE(P1(l(i),s(is),t(it)),val,1E-10);
+
+            val = 0;
+            for(int ik = 1; ik <= k.m(); ++ik) 
+                { val += K1(l(i),k(ik))*K2(k(ik),s(is),t(it)); }
+            CHECK_CLOSE(P4(l(i),s(is),t(it)),val,1E-10);
+        }
+
+        Real v2 = 0;
+        for(int is = 1; is <= s.m(); ++is)
+        for(int ir = 1; ir <= r.m(); ++ir) 
+            { v2 += A(l(i),s(is),r(ir))*D(s(is),r(ir),t(it)); }
+        CHECK_CLOSE(P2(l(i),t(it)),v2,1E-10);
+    }
+    for(int is = 1; is <= s.m(); ++is)
+    for(int it = 1; it <= t.m(); ++it)
+    {
+        Real val = 0;
+        for(int i = 1; i <= l.m(); ++i)
+        for(int ir = 1; ir <= r.m(); ++ir) 
+            { val += A(l(i),s(is),r(ir))*B(r(ir),t(it),l(i)); }
+        CHECK_CLOSE(P3(s(is),t(it)),val,1E-10);
+    }
+
+    ITensor X(k,t,q), Y(q,k);
+    X.Randomize(); Y.Randomize();
+    ITensor P5 = X * Y;
+    CHECK_EQUAL(P5.r(),1);
+    for(int it = 1; it <= t.m(); ++it)
+    {
+        Real val = 0;
+        for(int ik = 1; ik <= k.m(); ++ik)
+        for(int iq = 1; iq <= q.m(); ++iq) 
+            { val += X(k(ik),t(it),q(iq))*Y(q(iq),k(ik)); }
+        CHECK_CLOSE(P5(t(it)),val,1E-10);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(PlanCache)
+{
+    ITensor L(b2,b3,b4), R(b4,b5,b2);
+    L.Randomize(); R.Randomize();
+
+    ITensor::clearPlanCache();
+
+    ITensor P1 = L * R;
+    CHECK_EQUAL(ITensor::planCacheMisses(),1);
+    CHECK_EQUAL(ITensor::planCacheHits(),0);
+
+    //Same index structure, different data
+    ITensor L2(L), R2(R);
+    L2.Randomize(); R2.Randomize();
+    ITensor P2 = L2 * R2;
+    CHECK_EQUAL(ITensor::planCacheMisses(),1);
+    CHECK_EQUAL(ITensor::planCacheHits(),1);
+
+    //Result must not depend on whether the plan was cached
+    ITensor P3 = L * R;
+    P3 -= P1;
+    CHECK_CLOSE(P3.norm(),0,1E-10);
+
+    //Different index order is a different plan
+    ITensor P4 = R * L;
+    CHECK_EQUAL(ITensor::planCacheMisses(),2);
+}
+
 BOOST_AUTO_TEST_CASE(NonContractingProduct)
 {
     ITensor L(b2,a1,b3,b4), R(a1,b3,a2,b5,b4);
@@ -1000,4 +1158,333 @@ BOOST_AUTO_TEST_CASE(Website)
 
 }
 
+BOOST_AUTO_TEST_CASE(ComplexProduct)
+{
+    const Index& ri = Index::IndReIm();
+
+    //Small tensors use the ReImPrimer path, 
+    //larger ones the three real products
+    for(int n = 2; n <= 10; n += 8)
+    {
+    Index a("a",n), b("b",8), c("c",n), d("d",n);
+    ITensor Ar(a,b,c), Ai(a,b,c), Br(c,d,b), Bi(c,d,b);
+    Ar.Randomize(); Ai.Randomize(); Br.Randomize(); Bi.Randomize();
+    Ai *= 3;
+    ITensor A = Ar*ITensor::Complex_1() + Ai*ITensor::Complex_i();
+    ITensor B = Br*ITensor::Complex_1() + Bi*ITensor::Complex_i();
+
+    ITensor P = A * B;
+    CHECK(P.is_complex());
+    CHECK_EQUAL(P.r(),3);
+    ITensor Er = Ar*Br - Ai*Bi, Ei = Ar*Bi + Ai*Br;
+    for(int i = 1; i <= n; ++i)
+    for(int l = 1; l <= n; ++l)
+        {
+        CHECK_CLOSE(P(a(i),d(l),ri(1)),Er(a(i),d(l)),1E-8);
+        CHECK_CLOSE(P(a(i),d(l),ri(2)),Ei(a(i),d(l)),1E-8);
+        }
+    }
+
+    //ReIm between the other indices of the storage
+    Index a("a",3), b("b",4);
+    ITensor T(a,ri,b), U(b,a,ri);
+    T.Randomize(); U.Randomize();
+    T *= -2;
+
+    ITensor Tr, Ti;
+    T.SplitReIm(Tr,Ti);
+    ITensor cT = conj(T);
+    ITensor pT = T / ITensor::ConjTensor();
+    Real re = 0, im = 0, nre = 0, nim = 0;
+    for(int i = 1; i <= a.m(); ++i)
+    for(int j = 1; j <= b.m(); ++j)
+        {
+        const Real tr = T(a(i),ri(1),b(j)), ti = T(a(i),ri(2),b(j));
+        const Real ur = U(a(i),ri(1),b(j)), ui = U(a(i),ri(2),b(j));
+        CHECK_CLOSE(Tr(a(i),b(j)),tr,1E-10);
+        CHECK_CLOSE(Ti(a(i),b(j)),ti,1E-10);
+        CHECK_CLOSE(cT(a(i),ri(1),b(j)),pT(a(i),ri(1),b(j)),1E-10);
+        CHECK_CLOSE(cT(a(i),ri(2),b(j)),pT(a(i),ri(2),b(j)),1E-10);
+        re += tr*ur + ti*ui; im += tr*ui - ti*ur;
+        nre += tr*ur - ti*ui; nim += tr*ui + ti*ur;
+        }
+
+    Real dre, dim;
+    Dot(T,U,dre,dim);
+    CHECK_CLOSE(dre,re,1E-8);
+    CHECK_CLOSE(dim,im,1E-8);
+    CHECK_CLOSE(Dot(T,U),re,1E-8);
+    Dot(T,U,dre,dim,false);
+    CHECK_CLOSE(dre,nre,1E-8);
+    CHECK_CLOSE(dim,nim,1E-8);
+}
+
+//Hermitian operator acting on ITensors, for davidson
+struct TensorOp
+    {
+    ITensor H;
+    void product(const ITensor& phi, ITensor& Hphi) const
+        { Hphi = H * phi; Hphi.mapprime(1,0); }
+    };
+
+//The generator of VectorRef::Randomize, with the seed in idum
+static Real
+seededRan(int& idum)
+    {
+    idum = (idum*8121+28411)%134456;
+    return Real(idum)/134456;
+    }
+
+BOOST_AUTO_TEST_CASE(TensorDavidson)
+{
+    //Seeded, so that the number of restarts below is reproducible
+    //(Randomize seeds itself from an address)
+    int seed = 4711;
+    const int n = b4.m()*b5.m();
+    Matrix M(n,n);
+    for(int i = 1; i <= n; ++i)
+    for(int j = 1; j <= n; ++j)
+        M(i,j) = seededRan(seed);
+    Matrix MT = M.t();
+    M += MT;
+
+    TensorOp A;
+    A.H = ITensor(b4,b5,primed(b4),primed(b5));
+    for(int i = 1; i <= b4.m(); ++i)
+    for(int j = 1; j <= b5.m(); ++j)
+    for(int k = 1; k <= b4.m(); ++k)
+    for(int l = 1; l <= b5.m(); ++l)
+        A.H(b4(i),b5(j),primed(b4)(k),primed(b5)(l)) = M(i+b4.m()*(j-1),k+b4.m()*(l-1));
+
+    Vector evals;
+    Matrix evecs;
+    EigenValues(M,evals,evecs);
+
+    //Start with a scale factor that is negative, as after phi *= -1
+    ITensor phi(b5,b4);
+    Vector start(n);
+    for(int i = 1; i <= n; ++i) start(i) = seededRan(seed)-0.5;
+    phi.assignFromVec(start);
+    phi *= -3;
+    Real lambda = davidson(A,phi,n,1E-10);
+
+    CHECK_CLOSE(lambda,evals(1),1E-8);
+    CHECK_CLOSE(fabs(phi.norm()),1,1E-8);
+
+    ITensor r;
+    A.product(phi,r);
+    r -= lambda*phi;
+    CHECK(fabs(r.norm()) < 1E-6);
+
+    //Restarting with a small basis still converges; like David
+    //each call may stop once the residual is below 5E-2, so
+    //warm-start repeatedly as successive sweeps would. Three
+    //vectors per restart converge slowly, at a rate set by the
+    //gap of the two lowest eigenvalues (0.85 here) over the
+    //width of the spectrum (23.7): this seed takes 44 restarts
+    //to a residual of 1E-8, and max_restarts leaves room for
+    //rounding differences between builds
+    const int max_restarts = 60;
+    for(int i = 1; i <= n; ++i) start(i) = seededRan(seed)-0.5;
+    phi.assignFromVec(start);
+    Real rlambda = 0, rnorm = 1;
+    int nrestart = 0;
+    while(rnorm > 1E-8 && nrestart < max_restarts)
+        {
+        rlambda = davidson(A,phi,3,1E-10);
+        A.product(phi,r);
+        r -= rlambda*phi;
+        rnorm = fabs(r.norm());
+        ++nrestart;
+        }
+    CHECK(rnorm <= 1E-8);
+    CHECK_CLOSE(rlambda,evals(1),1E-8);
+}
+
+BOOST_AUTO_TEST_CASE(ContractOrder)
+{
+    //Environment of a bond, as in psiHphi
+    Index a("a",20), b("b",20), s("s",3,Site), w("w",5), v("v",5);
+    ITensor L(a,primed(a),w), phi(a,s,b), H(w,s,primed(s),v), psi(a,s,b);
+    L.Randomize(); phi.Randomize(); H.Randomize(); psi.Randomize();
+    ITensor psic = conj(primed(psi));
+
+    ITensor R1 = L * phi; R1 *= H; R1 *= psic;
+    ITensor R2 = contract(L,phi,H,psic);
+    ITensor diff = R2; diff *= -1; diff += R1;
+    CHECK(fabs(diff.norm()) < 1E-12*fabs(R1.norm()));
+
+    //Left to right, A*B would be an outer product
+    ITensor A(a,b), B(primed(a),primed(b)), C(b,primed(a));
+    A.Randomize(); B.Randomize(); C.Randomize();
+    TensorNetwork<ITensor> net;
+    net.add(A).add(B).add(C);
+    CHECK_CLOSE(net.cost(),2*20.*20*20,1E-10);
+    ITensor R3 = A * C; R3 *= B;
+    diff = net.result(); diff *= -1; diff += R3;
+    CHECK(fabs(diff.norm()) < 1E-12*fabs(R3.norm()));
+
+    //Temporaries added in earlier statements are kept alive
+    TensorNetwork<ITensor> tnet;
+    tnet.add(A * C);
+    tnet.add(ITensor(B));
+    diff = tnet.result(); diff *= -1; diff += R3;
+    CHECK(fabs(diff.norm()) < 1E-12*fabs(R3.norm()));
+
+    //More operands than the exhaustive search handles
+    std::vector<Index> l(13);
+    for(int j = 0; j < 13; ++j) l[j] = Index(nameint("l",j),3);
+    std::vector<ITensor> chain;
+    for(int j = 0; j < 12; ++j) 
+        { 
+        chain.push_back(ITensor(l[j],l[j+1])); 
+        chain.back().Randomize(); 
+        }
+    ITensor R4 = chain[0];
+    for(int j = 1; j < 12; ++j) R4 *= chain[j];
+    diff = contract(chain); diff *= -1; diff += R4;
+    CHECK(fabs(diff.norm()) < 1E-12*fabs(R4.norm()));
+
+    //Complex operands
+    ITensor Lc = L * ITensor::Complex_1() + L * ITensor::Complex_i();
+    ITensor R5 = Lc * phi; R5 *= H; R5 *= psic;
+    diff = contract(Lc,phi,H,psic); diff *= -1; diff += R5;
+    CHECK(fabs(diff.norm()) < 1E-12*fabs(R5.norm()));
+}
+
+BOOST_AUTO_TEST_CASE(SumExpression)
+{
+    Index a("a",3), b("b",4), c("c",2);
+    ITensor A(a,b,c), B(a,b,c), C(a,b,c), P(c,b,a);
+    A.Randomize(); B.Randomize(); C.Randomize(); P.Randomize();
+    B *= 1E-3;
+
+    //Fused, with different scales
+    ITensor R = 2*A + B/3 - C;
+    ITensor R1 = 2*A; R1 += B/3; R1 -= C;
+    ITensor diff = R; diff -= R1;
+    CHECK(diff.norm() < 1E-12*R1.norm());
+    CHECK_CLOSE(R(a(2),b(3),c(1)),2*A(a(2),b(3),c(1))+B(a(2),b(3),c(1))/3-C(a(2),b(3),c(1)),1E-10);
+
+    //Operands unchanged and not sharing storage with R
+    R *= 0;
+    CHECK(A.norm() > 0);
+    CHECK_CLOSE(R1(a(1),b(1),c(1)),2*A(a(1),b(1),c(1))+B(a(1),b(1),c(1))/3-C(a(1),b(1),c(1)),1E-10);
+
+    //Term with another Index order
+    R = A - 0.5*(P + B);
+    R1 = P; R1 += B; R1 *= -0.5; R1 += A;
+    diff = R; diff -= R1;
+    CHECK(diff.norm() < 1E-12*R1.norm());
+
+    //Sums cancelling, scaled and accumulated
+    R = A - A;
+    CHECK(R.norm() < 1E-12);
+    R = C;
+    R += 3*(A - B);
+    R1 = 3*A; R1 -= 3*B; R1 += C;
+    diff = R; diff -= R1;
+    CHECK(diff.norm() < 1E-12*R1.norm());
+
+    //Complex terms and contraction of a sum
+    ITensor Z = A*ITensor::Complex_1() + B*ITensor::Complex_i();
+    CHECK(Z.is_complex());
+    ITensor Zr, Zi; Z.SplitReIm(Zr,Zi);
+    diff = Zr; diff -= A;
+    CHECK(diff.norm() < 1E-12*A.norm());
+    diff = Zi; diff -= B;
+    CHECK(diff.norm() < 1E-12*B.norm());
+
+    ITensor D(a); 
+    D.Randomize(); 
+    ITensor S = (A + C) * D, S1 = A; 
+    S1 += C; S1 *= D;
+    diff = S; diff -= S1;
+    CHECK(diff.norm() < 1E-12*S1.norm());
+}
+
+BOOST_AUTO_TEST_CASE(FusedAccumulate)
+{
+    Index a("a",3), b("b",4), c("c",2);
+    ITensor A(a,b,c), B(a,b,c), P(c,a,b), Q(b,c,a);
+    A.Randomize(); B.Randomize(); P.Randomize(); Q.Randomize();
+    A *= 1E-3; 
+    B *= 1E4; 
+    P *= -2E5;
+
+    //Smaller scale on the left, same and permuted order
+    ITensor R1 = A; R1 += B;
+    ITensor R2 = A; R2 += P;
+    ITensor R3 = P; R3 += A;
+    ITensor R4 = A; R4 += Q;
+    for(int i = 1; i <= a.m(); ++i)
+    for(int j = 1; j <= b.m(); ++j)
+    for(int k = 1; k <= c.m(); ++k)
+        {
+        const Real x = A(a(i),b(j),c(k));
+        CHECK_CLOSE(R1(a(i),b(j),c(k)),x+B(a(i),b(j),c(k)),1E-10);
+        CHECK_CLOSE(R2(a(i),b(j),c(k)),x+P(a(i),b(j),c(k)),1E-10);
+        CHECK_CLOSE(R3(a(i),b(j),c(k)),x+P(a(i),b(j),c(k)),1E-10);
+        CHECK_CLOSE(R4(a(i),b(j),c(k)),x+Q(a(i),b(j),c(k)),1E-10);
+        }
+
+    //sum of N terms, also into one of them
+    std::vector<ITensor> terms;
+    terms.push_back(A);
+    terms.push_back(P);
+    terms.push_back(B);
+    terms.push_back(-1*A);
+    ITensor S;
+    sum(terms,S);
+    ITensor S1 = P; S1 += B;
+    ITensor diff = S; diff -= S1;
+    CHECK(diff.norm() < 1E-12*S1.norm());
+    sum(terms,terms[1]);
+    diff = terms[1]; diff -= S1;
+    CHECK(diff.norm() < 1E-12*S1.norm());
+}
+
+BOOST_AUTO_TEST_CASE(SwapHandover)
+{
+    Index a("a",3), b("b",2);
+    ITensor A(a,b), B(b);
+    A.Randomize(); B.Randomize();
+    A *= 2;
+    const Real a12 = A(a(1),b(2)), b2 = B(b(2));
+
+    swap(A,B);
+    CHECK_EQUAL(A.r(),1);
+    CHECK_EQUAL(B.r(),2);
+    CHECK(B.hasindex(a));
+    CHECK_CLOSE(B(a(1),b(2)),a12,1E-10);
+    CHECK_CLOSE(A(b(2)),b2,1E-10);
+    swap(A,B);
+
+    //By-value arguments are handed back, their source is unchanged
+    ITensor P = primed(A);
+    CHECK(P.hasindex(primed(a)));
+    CHECK(A.hasindex(a));
+    CHECK_CLOSE(P(primed(a)(1),primed(b)(2)),a12,1E-10);
+
+    ITensor S = 3 * A;
+    CHECK_CLOSE(S(a(1),b(2)),3*a12,1E-10);
+    CHECK_CLOSE(A(a(1),b(2)),a12,1E-10);
+
+    ITensor Z = A*ITensor::Complex_1() + A*ITensor::Complex_i();
+    ITensor Zc = conj(Z), Zr, Zi;
+    Zc.SplitReIm(Zr,Zi);
+    CHECK_CLOSE(Zi(a(1),b(2)),-a12,1E-10);
+    Z.SplitReIm(Zr,Zi);
+    CHECK_CLOSE(Zi(a(1),b(2)),a12,1E-10);
+
+    ITensor D = deprimed(primed(A));
+    CHECK(D.hasindex(a));
+    CHECK_CLOSE(D(a(1),b(2)),a12,1E-10);
+
+    //handover leaves its argument empty
+    ITensor H = handover(P);
+    CHECK(P.is_null());
+    CHECK_CLOSE(H(primed(a)(1),primed(b)(2)),a12,1E-10);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
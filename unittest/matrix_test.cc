@@ -1,5 +1,7 @@
 #include "test.h"
 #include "matrix.h"
+#include "backend.h"
+#include "expapply.h"
 #include <boost/test/unit_test.hpp>
 
 struct MatrixDefaults
@@ -7,6 +9,23 @@ struct MatrixDefaults
     MatrixDefaults() {} 
 };
 
+//BigMatrix made from a dense symmetric Matrix, counting products
+class DenseBigMatrix : public BigMatrix
+{
+    const Matrix& M;
+    Vector diag;
+public:
+    mutable int nproduct;
+    DenseBigMatrix(const Matrix& M_) : M(M_), diag(M_.Nrows()), nproduct(0) 
+        { diag = 1; }
+    int Size() const { return M.Nrows(); }
+    VectorRef DiagRef() const { return diag; }
+    Vector operator*(const VectorRef& A) const 
+        { Vector res(Size()); product(A,res); return res; }
+    void product(const VectorRef& A, VectorRef& B) const 
+        { ++nproduct; B = M*A; }
+};
+
 BOOST_FIXTURE_TEST_SUITE(MatrixTest,MatrixDefaults)
 
 BOOST_AUTO_TEST_CASE(EigenValues)
@@ -17,6 +36,325 @@ BOOST_AUTO_TEST_CASE(EigenValues)
 
 }
 
+BOOST_AUTO_TEST_CASE(StoragePool)
+{
+    StoreLink::ReleasePool();
+    int objs = StoreLink::NumObjects();
+    int tot = StoreLink::TotalStorage();
 
-BOOST_AUTO_TEST_SUITE_END()
+    //A freed block is handed out again for a request of the same size class
+    Real* first = 0;
+    {
+    Vector V(1000);
+    first = V.Store();
+    }
+    CHECK_EQUAL(StoreLink::NumObjects(),objs);
+    CHECK_EQUAL(StoreLink::TotalStorage(),tot);
+    CHECK(StoreLink::PoolCached() > 0);
+    long hits = StoreLink::PoolHits();
+    {
+    Vector V(960);
+    CHECK(V.Store() == first);
+    CHECK_EQUAL(StoreLink::PoolHits(),hits+1);
+    CHECK_EQUAL(StoreLink::TotalStorage(),tot+960);
 
+    //Resizing within the class keeps the block
+    V.ReDimension(1020);
+    CHECK(V.Store() == first);
+    CHECK_EQUAL(StoreLink::TotalStorage(),tot+1020);
+    V = 1;
+    CHECK_CLOSE(V.sumels(),1020,1E-10);
+    }
+
+    //Blocks above the largest class are not cached
+    long cached = StoreLink::PoolCached();
+    {
+    Vector V(2000000);
+    }
+    CHECK_EQUAL(StoreLink::PoolCached(),cached);
+
+    //Nothing is cached with the limit set to zero
+    int limit = StoreLink::PoolLimit();
+    StoreLink::ReleasePool();
+    StoreLink::PoolLimit() = 0;
+    {
+    Vector V(1000);
+    }
+    CHECK_EQUAL(StoreLink::PoolCached(),0);
+    StoreLink::PoolLimit() = limit;
+    CHECK_EQUAL(StoreLink::NumObjects(),objs);
+    CHECK_EQUAL(StoreLink::TotalStorage(),tot);
+}
+
+BOOST_AUTO_TEST_CASE(InternalGemm)
+{
+    //Small (unpacked) and packed paths, partial tiles, skinny
+    //products (fewer rows or columns than a tile), A read in 
+    //place (few columns of B) and both transposes, with the 
+    //kernel in use and with each one the CPU has
+    const int shapes[][3] = { {1,1,1}, {5,3,7}, {37,29,41}, {130,9,70}, 
+                              {200,150,300}, {53,260,600}, {400,5,300}, 
+                              {3,350,200} };
+    const char* kernels[] = { 0, "generic", "avx2", "avx512" };
+    const Real alpha = 0.7;
+    for(int kn = 0; kn < 4; ++kn)
+    for(int s = 0; s < 8; ++s)
+    for(int t = 0; t < 4; ++t)
+    for(int bet = 0; bet < 2; ++bet)
+        {
+        const int m = shapes[s][0], n = shapes[s][1], k = shapes[s][2];
+        const bool ta = (t & 1), tb = (t & 2);
+        const Real beta = (bet == 0 ? 0 : -1.3);
+        Matrix A(ta ? m : k, ta ? k : m), B(tb ? k : n, tb ? n : k), C(n,m);
+        A.Randomize(); B.Randomize(); C.Randomize();
+        //Matrix is row-major, so M(r,c) is element (c,r) 
+        //of a column-major array with leading dimension Ncols
+        Matrix R(C);
+        R *= beta;
+        for(int j = 1; j <= n; ++j)
+        for(int i = 1; i <= m; ++i)
+            {
+            Real x = 0;
+            for(int p = 1; p <= k; ++p)
+                x += (ta ? A(i,p) : A(p,i)) * (tb ? B(p,j) : B(j,p));
+            R(j,i) += alpha*x;
+            }
+        if(kernels[kn] == 0)
+            internal_dgemm(ta ? 'T' : 'N',tb ? 'T' : 'N',m,n,k,alpha,
+                           A.Store(),A.Ncols(),B.Store(),B.Ncols(),beta,C.Store(),m);
+        else if(!internal_dgemm(kernels[kn],ta ? 'T' : 'N',tb ? 'T' : 'N',m,n,k,alpha,
+                                A.Store(),A.Ncols(),B.Store(),B.Ncols(),beta,C.Store(),m))
+            continue;
+        C -= R;
+        CHECK(Norm(C.TreatAsVector()) < 1E-12*Norm(R.TreatAsVector()));
+        }
+
+    //beta = 0 must not read C
+    Matrix A(2,3), B(3,2), C(2,2);
+    A.Randomize(); B.Randomize();
+    C = 0; C(1,1) = sqrt(-1.);
+    internal_dgemm('N','N',2,2,3,1,A.Store(),2,B.Store(),3,0,C.Store(),2);
+    CHECK(C(1,1) == C(1,1));
+}
+
+BOOST_AUTO_TEST_CASE(EigenValuesBatched)
+{
+    //Closed forms (1 x 1, 2 x 2), Jacobi and dsyevd sizes,
+    //and blocks which are diagonal, zero or degenerate
+    std::vector<Matrix> A;
+    for(int n = 1; n <= 14; ++n)
+        {
+        Matrix S(n,n); 
+        S.Randomize();
+        A.push_back(S + S.t());
+        }
+    Matrix D3(3,3); D3 = 0; D3(1,1) = 2; D3(2,2) = -1; D3(3,3) = 2;
+    A.push_back(D3);
+    Matrix Z2(2,2); Z2 = 0;
+    A.push_back(Z2);
+    Matrix P4(4,4); P4.TreatAsVector() = 1;  //eigenvalues 0,0,0,4
+    A.push_back(P4);
+    Matrix S2(2,2); S2 = 3; S2(1,2) = S2(2,1) = 1E-9;
+    A.push_back(S2);
+
+    std::vector<Vector> D;
+    std::vector<Matrix> Z;
+    ::EigenValuesBatched(A,D,Z);
+    CHECK_EQUAL(D.size(),A.size());
+    for(size_t b = 0; b < A.size(); ++b)
+        {
+        const int n = A[b].Nrows();
+        CHECK_EQUAL(D[b].Length(),n);
+        CHECK_EQUAL(Z[b].Nrows(),n);
+        CHECK_EQUAL(Z[b].Ncols(),n);
+        for(int i = 1; i < n; ++i) CHECK(D[b](i) <= D[b](i+1));
+        Matrix R = A[b]*Z[b];
+        for(int c = 1; c <= n; ++c) R.Column(c) -= D[b](c)*Z[b].Column(c);
+        CHECK(Norm(R.TreatAsVector()) < 1E-12);
+        Matrix I = Z[b].t()*Z[b];
+        I -= 1;
+        CHECK(Norm(I.TreatAsVector()) < 1E-12);
+
+        Vector d; Matrix U;
+        ::EigenValues(A[b],d,U);
+        d -= D[b];
+        CHECK(Norm(d) < 1E-12);
+        }
+    CHECK_CLOSE(D[16](4),4,1E-10);
+    CHECK_CLOSE(D[17](1),3-1E-9,1E-10);
+}
+
+BOOST_AUTO_TEST_CASE(Backends)
+{
+    const int n = 12, m = 9;
+    Matrix S(n,n), A(n,m);
+    S.Randomize(); A.Randomize();
+    Matrix Ssym = S + S.t();
+
+    //Every implementation of each operation; the 3 x 3
+    //case takes the internal solver through its short rows
+    const char* eig[] = { "internal", "dsyevd", "dsyevr" };
+    const int esize[] = { 3, n };
+    for(int e = 0; e < 2; ++e)
+        {
+        const int ne = esize[e];
+        Matrix Se = Ssym.SubMatrix(1,ne,1,ne);
+        Vector d0;
+        for(int j = 0; j < 3; ++j)
+            {
+            CHECK(setBackend(EigOp,eig[j]));
+            CHECK_EQUAL(std::string(backendFor(EigOp,ne)),eig[j]);
+            Vector d; Matrix Z;
+            ::EigenValues(Se,d,Z);
+            for(int i = 1; i < ne; ++i) CHECK(d(i) <= d(i+1));
+            Matrix R = Se*Z;
+            for(int c = 1; c <= ne; ++c) R.Column(c) -= d(c)*Z.Column(c);
+            CHECK(Norm(R.TreatAsVector()) < 1E-11);
+            if(j == 0) d0 = d;
+            d -= d0;
+            CHECK(Norm(d) < 1E-11);
+            }
+        }
+
+    const char* svd[] = { "internal", "dgesdd" };
+    for(int j = 0; j < 2; ++j)
+    for(int t = 0; t < 2; ++t)
+        {
+        CHECK(setBackend(SVDOp,svd[j]));
+        Matrix M = (t == 0 ? Matrix(A) : Matrix(A.t()));
+        Matrix U, V; Vector d;
+        newSVD(M,U,d,V);
+        CHECK_EQUAL(d.Length(),m);
+        for(int i = 1; i < m; ++i) CHECK(d(i) >= d(i+1));
+        for(int c = 1; c <= m; ++c) U.Column(c) *= d(c);
+        Matrix R = U*V;
+        R -= M;
+        CHECK(Norm(R.TreatAsVector()) < 1E-11);
+        }
+
+    const char* qr[] = { "internal", "dgeqrf" };
+    Matrix R0;
+    for(int j = 0; j < 2; ++j)
+    for(int t = 0; t < 2; ++t)
+        {
+        CHECK(setBackend(QROp,qr[j]));
+        Matrix M = (t == 0 ? Matrix(A) : Matrix(A.t()));
+        Matrix Q, R;
+        QR(M,Q,R);
+        CHECK_EQUAL(Q.Ncols(),m);
+        CHECK_EQUAL(R.Nrows(),m);
+        for(int r = 2; r <= R.Nrows(); ++r)
+        for(int c = 1; c < r; ++c)
+            CHECK_EQUAL(R(r,c),0);
+        Matrix I = Q.t()*Q;
+        I -= 1;
+        CHECK(Norm(I.TreatAsVector()) < 1E-12);
+        Matrix D = Q*R - M;
+        CHECK(Norm(D.TreatAsVector()) < 1E-12);
+        //Same signs as LAPACK
+        if(t == 0)
+            {
+            if(j == 0) R0 = R;
+            R -= R0;
+            CHECK(Norm(R.TreatAsVector()) < 1E-12);
+            }
+        }
+
+    //Products switch at a given size
+    CHECK(setBackend(GemmOp,"internal"));
+    CHECK(setBackend(GemmOp,"dgemm",10));
+    CHECK_EQUAL(std::string(backendFor(GemmOp,9)),"internal");
+    CHECK_EQUAL(std::string(backendFor(GemmOp,10)),"dgemm");
+    Matrix P = A*A.t(), P1(n,n);
+    P1 = 0;
+    for(int r = 1; r <= n; ++r)
+    for(int c = 1; c <= n; ++c)
+    for(int k = 1; k <= m; ++k)
+        P1(r,c) += A(r,k)*A(c,k);
+    P -= P1;
+    CHECK(Norm(P.TreatAsVector()) < 1E-12);
+    CHECK(!setBackend(GemmOp,"dsyevd"));
+
+    //Tables round-trip through a file
+    CHECK(writeBackends(".read_write/matrix_tune"));
+    resetBackends();
+    CHECK(readBackends(".read_write/matrix_tune"));
+    CHECK_EQUAL(std::string(backendFor(GemmOp,9)),"internal");
+    CHECK_EQUAL(std::string(backendFor(GemmOp,100)),"dgemm");
+    CHECK_EQUAL(std::string(backendFor(QROp,100)),"dgeqrf");
+
+    //Only the file named by MATRIX_TUNE_FILE is read
+    const std::string isolated = getenv("MATRIX_TUNE_FILE");
+    CHECK(setBackend(GemmOp,"dgemm"));
+    setenv("MATRIX_TUNE_FILE",".read_write/matrix_tune",1);
+    resetBackends();
+    CHECK_EQUAL(std::string(backendFor(GemmOp,9)),"internal");
+    setenv("MATRIX_TUNE_FILE",isolated.c_str(),1);
+
+    resetBackends();
+}
+
+BOOST_AUTO_TEST_CASE(ExpApply)
+{
+    const int n = 40;
+    Matrix S(n,n);
+    S.Randomize();
+    Matrix H = S + S.t();
+    Vector v(n), w(n);
+    v.Randomize(); w.Randomize();
+    DenseBigMatrix big(H);
+
+    //Imaginary time, in one step and (maxdim too small) in several
+    const Real taus[] = { 0.2, -0.2, 3 };
+    const int maxdims[] = { 30, 30, 12 };
+    for(int k = 0; k < 3; ++k)
+        {
+        Vector x = Exp(-taus[k]*H)*v;
+        Vector y = v;
+        big.nproduct = 0;
+        ::ExpApply(big,taus[k],y,1E-12,maxdims[k]);
+        y -= x;
+        CHECK(Norm(y) < 1E-10*Norm(x));
+        CHECK(big.nproduct <= maxdims[k] || k == 2);
+        CHECK(big.nproduct > maxdims[k] || k != 2);
+        }
+
+    //Real time against the eigenvectors of H
+    const Real tau = 1.5;
+    Vector d; Matrix U;
+    ::EigenValues(H,d,U);
+    Matrix C(n,n), Sn(n,n);
+    for(int i = 1; i <= n; ++i)
+        {
+        C.Column(i) = cos(tau*d(i))*U.Column(i);
+        Sn.Column(i) = sin(tau*d(i))*U.Column(i);
+        }
+    C = C*U.t(); Sn = Sn*U.t();
+    Vector xr = C*v + Sn*w, xi = C*w - Sn*v;
+    Vector yr = v, yi = w;
+    ::ExpApply(big,tau,yr,yi,1E-12,15);
+    CHECK_CLOSE(Norm(yr)*Norm(yr) + Norm(yi)*Norm(yi),v*v + w*w,1E-10);
+    yr -= xr; yi -= xi;
+    CHECK(Norm(yr) < 1E-10*Norm(v));
+    CHECK(Norm(yi) < 1E-10*Norm(v));
+
+    //A real start vector, and H with a small invariant subspace
+    yr = v; yi = 0;
+    ::ExpApply(big,tau,yr,yi);
+    yr -= C*v; yi += Sn*v;
+    CHECK(Norm(yr) + Norm(yi) < 1E-10*Norm(v));
+
+    Matrix P(n,n); P = 2;
+    DenseBigMatrix diag(P);
+    Vector z = v;
+    CHECK_EQUAL(::ExpApply(diag,0.5,z),0);
+    CHECK_EQUAL(diag.nproduct,1);
+    z -= exp(-1.0)*v;
+    CHECK(Norm(z) < 1E-12*Norm(v));
+
+    Vector zero(n); zero = 0;
+    CHECK_EQUAL(::ExpApply(big,0.5,zero),0);
+    CHECK_EQUAL(Norm(zero),0);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
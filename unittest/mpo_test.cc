@@ -1,5 +1,6 @@
 #include "test.h"
 #include "hams.h"
+#include "core.h"
 #include <boost/test/unit_test.hpp>
 
 using std::cout;
@@ -33,4 +34,499 @@ BOOST_AUTO_TEST_CASE(Position)
     CHECK_EQUAL(H.ortho_center(),1);
 }
 
+//Compares projOpDiag at bond b of psi with the diagonal
+//elements of explicit products on unit vectors
+template <class MPSType, class MPOType>
+void
+checkProjOpDiag(MPSType& psi, const MPOType& H, int b)
+    {
+    typedef typename MPSType::TensorT Tensor;
+    const int N = psi.NN();
+    psi.position(b);
+    std::vector<Tensor> PH(N+1);
+    for(int l = 1; l < b; ++l) 
+        psi.projectOp(l,Fromleft,PH[l],H.AA(l),PH[l+1]);
+    for(int l = N-1; l > b; --l) 
+        psi.projectOp(l+1,Fromright,PH[l+1],H.AA(l+1),PH[l]);
+
+    Tensor mpoh = H.bondTensor(b);
+    Tensor phi = psi.bondTensor(b);
+    putInQNs(phi,mpoh,PH[b],PH[b+1]);
+    LocalHam<Tensor,Tensor> lham(PH[b],PH[b+1],mpoh,phi);
+    lham.computeDiag();
+    Vector diag(lham.DiagRef());
+
+    const int n = lham.Size();
+    Vector x(n), y(n);
+    Real maxdiff = 0;
+    for(int j = 1; j <= n; ++j)
+        {
+        x = 0; x(j) = 1;
+        lham.product(x,y);
+        maxdiff = max(maxdiff,fabs(y(j)-diag(j)));
+        }
+    CHECK(maxdiff < 1E-10);
+    }
+
+BOOST_AUTO_TEST_CASE(ProjOpDiag)
+{
+    const int N = 10;
+    InitState initState(N);
+    for(int i = 1; i <= N; ++i) 
+        initState(i) = (i%2==1 ? s1model.Up(i) : s1model.Dn(i));
+    Sweeps sweeps(Sweeps::ramp_m,2,1,8,1E-8);
+    DMRGOpts opts;
+    opts.printEigs(false);
+
+    MPO H = SpinOne::Heisenberg(s1model)();
+    MPS psi(s1model,initState);
+    dmrg(psi,H,sweeps,opts);
+    checkProjOpDiag(psi,H,1);
+    checkProjOpDiag(psi,H,5);
+
+    IQMPO qH = SpinOne::Heisenberg(s1model)();
+    IQMPS qpsi(s1model,initState);
+    dmrg(qpsi,qH,sweeps,opts);
+    checkProjOpDiag(qpsi,qH,5);
+    checkProjOpDiag(qpsi,qH,N-1);
+}
+
+BOOST_AUTO_TEST_CASE(PreconditionedDMRG)
+{
+    const int N = 10;
+    InitState initState(N);
+    for(int i = 1; i <= N; ++i) 
+        initState(i) = (i%2==1 ? s1model.Up(i) : s1model.Dn(i));
+    Sweeps sweeps(Sweeps::ramp_m,4,1,20,1E-10);
+    IQMPO H = SpinOne::Heisenberg(s1model)();
+
+    DMRGOpts opts;
+    opts.printEigs(false);
+    IQMPS psi(s1model,initState);
+    Real E = dmrg(psi,H,sweeps,opts);
+
+    DMRGOpts popts;
+    popts.printEigs(false);
+    popts.precondition(true);
+    IQMPS ppsi(s1model,initState);
+    Real pE = dmrg(ppsi,H,sweeps,popts);
+
+    CHECK_CLOSE(pE,E,1E-4);
+    CHECK(opts.davidsonIters(1) > 0);
+    CHECK(popts.davidsonIters(1) > 0);
+    CHECK_EQUAL(popts.davidsonIters(sweeps.nsweep()+1),0);
+}
+
+BOOST_AUTO_TEST_CASE(TermThreads)
+{
+    const int N = 10, b = 5;
+    InitState initState(N);
+    for(int i = 1; i <= N; ++i) 
+        initState(i) = (i%2==1 ? s1model.Up(i) : s1model.Dn(i));
+    Sweeps sweeps(Sweeps::ramp_m,2,1,8,1E-8);
+    DMRGOpts opts;
+    opts.printEigs(false);
+
+    IQMPO H = SpinOne::Heisenberg(s1model)();
+    IQMPOSet HH(H,H,H);
+    IQMPS psi(s1model,initState);
+    Real E = dmrg(psi,HH,sweeps,opts);
+
+    psi.position(b);
+    std::vector<std::vector<IQTensor> > PH(N+1);
+    for(int l = 1; l < b; ++l) 
+        psi.projectOp(l,Fromleft,PH[l],HH.AA(l),PH[l+1]);
+    for(int l = N-1; l > b; --l) 
+        psi.projectOp(l+1,Fromright,PH[l+1],HH.AA(l+1),PH[l]);
+
+    std::vector<IQTensor> mpoh = HH.bondTensor(b);
+    IQTensor phi = psi.bondTensor(b);
+    IQTensor r1, r2, r3, r3b;
+    applyProjOp(phi,PH[b],PH[b+1],mpoh,r1);
+    applyProjOp(phi,PH[b],PH[b+1],mpoh,r2,2);
+    applyProjOp(phi,PH[b],PH[b+1],mpoh,r3,3);
+    applyProjOp(phi,PH[b],PH[b+1],mpoh,r3b,3);
+
+    const Real nrm = fabs(r1.norm());
+    CHECK_CLOSE(Dot(phi,r1)/Dot(phi,phi),E,1E-6);
+    IQTensor mr1(r1);
+    mr1 *= -1;
+    r2 += mr1;
+    CHECK(fabs(r2.norm()) < 1E-12*nrm);
+    r3 += mr1;
+    CHECK(fabs(r3.norm()) < 1E-12*nrm);
+    //A given number of accumulators always sums in the same order
+    r3b += mr1;
+    CHECK_EQUAL(r3b.norm(),r3.norm());
+
+    DMRGOpts topts;
+    topts.printEigs(false);
+    topts.termThreads(3);
+    IQMPS tpsi(s1model,initState);
+    CHECK_CLOSE(dmrg(tpsi,HH,sweeps,topts),E,1E-6);
+}
+
+//Decomposes bond b of psi with the density matrix and with
+//the SVD truncation of SVDWorker and compares the results
+template <class MPSType>
+void
+checkSVDModes(const MPSType& psi, int b, Direction dir, Real cutoff)
+{
+    typedef typename MPSType::TensorT Tensor;
+    const int N = psi.NN();
+    Tensor phi = psi.bondTensor(b);
+    Real nrm2 = sqr(phi.norm());
+
+    SVDWorker dsvd(N,cutoff,1,MAX_M,false,LogNumber(1)),
+              ssvd(N,cutoff,1,MAX_M,false,LogNumber(1));
+    ssvd.useSVD(true);
+    Tensor A1 = psi.AA(b), B1 = psi.AA(b+1), A2 = A1, B2 = B1;
+    dsvd(b,phi,A1,B1,dir);
+    ssvd(b,phi,A2,B2,dir);
+
+    const Vector& d = dsvd.eigsKept(b);
+    const Vector& s = ssvd.eigsKept(b);
+    CHECK_EQUAL(s.Length(),d.Length());
+    for(int j = 1; j <= min(s.Length(),d.Length()); ++j)
+        CHECK_CLOSE(s(j),d(j),1E-4);
+    CHECK(fabs(ssvd.truncerr(b)-dsvd.truncerr(b)) < 1E-12);
+
+    Tensor diff = A2*B2;
+    diff *= -1;
+    diff += phi;
+    CHECK(fabs(sqr(diff.norm())/nrm2 - ssvd.truncerr(b)) < 1E-12);
+}
+
+//The SVD path must keep the scale of a tensor a LogNumber:
+//phi with a scale outside the range of a double, or close
+//to its smallest, decomposes into tensors giving it back
+template <class MPSType>
+void
+checkSVDScale(const MPSType& psi, int b, Direction dir)
+{
+    typedef typename MPSType::TensorT Tensor;
+    const int N = psi.NN();
+    const Tensor phi = psi.bondTensor(b);
+    //About 1E+651, and 1E-304 (a smaller scale counts as zero)
+    const Real lognums[] = { 1500, -700 };
+    for(int l = 0; l < 2; ++l)
+        {
+        Tensor sphi = phi;
+        sphi *= LogNumber(lognums[l],1);
+        SVDWorker svd(N,1E-10,1,MAX_M,true,LogNumber(1));
+        svd.useSVD(true);
+        Tensor A = psi.AA(b), B = psi.AA(b+1);
+        svd(b,sphi,A,B,dir);
+
+        Tensor diff = A*B;
+        diff *= LogNumber(-lognums[l],1);
+        diff *= -1;
+        diff += phi;
+        CHECK(diff.norm() < 1E-4*phi.norm());
+        }
+}
+
+BOOST_AUTO_TEST_CASE(SVDTruncation)
+{
+    InitState initState(N);
+    for(int i = 1; i <= N; ++i) 
+        initState(i) = (i%2==1 ? s1model.Up(i) : s1model.Dn(i));
+    Sweeps sweeps(Sweeps::ramp_m,3,1,20,1E-10);
+    DMRGOpts opts;
+    opts.printEigs(false);
+
+    MPO H = SpinOne::Heisenberg(s1model)();
+    MPS psi(s1model,initState);
+    Real E = dmrg(psi,H,sweeps,opts);
+
+    IQMPO qH = SpinOne::Heisenberg(s1model)();
+    IQMPS qpsi(s1model,initState);
+    Real qE = dmrg(qpsi,qH,sweeps,opts);
+
+    psi.position(5);
+    qpsi.position(5);
+    for(Real cut = 1E-4; cut > 1E-9; cut *= 1E-2)
+        {
+        checkSVDModes(psi,5,Fromleft,cut);
+        checkSVDModes(psi,5,Fromright,cut);
+        checkSVDModes(qpsi,5,Fromleft,cut);
+        checkSVDModes(qpsi,5,Fromright,cut);
+        }
+    checkSVDScale(psi,5,Fromleft);
+    checkSVDScale(psi,5,Fromright);
+    checkSVDScale(qpsi,5,Fromleft);
+    checkSVDScale(qpsi,5,Fromright);
+
+    MPS spsi(s1model,initState);
+    spsi.useSVD(true);
+    CHECK_CLOSE(dmrg(spsi,H,sweeps,opts),E,1E-6);
+    IQMPS sqpsi(s1model,initState);
+    sqpsi.useSVD(true);
+    CHECK_CLOSE(dmrg(sqpsi,qH,sweeps,opts),qE,1E-6);
+}
+
+//Normalized random wavefunction phi(a,e) with two quantum 
+//number blocks of 40x50 and singular values decaying at rate
+IQTensor
+decayingBlocks(IQIndex& a, Real rate = 0.4)
+{
+    Index ap("a+",40), am("a-",40), ep("e+",50), em("e-",50);
+    a = IQIndex("a",ap,QN(+1),am,QN(-1),Out);
+    IQIndex e("e",em,QN(-1),ep,QN(+1),Out);
+    IQTensor phi(a,e);
+    for(int q = 0; q < 2; ++q)
+        {
+        const Index &ai = (q == 0 ? ap : am), &ei = (q == 0 ? em : ep);
+        ITensor T(ai,ei);
+        T.Randomize();
+        for(int i = 1; i <= ai.m(); ++i)
+        for(int j = 1; j <= ei.m(); ++j)
+            T(ai(i),ei(j)) *= exp(-rate*j-q);
+        phi += T;
+        }
+    phi *= 1.0/fabs(phi.norm());
+    return phi;
+}
+
+template <class MPSType>
+void
+checkPartialDiag(const MPSType& psi, int b, Direction dir, int maxm)
+{
+    typedef typename MPSType::TensorT Tensor;
+    const int N = psi.NN();
+    Tensor phi = psi.bondTensor(b);
+
+    SVDWorker fsvd(N,1E-14,1,maxm,false,LogNumber(1)),
+              psvd(N,1E-14,1,maxm,false,LogNumber(1));
+    psvd.partialDiag(true);
+    Tensor A1 = psi.AA(b), B1 = psi.AA(b+1), A2 = A1, B2 = B1;
+    fsvd(b,phi,A1,B1,dir);
+    psvd(b,phi,A2,B2,dir);
+
+    const Vector& f = fsvd.eigsKept(b);
+    const Vector& p = psvd.eigsKept(b);
+    CHECK_EQUAL(p.Length(),f.Length());
+    for(int j = 1; j <= min(p.Length(),f.Length()); ++j)
+        CHECK_CLOSE(p(j),f(j),1E-4);
+    CHECK(fabs(psvd.truncerr(b)-fsvd.truncerr(b)) < 1E-10);
+
+    Tensor diff = A2*B2;
+    diff *= -1;
+    diff += phi;
+    CHECK(fabs(sqr(diff.norm()/phi.norm()) - psvd.truncerr(b)) < 1E-10);
+}
+
+BOOST_AUTO_TEST_CASE(PartialDiag)
+{
+    InitState initState(N);
+    for(int i = 1; i <= N; ++i) 
+        initState(i) = (i%2==1 ? s1model.Up(i) : s1model.Dn(i));
+    Sweeps sweeps(Sweeps::ramp_m,3,1,30,1E-10);
+    DMRGOpts opts;
+    opts.printEigs(false);
+
+    MPO H = SpinOne::Heisenberg(s1model)();
+    MPS psi(s1model,initState);
+    dmrg(psi,H,sweeps,opts);
+
+    IQMPO qH = SpinOne::Heisenberg(s1model)();
+    IQMPS qpsi(s1model,initState);
+    dmrg(qpsi,qH,sweeps,opts);
+
+    psi.position(5);
+    qpsi.position(5);
+    for(int maxm = 2; maxm <= 4; maxm += 2)
+        {
+        checkPartialDiag(psi,5,Fromleft,maxm);
+        checkPartialDiag(psi,5,Fromright,maxm);
+        checkPartialDiag(qpsi,5,Fromleft,maxm);
+        checkPartialDiag(qpsi,5,Fromright,maxm);
+        }
+
+    //Quantum number blocks large enough for partial diagonalization
+    IQIndex a;
+    IQTensor phi = decayingBlocks(a);
+    IQTensor rho = phi * conj(primeind(phi,a));
+    for(int maxm = 2; maxm <= 8; maxm *= 2)
+        {
+        SVDWorker fsvd(N,1E-14,1,maxm,false,LogNumber(1)),
+                  psvd(N,1E-14,1,maxm,false,LogNumber(1));
+        psvd.partialDiag(true);
+        Vector fD, pD;
+        IQTensor fU, pU;
+        Real ferr = fsvd.diag_denmat(rho,fD,fU);
+        Real perr = psvd.diag_denmat(rho,pD,pU);
+        CHECK_EQUAL(pD.Length(),fD.Length());
+        for(int j = 1; j <= min(pD.Length(),fD.Length()); ++j)
+            CHECK_CLOSE(pD(j),fD(j),1E-4);
+        CHECK(fabs(perr-ferr) < 1E-10);
+
+        IQTensor diff = pU * (conj(pU) * phi);
+        diff *= -1;
+        diff += phi;
+        CHECK(fabs(sqr(diff.norm()) - perr) < 1E-10);
+        }
+
+    //Slowly decaying blocks: the partial estimate misses states
+    //above the cutoff, so the blocks must be diagonalized fully
+    IQTensor flat = decayingBlocks(a,0.02);
+    IQTensor frho = flat * conj(primeind(flat,a));
+    SVDWorker fsvd(N,1E-8,1,4,false,LogNumber(1)),
+              psvd(N,1E-8,1,4,false,LogNumber(1));
+    psvd.partialDiag(true);
+    Vector fD, pD;
+    IQTensor fU, pU;
+    Real ferr = fsvd.diag_denmat(frho,fD,fU);
+    Real perr = psvd.diag_denmat(frho,pD,pU);
+    CHECK_EQUAL(pD.Length(),fD.Length());
+    for(int j = 1; j <= min(pD.Length(),fD.Length()); ++j)
+        CHECK_CLOSE(pD(j),fD(j),1E-8);
+    CHECK_CLOSE(perr,ferr,1E-8);
+
+    //Once m reaches 30 the middle bonds are diagonalized partially
+    MPS fpsi(s1model,initState);
+    Real E = dmrg(fpsi,H,sweeps,opts);
+    MPS ppsi(s1model,initState);
+    ppsi.partialDiag(true);
+    CHECK_CLOSE(dmrg(ppsi,H,sweeps,opts),E,1E-6);
+    IQMPS fqpsi(s1model,initState);
+    Real qE = dmrg(fqpsi,qH,sweeps,opts);
+    IQMPS pqpsi(s1model,initState);
+    pqpsi.partialDiag(true);
+    CHECK_CLOSE(dmrg(pqpsi,qH,sweeps,opts),qE,1E-6);
+}
+
+BOOST_AUTO_TEST_CASE(BlockDiagThreads)
+{
+    //Result must not depend on whether blocks are
+    //diagonalized in parallel
+    IQIndex a;
+    IQTensor phi = decayingBlocks(a);
+    IQTensor rho = phi * conj(primeind(phi,a));
+
+    const Real oldsize = Globals::minBlockTaskSize();
+    SVDWorker svd(N,1E-8,1,MAX_M,false,LogNumber(1));
+    Vector D1, D2;
+    IQTensor U1, U2;
+    Globals::minBlockTaskSize() = 1;
+    Real err1 = svd.diag_denmat(rho,D1,U1);
+    Globals::minBlockTaskSize() = 1E20;
+    Real err2 = svd.diag_denmat(rho,D2,U2);
+    Globals::minBlockTaskSize() = oldsize;
+
+    CHECK_EQUAL(err1,err2);
+    CHECK_EQUAL(D1.Length(),D2.Length());
+    for(int j = 1; j <= min(D1.Length(),D2.Length()); ++j)
+        CHECK_EQUAL(D1(j),D2(j));
+    //U1 and U2 have different new indices, compare projectors
+    IQTensor diff = U1 * conj(primeind(U1,a));
+    diff *= -1;
+    diff += U2 * conj(primeind(U2,a));
+    CHECK(fabs(diff.norm()) < 1E-12);
+}
+
+template <class MPSType>
+void
+checkOrthoExpect(MPSType psi)
+{
+    typedef typename MPSType::TensorT Tensor;
+    const int N = psi.NN();
+    const SpinOne::Model& model = dynamic_cast<const SpinOne::Model&>(psi.model());
+    psi *= 2;
+
+    for(int c = 1; c <= N; c += 4)
+        {
+        psi.position(c);
+        CHECK(psi.is_ortho());
+        Real nrm2 = psiphi(psi,psi);
+        CHECK_CLOSE(psi.norm(),sqrt(nrm2),1E-10);
+
+        for(int i = 1; i <= N; ++i)
+            {
+            //Reference: <psi|phi> with phi = Sz_i psi
+            MPSType phi(psi);
+            Tensor op = model.sz(i);
+            phi.AAnc(i) = psi.AA(i) * op;
+            phi.AAnc(i).mapprime(1,0,primeSite);
+            Real ref = psiphi(psi,phi)/nrm2;
+            CHECK(fabs(psi.expect(i,model.sz(i)) - ref) < 1E-10);
+            }
+        }
+
+    //Without an orthogonality center the whole chain is used
+    psi.position(5);
+    psi.AAnc(3) *= 1;
+    CHECK(!psi.is_ortho());
+    Real nrm2 = psiphi(psi,psi);
+    CHECK_CLOSE(psi.norm(),sqrt(nrm2),1E-10);
+    Real sz = 0;
+    for(int i = 1; i <= N; ++i) sz += psi.expect(i,model.sz(i));
+    CHECK(fabs(sz) < 1E-8);
+}
+
+template <class MPSType, class MPOType>
+void
+checkEnvCache(MPSType psi, const MPOType& H)
+{
+    const int N = psi.NN();
+    psi.position(1);
+    MPSType phi(psi);
+    phi.position(N);
+
+    EnvCache<MPSType,MPOType> E(psi,H,psi), O(psi,phi);
+    CHECK_CLOSE(E.value(),psiHphi(psi,H,psi),1E-10);
+    CHECK_EQUAL(E.nupdated(),2*N-2);
+    CHECK_CLOSE(O.value(),psiphi(psi,phi),1E-10);
+
+    //Nothing changed
+    CHECK_CLOSE(E.value(),psiHphi(psi,H,psi),1E-10);
+    CHECK_EQUAL(E.nupdated(),0);
+
+    //Moving the center by one bond changes two sites
+    for(int c = 2; c <= N; ++c)
+        {
+        psi.position(c);
+        CHECK_CLOSE(E.value(),psiHphi(psi,H,psi),1E-10);
+        CHECK(E.nupdated() <= 2);
+        CHECK_CLOSE(O.value(),psiphi(psi,phi),1E-10);
+        CHECK(O.nupdated() <= 2);
+        }
+
+    //And back again
+    for(int c = N-1; c >= 1; --c)
+        {
+        psi.position(c);
+        CHECK_CLOSE(E.value(),psiHphi(psi,H,psi),1E-10);
+        CHECK(E.nupdated() <= 2);
+        CHECK_CLOSE(O.value(),psiphi(psi,phi),1E-10);
+        CHECK(O.nupdated() <= 2);
+        }
+
+    //Changing an edge site of phi
+    phi.AAnc(1) *= -3;
+    CHECK_CLOSE(O.value(),psiphi(psi,phi),1E-10);
+}
+
+BOOST_AUTO_TEST_CASE(OrthoExpect)
+{
+    InitState initState(N);
+    for(int i = 1; i <= N; ++i) 
+        initState(i) = (i%2==1 ? s1model.Up(i) : s1model.Dn(i));
+    Sweeps sweeps(Sweeps::ramp_m,3,1,20,1E-10);
+    DMRGOpts opts;
+    opts.printEigs(false);
+
+    MPO H = SpinOne::Heisenberg(s1model)();
+    MPS psi(s1model,initState);
+    dmrg(psi,H,sweeps,opts);
+    checkOrthoExpect(psi);
+    checkEnvCache(psi,H);
+
+    IQMPO qH = SpinOne::Heisenberg(s1model)();
+    IQMPS qpsi(s1model,initState);
+    dmrg(qpsi,qH,sweeps,opts);
+    checkOrthoExpect(qpsi);
+    checkEnvCache(qpsi,qH);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
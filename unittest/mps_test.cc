@@ -45,5 +45,21 @@ BOOST_AUTO_TEST_CASE(QNCheck)
     CHECK_EQUAL(totalQN(psiFerro),QN(10));
 }
 
+BOOST_AUTO_TEST_CASE(Swap)
+{
+    IQMPS psiNeel(shmodel,shNeel), psiFerro(shmodel,shFerro);
+    const long rev = psiNeel.rev(3);
+
+    psiNeel.swap(psiFerro);
+    CHECK_EQUAL(totalQN(psiNeel),QN(10));
+    CHECK_EQUAL(totalQN(psiFerro),QN(0));
+    CHECK_EQUAL(psiFerro.rev(3),rev);
+
+    IQMPS psi = handover(psiFerro);
+    CHECK(psiFerro.is_null());
+    CHECK_EQUAL(psi.NN(),int(N));
+    CHECK_EQUAL(totalQN(psi),QN(0));
+}
+
 
 BOOST_AUTO_TEST_SUITE_END()
@@ -3,3 +3,11 @@
 
 #define BOOST_TEST_MODULE ITensor
 #include <boost/test/unit_test.hpp>
+
+//Results must not depend on a tuning file of the machine the
+//tests run on (see backend.h): name one that is never written
+struct IsolateTuneFile
+{
+    IsolateTuneFile() { setenv("MATRIX_TUNE_FILE",".read_write/no_matrix_tune",1); }
+};
+BOOST_GLOBAL_FIXTURE(IsolateTuneFile);
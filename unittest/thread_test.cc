@@ -0,0 +1,230 @@
+#include "test.h"
+#include "iqtensor.h"
+#include <pthread.h>
+#include <boost/test/unit_test.hpp>
+
+//
+// Several threads contract the same (shared) tensors
+// at once; every result must agree bit-for-bit with
+// the one computed serially.
+//
+
+static const int NThread = 4;
+static const int NRep = 5;
+
+struct ThreadDefaults
+    {
+    Index a,s,w,b,c,d,
+          s1u,s1d,l1u,l10,l1d,l2u,l20,l2d;
+    IQIndex S1,L1,L2;
+
+    ITensor L,R,R2,X,Y,Z;
+    IQTensor A,B;
+
+    ThreadDefaults() :
+    a(Index("a",64)), s(Index("s",8)), w(Index("w",8)), b(Index("b",128)),
+    c(Index("c",16)), d(Index("d",20)),
+    s1u(Index("Site1 Up",1,Site)), s1d(Index("Site1 Dn",1,Site)),
+    l1u(Index("Link1 Up",3,Link)), l10(Index("Link1 Z0",4,Link)),
+    l1d(Index("Link1 Dn",3,Link)),
+    l2u(Index("Link2 Up",2,Link)), l20(Index("Link2 Z0",5,Link)),
+    l2d(Index("Link2 Dn",2,Link))
+        {
+        //Batched product shape (see ITensorTest/BatchedProduct)
+        L = ITensor(a,s,w,b); R = ITensor(s,w,c); R2 = ITensor(c,s,w,d);
+        L.Randomize(); R.Randomize(); R2.Randomize();
+
+        //Small product and sum with permuted indices
+        X = ITensor(s,c,d); Y = ITensor(d,w,c); Z = ITensor(w,s);
+        X.Randomize(); Y.Randomize(); Z.Randomize();
+
+        S1 = IQIndex("S1",s1u,QN(+1),s1d,QN(-1),Out);
+        L1 = IQIndex("L1",l1u,QN(+1),l10,QN(0),l1d,QN(-1),Out);
+        L2 = IQIndex("L2",l2u,QN(+1),l20,QN(0),l2d,QN(-1),Out);
+
+        A = IQTensor(L1,S1,L2);
+        for(int n1 = 1; n1 <= L1.nindex(); ++n1)
+        for(int n2 = 1; n2 <= L2.nindex(); ++n2)
+        for(int p1 = 1; p1 <= S1.nindex(); ++p1)
+            {
+            ITensor T(L1.index(n1),S1.index(p1),L2.index(n2));
+            T.Randomize();
+            A += T;
+            }
+
+        B = IQTensor(L1,L2);
+        for(int n1 = 1; n1 <= L1.nindex(); ++n1)
+        for(int n2 = 1; n2 <= L2.nindex(); ++n2)
+            {
+            ITensor T(L1.index(n1),L2.index(n2));
+            T.Randomize();
+            B += T;
+            }
+        }
+
+    };
+
+//Each call works only on its own copies of the shared inputs
+static void
+contractAll(const ThreadDefaults& f, std::vector<ITensor>& res)
+    {
+    res.clear();
+    res.push_back(f.L * f.R);
+    res.push_back(f.L * f.R2);
+    res.push_back(f.X * f.Y);
+
+    ITensor sum = f.Z;
+    sum += f.X * f.Y;
+    sum *= -0.5;
+    sum += f.Z;
+    res.push_back(sum);
+
+    ITensor cx = f.X * ITensor::Complex_i();
+    cx += f.X;
+    ITensor cy = f.Y * ITensor::Complex_1();
+    cy += f.Y * ITensor::Complex_i() * 2;
+    cx *= cy;
+    res.push_back(cx);
+
+    IQTensor Bc = f.B;
+    Bc.conj();
+    res.push_back(ITensor(f.A * Bc));
+    res.push_back(ITensor(f.A / f.B));
+    }
+
+struct ThreadJob
+    {
+    const ThreadDefaults* f;
+    const std::vector<ITensor>* serial;
+    int nbad;
+    };
+
+static bool
+identical(const ITensor& t1, const ITensor& t2)
+    {
+    if(t1.r() != t2.r() || t1.vec_size() != t2.vec_size()) return false;
+    Vector v1(t1.vec_size()), v2(t2.vec_size());
+    t1.assignToVec(v1);
+    t2.assignToVec(v2);
+    for(int j = 1; j <= v1.Length(); ++j)
+        if(v1(j) != v2(j)) return false;
+    return true;
+    }
+
+static void*
+runJob(void* arg)
+    {
+    ThreadJob& job = *static_cast<ThreadJob*>(arg);
+    std::vector<ITensor> res;
+    for(int rep = 0; rep < NRep; ++rep)
+        {
+        contractAll(*job.f,res);
+        for(size_t n = 0; n < res.size(); ++n)
+            if(!identical(res[n],(*job.serial)[n])) ++job.nbad;
+        }
+    return 0;
+    }
+
+struct DotJob
+    {
+    const IQTensor* x;
+    const IQTensor* y;
+    Real serial;
+    pthread_barrier_t* start;
+    int nbad;
+    };
+
+static void*
+runDot(void* arg)
+    {
+    DotJob& job = *static_cast<DotJob*>(arg);
+    pthread_barrier_wait(job.start);
+    for(int rep = 0; rep < NRep; ++rep)
+        if(Dot(*job.x,*job.y) != job.serial) ++job.nbad;
+    return 0;
+    }
+
+BOOST_FIXTURE_TEST_SUITE(ThreadTest,ThreadDefaults)
+
+BOOST_AUTO_TEST_CASE(ConcurrentProducts)
+    {
+    std::vector<ITensor> serial;
+    contractAll(*this,serial);
+
+    ThreadJob job[NThread];
+    pthread_t th[NThread];
+    for(int t = 0; t < NThread; ++t)
+        {
+        job[t].f = this;
+        job[t].serial = &serial;
+        job[t].nbad = 0;
+        CHECK_EQUAL(pthread_create(&th[t],0,runJob,&job[t]),0);
+        }
+    for(int t = 0; t < NThread; ++t)
+        {
+        pthread_join(th[t],0);
+        CHECK_EQUAL(job[t].nbad,0);
+        }
+
+    //Inputs are unchanged and the serial results still reproduce
+    std::vector<ITensor> again;
+    contractAll(*this,again);
+    for(size_t n = 0; n < serial.size(); ++n)
+        CHECK(identical(again[n],serial[n]));
+    }
+
+BOOST_AUTO_TEST_CASE(ConcurrentBlockLookup)
+    {
+    //Many blocks, in the opposite order in X and Y, so that Dot
+    //looks each one up by its key
+    const int nsec = 20;
+    std::vector<Index> iu, iv;
+    std::vector<inqn> uq, vq;
+    for(int q = 0; q < nsec; ++q)
+        {
+        iu.push_back(Index(nameint("u",q),2,Link));
+        iv.push_back(Index(nameint("v",q),2,Link));
+        uq.push_back(inqn(iu.back(),QN()));
+        vq.push_back(inqn(iv.back(),QN()));
+        }
+    IQIndex U(IQIndex("U"),uq), V(IQIndex("V"),vq);
+    IQTensor X(U,V), Y(U,V);
+    for(int q1 = 0; q1 < nsec; ++q1)
+    for(int q2 = 0; q2 < nsec; ++q2)
+        {
+        ITensor T(iu[q1],iv[q2]), Tr(iu[nsec-1-q1],iv[nsec-1-q2]);
+        T.Randomize(); Tr.Randomize();
+        X += T;
+        Y += Tr;
+        }
+    const Real serial = Dot(X,Y);
+
+    for(int rep = 0; rep < 10*NRep; ++rep)
+        {
+        //clean leaves the block map to be made on first use,
+        //here by all threads at once
+        IQTensor Ys(Y);
+        Ys.clean(0);
+        DotJob job[NThread];
+        pthread_t th[NThread];
+        pthread_barrier_t start;
+        pthread_barrier_init(&start,0,NThread);
+        for(int t = 0; t < NThread; ++t)
+            {
+            job[t].x = &X;
+            job[t].y = &Ys;
+            job[t].serial = serial;
+            job[t].start = &start;
+            job[t].nbad = 0;
+            CHECK_EQUAL(pthread_create(&th[t],0,runDot,&job[t]),0);
+            }
+        for(int t = 0; t < NThread; ++t)
+            {
+            pthread_join(th[t],0);
+            CHECK_EQUAL(job[t].nbad,0);
+            }
+        pthread_barrier_destroy(&start);
+        }
+    }
+
+BOOST_AUTO_TEST_SUITE_END()